@@ -1868,6 +1868,36 @@ function Regression::TileList()
 		print("    " + i + " => " + list.GetValue(i));
 	}
 
+	print("  ValuateNative() same as Valuate():");
+	local native_valuators = [
+		["NV_TILE_IS_BUILDABLE",       AIList.NV_TILE_IS_BUILDABLE,       AITile.IsBuildable],
+		["NV_TILE_IS_WATER",           AIList.NV_TILE_IS_WATER,           AITile.IsWaterTile],
+		["NV_TILE_IS_SEA",             AIList.NV_TILE_IS_SEA,             AITile.IsSeaTile],
+		["NV_TILE_IS_COAST",           AIList.NV_TILE_IS_COAST,           AITile.IsCoastTile],
+		["NV_TILE_GET_SLOPE",          AIList.NV_TILE_GET_SLOPE,          AITile.GetSlope],
+		["NV_TILE_GET_MIN_HEIGHT",     AIList.NV_TILE_GET_MIN_HEIGHT,     AITile.GetMinHeight],
+		["NV_TILE_GET_MAX_HEIGHT",     AIList.NV_TILE_GET_MAX_HEIGHT,     AITile.GetMaxHeight],
+		["NV_TILE_GET_TERRAIN_TYPE",   AIList.NV_TILE_GET_TERRAIN_TYPE,   AITile.GetTerrainType],
+		["NV_TILE_DISTANCE_MANHATTAN", AIList.NV_TILE_DISTANCE_MANHATTAN, AITile.GetDistanceManhattanToTile],
+		["NV_TILE_DISTANCE_SQUARE",    AIList.NV_TILE_DISTANCE_SQUARE,    AITile.GetDistanceSquareToTile],
+	];
+	foreach (native_valuator in native_valuators) {
+		local native = AITileList();
+		native.AddList(list);
+		local result = native.ValuateNative(native_valuator[1], 30000);
+		if (native_valuator[1] >= AIList.NV_TILE_DISTANCE_MANHATTAN) {
+			list.Valuate(native_valuator[2], 30000);
+		} else {
+			list.Valuate(native_valuator[2]);
+		}
+		local same = native.Count() == list.Count();
+		foreach (idx, val in list) {
+			if (native.GetValue(idx) != val) same = false;
+		}
+		print("    " + native_valuator[0] + ": " + result + " " + same);
+	}
+	print("    invalid valuator:            " + list.ValuateNative(100, 30000) + " " + AIError.GetLastErrorString());
+
 	list = AITileList_IndustryAccepting(0, 3);
 	print("");
 	print("--TileList_IndustryAccepting--");
@@ -304,6 +304,7 @@ Sprite *Blitter_32bppOptimized::EncodeInternal(SpriteType sprite_type, const Spr
 	/* lengths of streams */
 	SpriteCollMap<uint32_t> lengths[2];
 
+	const SpriteLoadSettings &settings = GetSpriteLoadSettings();
 	ZoomLevel zoom_min;
 	ZoomLevel zoom_max;
 
@@ -311,8 +312,8 @@ Sprite *Blitter_32bppOptimized::EncodeInternal(SpriteType sprite_type, const Spr
 		zoom_min = ZoomLevel::Min;
 		zoom_max = ZoomLevel::Min;
 	} else {
-		zoom_min = _settings_client.gui.zoom_min;
-		zoom_max = _settings_client.gui.zoom_max;
+		zoom_min = settings.zoom_min;
+		zoom_max = settings.zoom_max;
 		if (zoom_max == zoom_min) zoom_max = ZoomLevel::Max;
 	}
 
@@ -367,7 +368,7 @@ Sprite *Blitter_32bppOptimized::EncodeInternal(SpriteType sprite_type, const Spr
 
 						if (Tpal_to_rgb) {
 							/* Pre-convert the mapping channel to a RGB value */
-							Colour colour = AdjustBrightness(this->LookupColourInPalette(src->m), rgb_max);
+							Colour colour = AdjustBrightness(settings.palette->palette[src->m], rgb_max);
 							dst_px->r = colour.r;
 							dst_px->g = colour.g;
 							dst_px->b = colour.b;
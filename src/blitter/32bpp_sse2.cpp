@@ -26,11 +26,12 @@ Sprite *Blitter_32bppSSE_Base::Encode(SpriteType sprite_type, const SpriteLoader
 	 * Second uint32_t of a line = the number of transparent pixels from the right.
 	 * Then all RGBA then all MV.
 	 */
+	const SpriteLoadSettings &settings = GetSpriteLoadSettings();
 	ZoomLevel zoom_min = ZoomLevel::Min;
 	ZoomLevel zoom_max = ZoomLevel::Min;
 	if (sprite_type != SpriteType::Font) {
-		zoom_min = _settings_client.gui.zoom_min;
-		zoom_max = _settings_client.gui.zoom_max;
+		zoom_min = settings.zoom_min;
+		zoom_max = settings.zoom_max;
 		if (zoom_max == zoom_min) zoom_max = ZoomLevel::Max;
 	}
 
@@ -86,7 +87,7 @@ Sprite *Blitter_32bppSSE_Base::Encode(SpriteType sprite_type, const SpriteLoader
 						dst_mv->v = (rgb_max == 0) ? DEFAULT_BRIGHTNESS : rgb_max;
 
 						/* Pre-convert the mapping channel to a RGB value. */
-						const Colour colour = AdjustBrightneSSE(Blitter_32bppBase::LookupColourInPalette(src->m), dst_mv->v);
+						const Colour colour = AdjustBrightneSSE(settings.palette->palette[src->m], dst_mv->v);
 						dst_rgba->r = colour.r;
 						dst_rgba->g = colour.g;
 						dst_rgba->b = colour.b;
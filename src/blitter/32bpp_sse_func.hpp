@@ -119,6 +119,54 @@ INTERNAL_LINKAGE inline __m128i DarkenTwoPixels(__m128i src, __m128i dst, const
 	return _mm_packus_epi16(dstAB, dstAB);
 }
 
+#if (SSE_VERSION >= 5)
+/**
+ * Alpha blend the 16 bit expanded channels of four pixels.
+ * @return The blended channels, of which only the low bytes are meaningful.
+ */
+GNU_TARGET(SSE_TARGET)
+INTERNAL_LINKAGE inline __m256i AlphaBlendExpanded(__m256i srcAB, __m256i dstAB, const __m256i &distribution_mask, const __m256i &alpha_mask)
+{
+	__m256i alphaMaskAB = _mm256_cmpgt_epi16(srcAB, _mm256_setzero_si256());
+	__m256i alphaAB = _mm256_sub_epi16(srcAB, alphaMaskAB);
+	alphaAB = _mm256_shuffle_epi8(alphaAB, distribution_mask);
+
+	srcAB = _mm256_sub_epi16(srcAB, dstAB);
+	srcAB = _mm256_mullo_epi16(srcAB, alphaAB);
+	srcAB = _mm256_srli_epi16(srcAB, 8);
+	srcAB = _mm256_add_epi16(srcAB, dstAB);
+
+	alphaMaskAB = _mm256_and_si256(alphaMaskAB, alpha_mask);
+	return _mm256_or_si256(srcAB, alphaMaskAB);
+}
+
+/**
+ * Alpha blend 8 pixels; the same as calling AlphaBlendTwoPixels() four times.
+ * Unpacking works per 128 bit lane, so the low unpack holds pixels 0, 1, 4 and 5 and the high unpack pixels 2, 3, 6 and 7.
+ * Packing them again per lane restores the original order.
+ */
+GNU_TARGET(SSE_TARGET)
+INTERNAL_LINKAGE inline __m256i AlphaBlendEightPixels(__m256i src, __m256i dst, const __m256i &distribution_mask, const __m256i &alpha_mask, const __m256i &low_byte_mask)
+{
+	__m256i lo = AlphaBlendExpanded(_mm256_unpacklo_epi8(src, _mm256_setzero_si256()), _mm256_unpacklo_epi8(dst, _mm256_setzero_si256()), distribution_mask, alpha_mask);
+	__m256i hi = AlphaBlendExpanded(_mm256_unpackhi_epi8(src, _mm256_setzero_si256()), _mm256_unpackhi_epi8(dst, _mm256_setzero_si256()), distribution_mask, alpha_mask);
+
+	/* The high bytes may contain garbage from the unsigned shift, wipe them so packing does not saturate. */
+	return _mm256_packus_epi16(_mm256_and_si256(lo, low_byte_mask), _mm256_and_si256(hi, low_byte_mask));
+}
+
+/** Darken 8 pixels; the same as calling DarkenTwoPixels() four times. */
+GNU_TARGET(SSE_TARGET)
+INTERNAL_LINKAGE inline __m256i DarkenEightPixels(__m256i src, __m256i dst, const __m256i &distribution_mask, const __m256i &tr_nom_base)
+{
+	__m256i alphaLo = _mm256_srli_epi16(_mm256_shuffle_epi8(_mm256_unpacklo_epi8(src, _mm256_setzero_si256()), distribution_mask), 2);
+	__m256i alphaHi = _mm256_srli_epi16(_mm256_shuffle_epi8(_mm256_unpackhi_epi8(src, _mm256_setzero_si256()), distribution_mask), 2);
+	__m256i dstLo = _mm256_mullo_epi16(_mm256_unpacklo_epi8(dst, _mm256_setzero_si256()), _mm256_sub_epi16(tr_nom_base, alphaLo));
+	__m256i dstHi = _mm256_mullo_epi16(_mm256_unpackhi_epi8(dst, _mm256_setzero_si256()), _mm256_sub_epi16(tr_nom_base, alphaHi));
+	return _mm256_packus_epi16(_mm256_srli_epi16(dstLo, 8), _mm256_srli_epi16(dstHi, 8));
+}
+#endif
+
 GNU_TARGET(SSE_TARGET)
 INTERNAL_LINKAGE Colour ReallyAdjustBrightness(Colour colour, uint8_t brightness)
 {
@@ -219,6 +267,8 @@ inline void Blitter_32bppSSE2::Draw(const Blitter::BlitterParams *bp, ZoomLevel
 inline void Blitter_32bppSSSE3::Draw(const Blitter::BlitterParams *bp, ZoomLevel zoom)
 #elif (SSE_VERSION == 4)
 inline void Blitter_32bppSSE4::Draw(const Blitter::BlitterParams *bp, ZoomLevel zoom)
+#elif (SSE_VERSION == 5)
+inline void Blitter_32bppAVX2::Draw(const Blitter::BlitterParams *bp, ZoomLevel zoom)
 #endif
 {
 	const uint8_t * const remap = bp->remap;
@@ -255,6 +305,12 @@ inline void Blitter_32bppSSE4::Draw(const Blitter::BlitterParams *bp, ZoomLevel
 	#define DARKEN_PARAM_2      tr_nom_base
 #endif
 	const __m128i tr_nom_base = TRANSPARENT_NOM_BASE;
+#if (SSE_VERSION >= 5)
+	const __m256i a_cm_x2        = _mm256_broadcastsi128_si256(a_cm);
+	const __m256i alpha_and_x2   = _mm256_broadcastsi128_si256(alpha_and);
+	const __m256i tr_nom_base_x2 = _mm256_broadcastsi128_si256(tr_nom_base);
+	const __m256i low_byte_x2    = _mm256_set1_epi16(0x00FF);
+#endif
 
 	for (int y = bp->height; y != 0; y--) {
 		Colour *dst = dst_line;
@@ -285,7 +341,19 @@ inline void Blitter_32bppSSE4::Draw(const Blitter::BlitterParams *bp, ZoomLevel
 					break;
 				}
 
+#if (SSE_VERSION >= 5)
+				for (uint x = (uint) effective_width / 8; x > 0; x--) {
+					__m256i srcABCD = _mm256_loadu_si256((const __m256i*) src);
+					__m256i dstABCD = _mm256_loadu_si256((__m256i*) dst);
+					_mm256_storeu_si256((__m256i*) dst, AlphaBlendEightPixels(srcABCD, dstABCD, a_cm_x2, alpha_and_x2, low_byte_x2));
+					src += 8;
+					dst += 8;
+				}
+
+				for (uint x = ((uint) effective_width % 8) / 2; x > 0; x--) {
+#else
 				for (uint x = (uint) effective_width / 2; x > 0; x--) {
+#endif
 					__m128i srcABCD = _mm_loadl_epi64((const __m128i*) src);
 					__m128i dstABCD = _mm_loadl_epi64((__m128i*) dst);
 					_mm_storel_epi64((__m128i*) dst, AlphaBlendTwoPixels(srcABCD, dstABCD, ALPHA_BLEND_PARAM_1, ALPHA_BLEND_PARAM_2, ALPHA_BLEND_PARAM_3));
@@ -384,7 +452,19 @@ bmcr_alpha_blend_single:
 
 			case BlitterMode::Transparent:
 				/* Make the current colour a bit more black, so it looks like this image is transparent. */
+#if (SSE_VERSION >= 5)
+				for (uint x = (uint) bp->width / 8; x > 0; x--) {
+					__m256i srcABCD = _mm256_loadu_si256((const __m256i*) src);
+					__m256i dstABCD = _mm256_loadu_si256((__m256i*) dst);
+					_mm256_storeu_si256((__m256i *) dst, DarkenEightPixels(srcABCD, dstABCD, a_cm_x2, tr_nom_base_x2));
+					src += 8;
+					dst += 8;
+				}
+
+				for (uint x = ((uint) bp->width % 8) / 2; x > 0; x--) {
+#else
 				for (uint x = (uint) bp->width / 2; x > 0; x--) {
+#endif
 					__m128i srcABCD = _mm_loadl_epi64((const __m128i*) src);
 					__m128i dstABCD = _mm_loadl_epi64((__m128i*) dst);
 					_mm_storel_epi64((__m128i *) dst, DarkenTwoPixels(srcABCD, dstABCD, DARKEN_PARAM_1, DARKEN_PARAM_2));
@@ -460,6 +540,8 @@ void Blitter_32bppSSE2::Draw(Blitter::BlitterParams *bp, BlitterMode mode, ZoomL
 void Blitter_32bppSSSE3::Draw(Blitter::BlitterParams *bp, BlitterMode mode, ZoomLevel zoom)
 #elif (SSE_VERSION == 4)
 void Blitter_32bppSSE4::Draw(Blitter::BlitterParams *bp, BlitterMode mode, ZoomLevel zoom)
+#elif (SSE_VERSION == 5)
+void Blitter_32bppAVX2::Draw(Blitter::BlitterParams *bp, BlitterMode mode, ZoomLevel zoom)
 #endif
 {
 	switch (mode) {
@@ -123,6 +123,7 @@ Sprite *Blitter_8bppOptimized::Encode(SpriteType sprite_type, const SpriteLoader
 	/* Make memory for all zoom-levels */
 	uint memory = sizeof(SpriteData);
 
+	const SpriteLoadSettings &settings = GetSpriteLoadSettings();
 	ZoomLevel zoom_min;
 	ZoomLevel zoom_max;
 
@@ -130,8 +131,8 @@ Sprite *Blitter_8bppOptimized::Encode(SpriteType sprite_type, const SpriteLoader
 		zoom_min = ZoomLevel::Min;
 		zoom_max = ZoomLevel::Min;
 	} else {
-		zoom_min = _settings_client.gui.zoom_min;
-		zoom_max = _settings_client.gui.zoom_max;
+		zoom_min = settings.zoom_min;
+		zoom_max = settings.zoom_max;
 		if (zoom_max == zoom_min) zoom_max = ZoomLevel::Max;
 	}
 
@@ -145,7 +146,7 @@ Sprite *Blitter_8bppOptimized::Encode(SpriteType sprite_type, const SpriteLoader
 	/* Don't allocate memory each time, but just keep some
 	 * memory around as this function is called quite often
 	 * and the memory usage is quite low. */
-	static ReusableBuffer<uint8_t> temp_buffer;
+	static thread_local ReusableBuffer<uint8_t> temp_buffer;
 	SpriteData *temp_dst = reinterpret_cast<SpriteData *>(temp_buffer.ZeroAllocate(memory));
 	uint8_t *dst = temp_dst->data;
 
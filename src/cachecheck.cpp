@@ -197,6 +197,17 @@ void CheckCaches()
 		}
 	}
 
+	/* Check the cached acceptance of the catchment areas, without filling or replacing the caches. */
+	for (const Station *st : Station::Iterate()) {
+		const StationAcceptanceCache &cache = st->acceptance_cache;
+		if (!cache.valid) continue;
+
+		StationAcceptanceCache fresh = st->ComputeAcceptanceCache();
+		if (fresh.acceptance != cache.acceptance || fresh.dynamic_tiles != cache.dynamic_tiles) {
+			Debug(desync, 2, "warning: station acceptance mismatch: station {}", st->index);
+		}
+	}
+
 	Station::RecomputeCatchmentForAll();
 
 	/* Check industries_near */
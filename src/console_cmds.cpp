@@ -45,6 +45,7 @@
 #include "3rdparty/fmt/chrono.h"
 #include "company_cmd.h"
 #include "misc_cmd.h"
+#include "spritecache.h"
 
 #if defined(WITH_ZLIB)
 #include "network/network_content.h"
@@ -2761,6 +2762,24 @@ static bool ConFramerate(std::span<std::string_view> argv)
 	return true;
 }
 
+/** Show the sprite cache statistics. @copydoc IConsoleCmdProc */
+static bool ConSpriteCache(std::span<std::string_view> argv)
+{
+	if (argv.empty()) {
+		IConsolePrint(CC_HELP, "Show the use of the sprite cache since the game started.");
+		return true;
+	}
+
+	SpriteCacheStats stats = GetSpriteCacheStats();
+	uint64_t requests = stats.hits + stats.misses;
+	IConsolePrint(CC_DEFAULT, "Sprites cached: {} ({} bytes)", stats.sprites, stats.bytes);
+	IConsolePrint(CC_DEFAULT, "Hits:           {} ({:.1f}%)", stats.hits, requests == 0 ? 0.0 : 100.0 * stats.hits / requests);
+	IConsolePrint(CC_DEFAULT, "Misses:         {}", stats.misses);
+	IConsolePrint(CC_DEFAULT, "Evictions:      {}", stats.evictions);
+	IConsolePrint(CC_DEFAULT, "Prefetched:     {}", stats.prefetched);
+	return true;
+}
+
 /** Show the framerate statistics window. @copydoc IConsoleCmdProc */
 static bool ConFramerateWindow(std::span<std::string_view> argv)
 {
@@ -3095,6 +3114,7 @@ void IConsoleStdLibRegister()
 #endif
 	IConsole::CmdRegister("fps",                     ConFramerate);
 	IConsole::CmdRegister("fps_wnd",                 ConFramerateWindow);
+	IConsole::CmdRegister("sprite_cache",            ConSpriteCache);
 
 	/* NewGRF development stuff */
 	IConsole::CmdRegister("reload_newgrfs",          ConNewGRFReload,     ConHookNewGRFDeveloperTool);
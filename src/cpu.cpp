@@ -27,6 +27,9 @@ using CPUIDArray = std::array<int, 4>;
  *
  * Other platforms/architectures don't have CPUID, so zero the info and then
  * most (if not all) of the features are set as if they do not exist.
+ *
+ * The sub-leaf (ECX) is always zero, which is what the extended features
+ * of type 7 need and what the other types ignore.
  * @param type The information this instruction should retrieve.
  * @return The retrieved info. All zeros on architectures without CPUID.
  */
@@ -34,7 +37,7 @@ static CPUIDArray CPUID([[maybe_unused]] int type)
 {
 	CPUIDArray info{};
 #if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
-	__cpuid(info.data(), type);
+	__cpuidex(info.data(), type, 0);
 #elif defined(__i386) && defined(__PIC__)
 	/* The easy variant would be just cpuid, however... ebx is being used by the GOT (Global Offset Table)
 	 * in case of PIC;
@@ -46,7 +49,7 @@ static CPUIDArray CPUID([[maybe_unused]] int type)
 			"xchgl %%ebx, %1 \n\t"
 			"cpuid           \n\t"
 			"xchgl %%ebx, %1 \n\t"
-			: "=a" (info[0]), "=r" (info[1]), "=c" (info[2]), "=d" (info[3])
+			: "=a" (info[0]), "=r" (info[1]), "+c" (info[2]), "=d" (info[3])
 			/* It is safe to write "=r" for (info[1]) as in case that PIC is enabled for i386,
 			 * the compiler will not choose EBX as target register (but something else).
 			 */
@@ -55,7 +58,7 @@ static CPUIDArray CPUID([[maybe_unused]] int type)
 #elif defined(__x86_64__) || defined(__i386)
 	__asm__ __volatile__ (
 			"cpuid           \n\t"
-			: "=a" (info[0]), "=b" (info[1]), "=c" (info[2]), "=d" (info[3])
+			: "=a" (info[0]), "=b" (info[1]), "+c" (info[2]), "=d" (info[3])
 			: "a" (type)
 	);
 #elif defined(__e2k__) /* MCST Elbrus 2000*/
@@ -86,3 +89,27 @@ bool HasCPUIDFlag(uint type, uint index, uint bit)
 	cpu_info = CPUID(type);
 	return HasBit(cpu_info[index], bit);
 }
+
+/**
+ * Get the state components the operating system saves on a context switch.
+ * @return The low 32 bits of XCR0, or 0 when the operating system did not enable XSAVE.
+ */
+static uint32_t GetXCR0()
+{
+	if (!HasCPUIDFlag(1, 2, 27)) return 0; // OSXSAVE
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+	return static_cast<uint32_t>(_xgetbv(0));
+#elif defined(__x86_64__) || defined(__i386)
+	uint32_t eax, edx;
+	__asm__ __volatile__ ("xgetbv" : "=a" (eax), "=d" (edx) : "c" (0));
+	return eax;
+#else
+	return 0;
+#endif
+}
+
+bool HasCPUAVX2Support()
+{
+	/* The CPU must support AVX and AVX2, and the OS must save both the XMM and YMM registers. */
+	return HasCPUIDFlag(1, 2, 28) && HasCPUIDFlag(7, 1, 5) && (GetXCR0() & 0x6) == 0x6;
+}
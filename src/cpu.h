@@ -19,4 +19,10 @@
  */
 bool HasCPUIDFlag(uint type, uint index, uint bit);
 
+/**
+ * Check whether the current CPU and operating system support AVX2 instructions.
+ * @return True when AVX2 can be used.
+ */
+bool HasCPUAVX2Support();
+
 #endif /* CPU_H */
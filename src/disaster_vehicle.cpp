@@ -557,14 +557,14 @@ static bool DisasterTick_Big_Ufo(DisasterVehicle *v)
 
 		v->state = 2;
 
-		for (Vehicle *target : Vehicle::Iterate()) {
-			if (target->IsGroundVehicle()) {
-				if (Delta(target->x_pos, v->x_pos) + Delta(target->y_pos, v->y_pos) <= 12 * (int)TILE_SIZE) {
-					target->breakdown_ctr = 5;
-					target->breakdown_delay = 0xF0;
-				}
+		auto break_down = [v](Vehicle *target) {
+			if (Delta(target->x_pos, v->x_pos) + Delta(target->y_pos, v->y_pos) <= 12 * (int)TILE_SIZE) {
+				target->breakdown_ctr = 5;
+				target->breakdown_delay = 0xF0;
 			}
-		}
+		};
+		for (Train *target : Train::Iterate()) break_down(target);
+		for (RoadVehicle *target : RoadVehicle::Iterate()) break_down(target);
 
 		Town *t = ClosestTownFromTile(v->dest_tile, UINT_MAX);
 		AddTileNewsItem(GetEncodedString(STR_NEWS_DISASTER_BIG_UFO, t->index), NewsType::Accident, v->tile);
@@ -34,6 +34,7 @@
 #include "sound_func.h"
 #include "autoreplace_func.h"
 #include "company_gui.h"
+#include "smallmap_gui.h"
 #include "signs_base.h"
 #include "subsidy_base.h"
 #include "subsidy_func.h"
@@ -498,6 +499,9 @@ void ChangeOwnershipOfCompanyItems(Owner old_owner, Owner new_owner)
 
 		/* update signals in buffer */
 		UpdateSignalsInBuffer();
+
+		/* The tiles are not marked dirty one by one, so the smallmap has to determine the owners again. */
+		InvalidateSmallMap();
 	}
 
 	/* Add airport infrastructure count of the old company to the new one. */
@@ -26,11 +26,18 @@
 #include "game/game_instance.hpp"
 #include "timer/timer.h"
 #include "timer/timer_window.h"
+#include "timer/timer_game_realtime.h"
+#include "network/network_admin.h"
+#include "settings_type.h"
+#include "fileio_func.h"
+#include "debug.h"
 #include "zoom_func.h"
 
 #include "widgets/framerate_widget.h"
 
 #include <atomic>
+#include <filesystem>
+#include <fstream>
 #include <mutex>
 
 #include "table/strings.h"
@@ -73,6 +80,11 @@ namespace {
 		/** Start time for current accumulation cycle */
 		TimingMeasurement acc_timestamp{};
 
+		/** Whether all durations are recorded into \c recorded as well */
+		bool recording = false;
+		/** Every duration collected since recording started, see StartPerformanceRecording() */
+		std::vector<TimingMeasurement> recorded;
+
 		/**
 		 * Initialize a data element with an expected collection rate
 		 * @param expected_rate
@@ -90,6 +102,7 @@ namespace {
 		{
 			this->durations[this->next_index] = end_time - start_time;
 			this->timestamps[this->next_index] = start_time;
+			if (this->recording) this->recorded.push_back(end_time - start_time);
 			this->prev_index = this->next_index;
 			this->next_index += 1;
 			if (this->next_index >= NUM_FRAMERATE_POINTS) this->next_index = 0;
@@ -104,6 +117,7 @@ namespace {
 		{
 			this->timestamps[this->next_index] = this->acc_timestamp;
 			this->durations[this->next_index] = this->acc_duration;
+			if (this->recording) this->recorded.push_back(this->acc_duration);
 			this->prev_index = this->next_index;
 			this->next_index += 1;
 			if (this->next_index >= NUM_FRAMERATE_POINTS) this->next_index = 0;
@@ -222,6 +236,10 @@ namespace {
 		PerformanceData(1),                     // PFE_ACC_GL_SHIPS
 		PerformanceData(1),                     // PFE_ACC_GL_AIRCRAFT
 		PerformanceData(1),                     // PFE_GL_LANDSCAPE
+		PerformanceData(1),                     // PFE_GL_TILELOOP
+		PerformanceData(1),                     // PFE_GL_TOWNS
+		PerformanceData(1),                     // PFE_GL_STATIONS
+		PerformanceData(1),                     // PFE_GL_INDUSTRIES
 		PerformanceData(1),                     // PFE_GL_LINKGRAPH
 		PerformanceData(1000.0 / 30),           // PFE_DRAWING
 		PerformanceData(1),                     // PFE_ACC_DRAWWORLD
@@ -363,6 +381,112 @@ void PerformanceAccumulator::Reset(PerformanceElement elem)
 }
 
 
+/**
+ * Calculate the statistics of a series of durations.
+ * @param durations The durations; they will be sorted.
+ * @return The statistics, all zero when there are no durations.
+ */
+static PerformanceStatistics CalculatePerformanceStatistics(std::vector<TimingMeasurement> &durations)
+{
+	PerformanceStatistics stats{};
+	if (durations.empty()) return stats;
+
+	std::ranges::sort(durations);
+
+	/* Nearest-rank percentile of the sorted durations, in milliseconds. */
+	auto percentile = [&durations](uint percent) -> double {
+		size_t rank = (durations.size() * percent + 99) / 100;
+		return durations[std::max<size_t>(rank, 1) - 1] * 1000.0 / TIMESTAMP_PRECISION;
+	};
+
+	stats.count = durations.size();
+	stats.mean = std::accumulate(durations.begin(), durations.end(), 0.0) * 1000.0 / TIMESTAMP_PRECISION / durations.size();
+	stats.p50 = percentile(50);
+	stats.p99 = percentile(99);
+	stats.max = durations.back() * 1000.0 / TIMESTAMP_PRECISION;
+	return stats;
+}
+
+/**
+ * Start recording every measurement of all performance elements, instead of only the last #NUM_FRAMERATE_POINTS.
+ * Earlier recordings are discarded.
+ */
+void StartPerformanceRecording()
+{
+	for (auto &pf : _pf_data) {
+		pf.recording = true;
+		pf.recorded.clear();
+	}
+}
+
+/**
+ * Stop recording measurements and summarise what was recorded since StartPerformanceRecording().
+ * @return The statistics of each performance element; elements without measurements have a count of 0.
+ */
+std::array<PerformanceStatistics, PFE_MAX> StopPerformanceRecording()
+{
+	std::array<PerformanceStatistics, PFE_MAX> result{};
+	for (PerformanceElement e = PFE_FIRST; e < PFE_MAX; e++) {
+		auto &pf = _pf_data[e];
+		pf.recording = false;
+
+		result[e] = CalculatePerformanceStatistics(pf.recorded);
+		pf.recorded.clear();
+		pf.recorded.shrink_to_fit();
+	}
+	return result;
+}
+
+/**
+ * Get the statistics of the recent measurements of a performance element, i.e. the ones shown in the frame time graph.
+ * @param elem The element to get the statistics of.
+ * @return The statistics; the count is 0 when there are no recent measurements.
+ */
+PerformanceStatistics GetPerformanceStatistics(PerformanceElement elem)
+{
+	const auto &pf = _pf_data[elem];
+
+	std::vector<TimingMeasurement> durations;
+	for (int i = 0; i < std::min(pf.num_valid, NUM_FRAMERATE_POINTS); i++) {
+		TimingMeasurement d = pf.durations[i];
+		if (d != PerformanceData::INVALID_DURATION) durations.push_back(d);
+	}
+	return CalculatePerformanceStatistics(durations);
+}
+
+/**
+ * Get a short identifier of a performance element, for use in machine readable output.
+ * @param elem The element to get the identifier of.
+ * @return The identifier.
+ */
+std::string GetPerformanceElementKey(PerformanceElement elem)
+{
+	static const std::array<std::string_view, PFE_AI0> KEYS = {
+		"gameloop",
+		"gl_economy",
+		"gl_trains",
+		"gl_roadvehs",
+		"gl_ships",
+		"gl_aircraft",
+		"gl_landscape",
+		"gl_tileloop",
+		"gl_towns",
+		"gl_stations",
+		"gl_industries",
+		"gl_linkgraph",
+		"drawing",
+		"drawworld",
+		"video",
+		"sound",
+		"allscripts",
+		"gamescript",
+	};
+
+	if (elem < PFE_AI0) return std::string{KEYS[elem]};
+	return fmt::format("ai{}", elem - PFE_AI0);
+}
+
+
 void ShowFrametimeGraphWindow(PerformanceElement elem);
 
 
@@ -374,6 +498,10 @@ static const PerformanceElement DISPLAY_ORDER_PFE[PFE_MAX] = {
 	PFE_GL_SHIPS,
 	PFE_GL_AIRCRAFT,
 	PFE_GL_LANDSCAPE,
+	PFE_GL_TILELOOP,
+	PFE_GL_TOWNS,
+	PFE_GL_STATIONS,
+	PFE_GL_INDUSTRIES,
 	PFE_ALLSCRIPTS,
 	PFE_GAMESCRIPT,
 	PFE_AI0,
@@ -1056,6 +1184,10 @@ void ConPrintFramerate()
 		"  GL ship ticks",
 		"  GL aircraft ticks",
 		"  GL landscape ticks",
+		"    GL tile loop",
+		"    GL town ticks",
+		"    GL station ticks",
+		"    GL industry ticks",
 		"  GL link graph delays",
 		"Drawing",
 		"  Viewport drawing",
@@ -1119,3 +1251,64 @@ void ProcessPendingPerformanceMeasurements()
 		_sound_perf_pending.store(false, std::memory_order_relaxed);
 	}
 }
+
+/**
+ * Write the statistics over the recent measurements of all performance elements to a file, in the Prometheus text format.
+ * The file is first written under a temporary name and then renamed, so readers never see a partially written file.
+ * @param filename The file to write to, relative to the personal directory.
+ */
+static void WritePerformanceTelemetry(const std::string &filename)
+{
+	/* The setting can be changed from the console, so do not let it point outside of the personal directory. */
+	std::filesystem::path name(OTTD2FS(filename));
+	if (name.has_root_path() || std::ranges::any_of(name, [](const std::filesystem::path &part) { return part == ".."; })) {
+		Debug(misc, 0, "Not writing the performance telemetry to {}, it has to be a path within the personal directory", filename);
+		return;
+	}
+
+	std::string path = _personal_dir + filename;
+	std::string path_new = path + ".new";
+
+	std::ofstream os(OTTD2FS(path_new));
+	if (!os.is_open()) {
+		Debug(misc, 0, "Could not open {} for writing the performance telemetry", path_new);
+		return;
+	}
+
+	os << "# HELP openttd_performance_milliseconds Time spent per game loop or frame on each part of the game.\n";
+	os << "# TYPE openttd_performance_milliseconds summary\n";
+	for (PerformanceElement e = PFE_FIRST; e < PFE_MAX; e++) {
+		PerformanceStatistics stats = GetPerformanceStatistics(e);
+		if (stats.count == 0) continue;
+
+		std::string key = GetPerformanceElementKey(e);
+		os << fmt::format("openttd_performance_milliseconds{{element=\"{}\",quantile=\"0.5\"}} {:.4f}\n", key, stats.p50);
+		os << fmt::format("openttd_performance_milliseconds{{element=\"{}\",quantile=\"0.99\"}} {:.4f}\n", key, stats.p99);
+		os << fmt::format("openttd_performance_milliseconds{{element=\"{}\",quantile=\"1\"}} {:.4f}\n", key, stats.max);
+		os << fmt::format("openttd_performance_milliseconds_sum{{element=\"{}\"}} {:.4f}\n", key, stats.mean * stats.count);
+		os << fmt::format("openttd_performance_milliseconds_count{{element=\"{}\"}} {}\n", key, stats.count);
+	}
+
+	os.close();
+	if (os.fail()) {
+		Debug(misc, 0, "Writing the performance telemetry to {} failed", path_new);
+		return;
+	}
+
+	std::error_code ec;
+	std::filesystem::rename(OTTD2FS(path_new), OTTD2FS(path), ec);
+	if (ec) Debug(misc, 0, "Renaming {} to {} failed: {}", path_new, path, ec.message());
+}
+
+/** Export the performance statistics every network.performance_telemetry_interval seconds. */
+static IntervalTimer<TimerGameRealtime> _performance_telemetry_interval({std::chrono::seconds(1), TimerGameRealtime::Trigger::Always}, [](auto)
+{
+	static uint seconds_passed = 0;
+
+	uint interval = _settings_client.network.performance_telemetry_interval;
+	if (interval == 0 || ++seconds_passed < interval) return;
+	seconds_passed = 0;
+
+	if (!_settings_client.network.performance_telemetry_file.empty()) WritePerformanceTelemetry(_settings_client.network.performance_telemetry_file);
+	NetworkAdminPerformance();
+});
@@ -18,7 +18,8 @@
  * Second is adding a member to the \link anonymous_namespace{framerate_gui.cpp}::_pf_data _pf_data \endlink array, in the same position as the new #PerformanceElement member.
  *
  * @par
- * Third is adding strings for the new element. There is an array in #ConPrintFramerate with strings used for the console command.
+ * Third is adding strings for the new element. There is an array in #ConPrintFramerate with strings used for the console command,
+ * and an array in #GetPerformanceElementKey with the identifiers used in machine readable output.
  * Additionally, there are two sets of strings in \c english.txt for two GUI uses, also in the #PerformanceElement order.
  * Search for \c STR_FRAMERATE_GAMELOOP and \c STR_FRAMETIME_CAPTION_GAMELOOP in \c english.txt to find those.
  *
@@ -52,6 +53,10 @@ enum PerformanceElement : uint8_t {
 	PFE_GL_SHIPS,      ///< Time spent processing ships
 	PFE_GL_AIRCRAFT,   ///< Time spent processing aircraft
 	PFE_GL_LANDSCAPE,  ///< Time spent processing other world features
+	PFE_GL_TILELOOP,   ///< Time spent in the tile loop, part of #PFE_GL_LANDSCAPE
+	PFE_GL_TOWNS,      ///< Time spent processing towns, part of #PFE_GL_LANDSCAPE
+	PFE_GL_STATIONS,   ///< Time spent processing stations, part of #PFE_GL_LANDSCAPE
+	PFE_GL_INDUSTRIES, ///< Time spent processing industries, part of #PFE_GL_LANDSCAPE
 	PFE_GL_LINKGRAPH,  ///< Time spent waiting for link graph background jobs
 	PFE_DRAWING,       ///< Speed of drawing world and GUI.
 	PFE_DRAWWORLD,     ///< Time spent drawing world viewports in GUI
@@ -119,7 +124,20 @@ public:
 	static void Reset(PerformanceElement elem);
 };
 
+/** Statistics of the recorded durations of a performance element, see StartPerformanceRecording(). */
+struct PerformanceStatistics {
+	size_t count; ///< Number of recorded durations.
+	double mean; ///< Mean duration in milliseconds.
+	double p50; ///< Median duration in milliseconds.
+	double p99; ///< 99th percentile of the durations in milliseconds.
+	double max; ///< Longest duration in milliseconds.
+};
+
 void ShowFramerateWindow();
 void ProcessPendingPerformanceMeasurements();
+void StartPerformanceRecording();
+std::array<PerformanceStatistics, PFE_MAX> StopPerformanceRecording();
+std::string GetPerformanceElementKey(PerformanceElement elem);
+PerformanceStatistics GetPerformanceStatistics(PerformanceElement elem);
 
 #endif /* FRAMERATE_TYPE_H */
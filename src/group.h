@@ -26,6 +26,7 @@ struct GroupStatistics {
 	Money profit_last_year = 0; ///< Sum of profits for all vehicles.
 	Money profit_last_year_min_age = 0; ///< Sum of profits for vehicles considered for profit statistics.
 	std::map<EngineID, uint16_t> num_engines{}; ///< Caches the number of engines of each type the company owns.
+	FlatSet<VehicleID> vehicles{}; ///< Primary vehicles in the group itself, sorted by index.
 	uint16_t num_vehicle = 0; ///< Number of vehicles.
 	uint16_t num_vehicle_min_age = 0; ///< Number of vehicles considered for profit statistics;
 	bool autoreplace_defined = false; ///< Are any autoreplace rules set?
@@ -83,6 +84,9 @@ struct Group : GroupPool::PoolItem<&_group_pool> {
 	FlatSet<GroupID> children; ///< NOSAVE: child groups belonging to this group.
 	bool folded = false; ///< NOSAVE: Is this group folded in the group view?
 
+	std::vector<VehicleID> subtree_vehicles{}; ///< NOSAVE: Primary vehicles in this group and its sub groups, sorted by index; only valid when #subtree_vehicles_valid.
+	bool subtree_vehicles_valid = false; ///< NOSAVE: Is #subtree_vehicles up to date?
+
 	GroupID parent = GroupID::Invalid(); ///< Parent group
 	uint16_t number = 0; ///< Per-company group number.
 
@@ -113,6 +117,9 @@ uint GetGroupNumVehicle(CompanyID company, GroupID id_g, VehicleType type);
 uint GetGroupNumVehicleMinAge(CompanyID company, GroupID id_g, VehicleType type);
 Money GetGroupProfitLastYearMinAge(CompanyID company, GroupID id_g, VehicleType type);
 
+std::span<const VehicleID> GetGroupVehicles(CompanyID company, GroupID id_g, VehicleType type);
+void InvalidateGroupSubtreeVehicles(GroupID id_g);
+
 void SetTrainGroupID(Train *v, GroupID grp);
 void UpdateTrainGroupID(Train *v);
 void RemoveAllGroupsForCompany(const CompanyID company);
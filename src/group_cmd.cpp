@@ -39,6 +39,7 @@ void GroupStatistics::Clear()
 
 	/* This is also called when NewGRF change. So the number of engines might have changed. Reset. */
 	this->num_engines.clear();
+	this->vehicles.clear();
 }
 
 /**
@@ -56,10 +57,49 @@ void UpdateGroupChildren()
 			g->parent = GroupID::Invalid();
 		} else {
 			pg->children.insert(g->index);
+			InvalidateGroupSubtreeVehicles(pg->index);
 		}
 	}
 }
 
+/**
+ * Mark the cached vehicles of a group and all its parents as outdated.
+ * @param id_g The group whose vehicles changed.
+ */
+void InvalidateGroupSubtreeVehicles(GroupID id_g)
+{
+	for (Group *g = Group::GetIfValid(id_g); g != nullptr; g = Group::GetIfValid(g->parent)) {
+		g->subtree_vehicles_valid = false;
+	}
+}
+
+/**
+ * Get the primary vehicles in a group, including the vehicles in its sub groups.
+ * @param company The company the group belongs to.
+ * @param id_g The group, can be #DEFAULT_GROUP or #ALL_GROUP.
+ * @param type The vehicle type of the group.
+ * @return The vehicles, sorted by index. Only valid until vehicles are added to or removed from groups.
+ */
+std::span<const VehicleID> GetGroupVehicles(CompanyID company, GroupID id_g, VehicleType type)
+{
+	Group *g = Group::GetIfValid(id_g);
+	if (g == nullptr || g->children.empty()) {
+		const FlatSet<VehicleID> &vehicles = GroupStatistics::Get(company, id_g, type).vehicles;
+		return {vehicles.begin(), vehicles.end()};
+	}
+
+	if (!g->subtree_vehicles_valid) {
+		g->subtree_vehicles.assign(g->statistics.vehicles.begin(), g->statistics.vehicles.end());
+		for (const GroupID &childgroup : g->children) {
+			std::span<const VehicleID> child_vehicles = GetGroupVehicles(company, childgroup, type);
+			g->subtree_vehicles.insert(std::end(g->subtree_vehicles), std::begin(child_vehicles), std::end(child_vehicles));
+		}
+		std::ranges::sort(g->subtree_vehicles);
+		g->subtree_vehicles_valid = true;
+	}
+	return g->subtree_vehicles;
+}
+
 /**
  * Get number of vehicles of a specific engine ID.
  * @param engine Engine ID.
@@ -161,6 +201,15 @@ uint16_t GroupStatistics::GetNumEngines(EngineID engine) const
 	stats.num_vehicle += delta;
 	stats.profit_last_year += v->GetDisplayProfitLastYear() * delta;
 
+	if (delta > 0) {
+		stats_all.vehicles.insert(v->index);
+		stats.vehicles.insert(v->index);
+	} else {
+		stats_all.vehicles.erase(v->index);
+		stats.vehicles.erase(v->index);
+	}
+	InvalidateGroupSubtreeVehicles(v->group_id);
+
 	if (v->economy_age > VEHICLE_PROFIT_MIN_AGE) {
 		stats_all.num_vehicle_min_age += delta;
 		stats_all.profit_last_year_min_age += v->GetDisplayProfitLastYear() * delta;
@@ -305,12 +354,10 @@ static void PropagateChildLivery(const Group *g, bool reset_cache)
 {
 	if (reset_cache) {
 		/* Company colour data is indirectly cached. */
-		for (Vehicle *v : Vehicle::Iterate()) {
-			if (v->group_id == g->index && (!v->IsGroundVehicle() || v->IsFrontEngine())) {
-				for (Vehicle *u = v; u != nullptr; u = u->Next()) {
-					u->colourmap = PAL_NONE;
-					u->InvalidateNewGRFCache();
-				}
+		for (VehicleID vehicle : g->statistics.vehicles) {
+			for (Vehicle *u = Vehicle::Get(vehicle); u != nullptr; u = u->Next()) {
+				u->colourmap = PAL_NONE;
+				u->InvalidateNewGRFCache();
 			}
 		}
 	}
@@ -424,6 +471,7 @@ CommandCost CmdDeleteGroup(DoCommandFlags flags, GroupID group_id)
 		if (g->parent != GroupID::Invalid()) {
 			Group *pg = Group::Get(g->parent);
 			pg->children.erase(g->index);
+			InvalidateGroupSubtreeVehicles(pg->index);
 		}
 
 		VehicleType vt = g->vehicle_type;
@@ -486,9 +534,11 @@ CommandCost CmdAlterGroup(DoCommandFlags flags, AlterGroupMode mode, GroupID gro
 		}
 
 		if (flags.Test(DoCommandFlag::Execute)) {
+			InvalidateGroupSubtreeVehicles(g->parent);
 			if (g->parent != GroupID::Invalid()) Group::Get(g->parent)->children.erase(g->index);
 			g->parent = (pg == nullptr) ? GroupID::Invalid() : pg->index;
 			if (g->parent != GroupID::Invalid()) Group::Get(g->parent)->children.insert(g->index);
+			InvalidateGroupSubtreeVehicles(g->parent);
 
 			GroupStatistics::UpdateAutoreplace(g->owner);
 
@@ -631,16 +681,17 @@ CommandCost CmdAddSharedVehicleGroup(DoCommandFlags flags, GroupID id_g, Vehicle
 	if (!Group::IsValidID(id_g) || !IsCompanyBuildableVehicleType(type)) return CMD_ERROR;
 
 	if (flags.Test(DoCommandFlag::Execute)) {
-		/* Find the first front engine which belong to the group id_g
-		 * then add all shared vehicles of this front engine to the group id_g */
-		for (const Vehicle *v : Vehicle::Iterate()) {
-			if (v->type == type && v->IsPrimaryVehicle()) {
-				if (v->group_id != id_g) continue;
-
-				/* For each shared vehicles add it to the group */
-				for (Vehicle *v2 = v->FirstShared(); v2 != nullptr; v2 = v2->NextShared()) {
-					if (v2->group_id != id_g) Command<Commands::AddVehicleToGroup>::Do(flags, id_g, v2->index, false, VehicleListIdentifier{});
-				}
+		/* Find the front engines which belong to the group id_g then add all shared
+		 * vehicles of these front engines to the group id_g. Use a copy of the members
+		 * as adding vehicles to the group changes them. */
+		std::vector<VehicleID> members(Group::Get(id_g)->statistics.vehicles.begin(), Group::Get(id_g)->statistics.vehicles.end());
+		for (VehicleID vehicle : members) {
+			const Vehicle *v = Vehicle::Get(vehicle);
+			if (v->type != type) continue;
+
+			/* For each shared vehicles add it to the group */
+			for (Vehicle *v2 = v->FirstShared(); v2 != nullptr; v2 = v2->NextShared()) {
+				if (v2->group_id != id_g) Command<Commands::AddVehicleToGroup>::Do(flags, id_g, v2->index, false, VehicleListIdentifier{});
 			}
 		}
 
@@ -664,14 +715,11 @@ CommandCost CmdRemoveAllVehiclesGroup(DoCommandFlags flags, GroupID group_id)
 	if (g == nullptr || g->owner != _current_company) return CMD_ERROR;
 
 	if (flags.Test(DoCommandFlag::Execute)) {
-		/* Find each Vehicle that belongs to the group old_g and add it to the default group */
-		for (const Vehicle *v : Vehicle::Iterate()) {
-			if (v->IsPrimaryVehicle()) {
-				if (v->group_id != group_id) continue;
-
-				/* Add The Vehicle to the default group */
-				Command<Commands::AddVehicleToGroup>::Do(flags, DEFAULT_GROUP, v->index, false, VehicleListIdentifier{});
-			}
+		/* Add each Vehicle that belongs to the group old_g to the default group. Use a
+		 * copy of the members as moving vehicles out of the group changes them. */
+		std::vector<VehicleID> members(g->statistics.vehicles.begin(), g->statistics.vehicles.end());
+		for (VehicleID vehicle : members) {
+			Command<Commands::AddVehicleToGroup>::Do(flags, DEFAULT_GROUP, vehicle, false, VehicleListIdentifier{});
 		}
 
 		InvalidateWindowData(GetWindowClassForVehicleType(g->vehicle_type), VehicleListIdentifier(VL_GROUP_LIST, g->vehicle_type, _current_company).ToWindowNumber());
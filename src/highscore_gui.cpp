@@ -126,12 +126,12 @@ struct EndGameWindow : EndGameHighScoreBaseWindow {
 		/* In a network game show the endscores of the custom difficulty 'network' which is
 		 * a TOP5 of that game, and not an all-time TOP5. */
 		if (_networking) {
-			this->window_number = SP_MULTIPLAYER;
+			this->ChangeWindowNumber(SP_MULTIPLAYER);
 			this->rank = SaveHighScoreValueNetwork();
 		} else {
 			/* in singleplayer mode _local company is always valid */
 			const Company *c = Company::Get(_local_company);
-			this->window_number = SP_CUSTOM;
+			this->ChangeWindowNumber(SP_CUSTOM);
 			this->rank = SaveHighScoreValue(c);
 		}
 
@@ -180,7 +180,7 @@ struct HighScoreWindow : EndGameHighScoreBaseWindow {
 		if (_game_mode != GM_MENU) HideVitalWindows();
 
 		MarkWholeScreenDirty();
-		this->window_number = difficulty; // show highscore chart for difficulty...
+		this->ChangeWindowNumber(difficulty); // show highscore chart for difficulty...
 		this->background_img = SPR_HIGHSCORE_CHART_BEGIN; // which background to show
 		this->rank = ranking;
 	}
@@ -327,5 +327,6 @@ enum IndustryDirectoryInvalidateWindowData : uint8_t {
 };
 
 void TrimIndustryAcceptedProduced(Industry *ind);
+void PopulateStationsNearby(Industry *ind);
 
 #endif /* INDUSTRY_H */
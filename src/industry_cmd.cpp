@@ -207,6 +207,7 @@ Industry::~Industry()
 
 	for (Station *st : this->stations_near) {
 		st->RemoveIndustryToDeliver(this);
+		st->InvalidateAcceptanceCache();
 	}
 }
 
@@ -1734,13 +1735,20 @@ static void AdvertiseIndustryOpening(const Industry *ind)
  * add the industry to each station's nearby industry list.
  * @param ind Industry
  */
-static void PopulateStationsNearby(Industry *ind)
+void PopulateStationsNearby(Industry *ind)
 {
 	if (ind->neutral_station != nullptr && !_settings_game.station.serve_neutral_industries) {
 		/* Industry has a neutral station. Use it and ignore any other nearby stations. */
 		ind->stations_near.insert(ind->neutral_station);
+		ind->neutral_station->InvalidateAcceptanceCache();
 		ind->neutral_station->industries_near.clear();
 		ind->neutral_station->industries_near.insert(IndustryListEntry{0, ind});
+
+		/* The other stations do not serve the industry, but its tiles still add to their acceptance. */
+		ForAllStationsAroundTiles(ind->location, [](Station *st, TileIndex) {
+			st->InvalidateAcceptanceCache();
+			return true;
+		});
 		return;
 	}
 
@@ -1748,6 +1756,7 @@ static void PopulateStationsNearby(Industry *ind)
 		if (!IsTileType(tile, TileType::Industry) || GetIndustryIndex(tile) != ind->index) return false;
 		ind->stations_near.insert(st);
 		st->AddIndustryToDeliver(ind, tile);
+		st->InvalidateAcceptanceCache();
 		return false;
 	});
 }
@@ -804,6 +804,7 @@ TileIndex _cur_tileloop_tile;
 void RunTileLoop()
 {
 	PerformanceAccumulator framerate(PFE_GL_LANDSCAPE);
+	PerformanceAccumulator tileloop_framerate(PFE_GL_TILELOOP);
 
 	/* The pseudorandom sequence of tiles is generated using a Galois linear feedback
 	 * shift register (LFSR). This allows a deterministic pseudorandom ordering, but
@@ -1731,10 +1732,19 @@ void CallLandscapeTick()
 	{
 		PerformanceAccumulator framerate(PFE_GL_LANDSCAPE);
 
-		OnTick_Town();
+		{
+			PerformanceAccumulator towns_framerate(PFE_GL_TOWNS);
+			OnTick_Town();
+		}
 		OnTick_Trees();
-		OnTick_Station();
-		OnTick_Industry();
+		{
+			PerformanceAccumulator stations_framerate(PFE_GL_STATIONS);
+			OnTick_Station();
+		}
+		{
+			PerformanceAccumulator industries_framerate(PFE_GL_INDUSTRIES);
+			OnTick_Industry();
+		}
 	}
 
 	OnTick_Companies();
@@ -13,6 +13,11 @@
 #include "error_func.h"
 #include "string_func.h"
 #include "pathfinder/water_regions.h"
+#include "cpu.h"
+
+#ifdef WITH_SSE
+#include <emmintrin.h>
+#endif
 
 #include "safeguards.h"
 
@@ -25,6 +30,8 @@
 
 /* static */ uint Map::initial_land_count; ///< Initial number of land tiles on the map.
 
+/* static */ std::unique_ptr<uint8_t[]> Tile::type_plane; ///< Type plane of the map
+/* static */ std::unique_ptr<uint8_t[]> Tile::height_plane; ///< Height plane of the map
 /* static */ std::unique_ptr<Tile::TileBase[]> Tile::base_tiles; ///< Base tiles of the map
 /* static */ std::unique_ptr<Tile::TileExtended[]> Tile::extended_tiles; ///< Extended tiles of the map
 
@@ -54,6 +61,8 @@
 	Map::size = size_x * size_y;
 	Map::tile_mask = Map::size - 1;
 
+	Tile::type_plane = std::make_unique<uint8_t[]>(Map::size);
+	Tile::height_plane = std::make_unique<uint8_t[]>(Map::size);
 	Tile::base_tiles = std::make_unique<Tile::TileBase[]>(Map::size);
 	Tile::extended_tiles = std::make_unique<Tile::TileExtended[]>(Map::size);
 
@@ -74,6 +83,68 @@
 	Map::initial_land_count = std::min(Map::initial_land_count, Map::size);
 }
 
+#ifdef WITH_SSE
+/**
+ * Check whether the SSE2 variants of the map scanning kernels can be used.
+ * @return True iff the CPU supports SSE2.
+ */
+static bool MapScanUseSSE2()
+{
+	static const bool use_sse2 = HasCPUIDFlag(1, 3, 26);
+	return use_sse2;
+}
+
+/**
+ * Get the highest byte within a span of a plane.
+ * @param plane The start of the span.
+ * @param count The number of bytes in the span.
+ * @return The highest byte.
+ */
+GNU_TARGET("sse2")
+static uint8_t GetMaxByteSSE2(const uint8_t *plane, uint count)
+{
+	__m128i max_v = _mm_setzero_si128();
+	uint i = 0;
+	for (; i + 16 <= count; i += 16) {
+		max_v = _mm_max_epu8(max_v, _mm_loadu_si128(reinterpret_cast<const __m128i *>(plane + i)));
+	}
+	max_v = _mm_max_epu8(max_v, _mm_srli_si128(max_v, 8));
+	max_v = _mm_max_epu8(max_v, _mm_srli_si128(max_v, 4));
+	max_v = _mm_max_epu8(max_v, _mm_srli_si128(max_v, 2));
+	max_v = _mm_max_epu8(max_v, _mm_srli_si128(max_v, 1));
+
+	uint8_t result = static_cast<uint8_t>(_mm_cvtsi128_si32(max_v));
+	for (; i < count; i++) result = std::max(result, plane[i]);
+	return result;
+}
+#endif /* WITH_SSE */
+
+/**
+ * Get the highest tile height within an area of the map.
+ * @param x The X coordinate of the northern tile of the area.
+ * @param y The Y coordinate of the northern tile of the area.
+ * @param w The width of the area.
+ * @param h The height of the area.
+ * @return The highest height of all tiles in the area.
+ */
+/* static */ uint Map::GetMaxHeightInArea(uint x, uint y, uint w, uint h)
+{
+	assert(x + w <= Map::SizeX() && y + h <= Map::SizeY());
+
+	uint8_t result = 0;
+	for (uint row = y; row < y + h; row++) {
+		const uint8_t *plane = Tile::height_plane.get() + TileXY(x, row).base();
+#ifdef WITH_SSE
+		if (MapScanUseSSE2()) {
+			result = std::max(result, GetMaxByteSSE2(plane, w));
+			continue;
+		}
+#endif
+		for (uint i = 0; i < w; i++) result = std::max(result, plane[i]);
+	}
+	return result;
+}
+
 /**
  * Get a tile from the virtual XY-coordinate.
  * Coordinates outside of the map are clamped to the map edge.
@@ -27,11 +27,12 @@ private:
 	friend struct Map;
 	/**
 	 * Data that is stored per tile. Also used TileExtended for this.
+	 * The type and height are not part of this, they are kept in their own
+	 * dense planes so whole-map scans over them do not need to touch the
+	 * rest of the tile data.
 	 * Look at docs/landscape.html for the exact meaning of the members.
 	 */
 	struct TileBase {
-		uint8_t type = 0; ///< The type (bits 4..7), bridges (2..3), rainforest/desert (0..1)
-		uint8_t height = 0; ///< The height of the northern corner.
 		uint16_t m2 = 0; ///< Primarily used for indices to towns, industries and stations
 		uint8_t m1 = 0; ///< Primarily used for ownership information
 		uint8_t m3 = 0; ///< General purpose
@@ -39,7 +40,7 @@ private:
 		uint8_t m5 = 0; ///< General purpose
 	};
 
-	static_assert(sizeof(TileBase) == 8);
+	static_assert(sizeof(TileBase) == 6);
 
 	/**
 	 * Data that is stored per tile. Also used TileBase for this.
@@ -51,6 +52,8 @@ private:
 		uint16_t m8 = 0; ///< General purpose
 	};
 
+	static std::unique_ptr<uint8_t[]> type_plane; ///< Per tile the type (bits 4..7), bridges (2..3), rainforest/desert (0..1).
+	static std::unique_ptr<uint8_t[]> height_plane; ///< Per tile the height of the northern corner.
 	static std::unique_ptr<TileBase[]> base_tiles; ///< Pointer to the tile-array.
 	static std::unique_ptr<TileExtended[]> extended_tiles; ///< Pointer to the extended tile-array.
 
@@ -89,7 +92,7 @@ public:
 	 */
 	[[debug_inline]] inline uint8_t &type()
 	{
-		return base_tiles[this->tile.base()].type;
+		return type_plane[this->tile.base()];
 	}
 
 	/**
@@ -100,7 +103,7 @@ public:
 	 */
 	[[debug_inline]] inline uint8_t &height()
 	{
-		return base_tiles[this->tile.base()].height;
+		return height_plane[this->tile.base()];
 	}
 
 	/**
@@ -235,6 +238,8 @@ public:
 	static void Allocate(uint size_x, uint size_y);
 	static void CountLandTiles();
 
+	static uint GetMaxHeightInArea(uint x, uint y, uint w, uint h);
+
 	/**
 	 * Logarithm of the map size along the X side.
 	 * @note try to avoid using this one
@@ -29,6 +29,7 @@
 #include "game/game.hpp"
 #include "linkgraph/linkgraphschedule.h"
 #include "station_kdtree.h"
+#include "station_func.h"
 #include "town_kdtree.h"
 #include "viewport_kdtree.h"
 #include "newgrf_profiling.h"
@@ -127,6 +128,7 @@ void InitializeGame(uint size_x, uint size_y, bool reset_date, bool reset_settin
 	PoolBase::Clean(PoolType::Normal);
 
 	RebuildStationKdtree();
+	_station_tick_scheduler.Rebuild();
 	RebuildTownKdtree();
 	RebuildViewportKdtree();
 
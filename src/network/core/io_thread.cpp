@@ -0,0 +1,392 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/** @file io_thread.cpp Implementation of the thread doing the socket I/O of TCP connections. */
+
+#include "../../stdafx.h"
+#include "../../debug.h"
+#include "../../thread.h"
+#include "io_thread.h"
+
+#include "../../safeguards.h"
+
+/**
+ * Create a UDP socket on the loopback interface that is connected to itself.
+ * Sending a datagram over it makes it readable, which wakes up the thread polling it.
+ * @return The socket, or INVALID_SOCKET on failure.
+ */
+static SOCKET CreateWakeSocket()
+{
+	SOCKET s = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	if (s == INVALID_SOCKET) return INVALID_SOCKET;
+
+	sockaddr_in addr{};
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	socklen_t addr_len = sizeof(addr);
+
+	if (bind(s, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 ||
+			getsockname(s, reinterpret_cast<sockaddr *>(&addr), &addr_len) != 0 ||
+			connect(s, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 ||
+			!SetNonBlocking(s)) {
+		Debug(net, 0, "Could not create wake-up socket: {}", NetworkError::GetLast().AsString());
+		closesocket(s);
+		return INVALID_SOCKET;
+	}
+	return s;
+}
+
+NetworkIOThread::~NetworkIOThread()
+{
+	this->Stop();
+}
+
+/**
+ * Start the thread, when it is not running yet.
+ * @return Whether the thread is running; when not, the game thread has to do the I/O itself.
+ */
+bool NetworkIOThread::Start()
+{
+	if (this->thread.joinable()) return true;
+
+	this->wake_socket = CreateWakeSocket();
+	if (this->wake_socket == INVALID_SOCKET) return false;
+	this->poller.Watch(this->wake_socket, SocketEvent::Read);
+
+	this->stop = false;
+	if (!StartNewThread(&this->thread, "ottd:network", [this]() { this->ThreadMain(); })) {
+		this->poller.Unwatch(this->wake_socket);
+		closesocket(this->wake_socket);
+		this->wake_socket = INVALID_SOCKET;
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Stop the thread, and give the connections it still handles back to the game thread.
+ */
+void NetworkIOThread::Stop()
+{
+	if (!this->thread.joinable()) return;
+
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->stop = true;
+		this->Wake();
+	}
+	this->thread.join();
+
+	while (!this->connections.empty()) this->Release(*this->connections.begin()->first);
+
+	this->poller.Unwatch(this->wake_socket);
+	closesocket(this->wake_socket);
+	this->wake_socket = INVALID_SOCKET;
+}
+
+/** Wake up the I/O thread, when it is waiting for the sockets. */
+void NetworkIOThread::Wake()
+{
+	static const uint8_t data = 0;
+	SocketSender{this->wake_socket}(std::span(&data, 1));
+}
+
+/**
+ * Hand the I/O of a connection over to the thread.
+ * Packets that have been queued or partially received so far are handled by the thread.
+ * @param handler The connection.
+ */
+void NetworkIOThread::Adopt(NetworkTCPSocketHandler &handler)
+{
+	assert(handler.io_thread == nullptr);
+	assert(this->thread.joinable());
+
+	/* From now on only the thread watches the socket. */
+	if (handler.poller != nullptr) {
+		handler.poller->Unwatch(handler.sock);
+		handler.poller = nullptr;
+	}
+	handler.io_thread = this;
+
+	std::lock_guard<std::mutex> lock(this->mutex);
+	this->connections.try_emplace(&handler);
+	this->adopting.push_back(&handler);
+	this->Wake();
+}
+
+/**
+ * Take a connection back from the thread, so the game thread does its I/O again.
+ * This waits until the thread has stopped handling the connection. Packets queued
+ * for sending are moved to the send queue of the connection; received packets that
+ * have not been taken are dropped, as connections are only released when closing.
+ * @param handler The connection.
+ */
+void NetworkIOThread::Release(NetworkTCPSocketHandler &handler)
+{
+	assert(handler.io_thread == this);
+	NetworkTCPSocketHandler *h = &handler;
+
+	std::unique_lock<std::mutex> lock(this->mutex);
+	auto adopting = std::ranges::find(this->adopting, h);
+	if (adopting != this->adopting.end()) {
+		/* The thread did not start watching it yet. */
+		this->adopting.erase(adopting);
+	} else if (this->thread.joinable()) {
+		this->releasing.push_back(h);
+		this->Wake();
+		this->released.wait(lock, [this, h]() { return std::ranges::find(this->releasing, h) == this->releasing.end(); });
+	} else {
+		/* The thread is stopped, so its poller can be used here. */
+		this->poller.Unwatch(handler.sock);
+		handler.poller = nullptr;
+	}
+
+	auto node = this->connections.extract(h);
+	std::erase(this->pending, h);
+	std::erase(this->received, h);
+	lock.unlock();
+
+	std::ranges::replace(this->handling, h, nullptr);
+	handler.io_thread = nullptr;
+	handler.io_lost = false;
+
+	for (auto &p : node.mapped().send_queue) {
+		p->PrepareToSend();
+		handler.packet_queue.push_back(std::move(p));
+	}
+}
+
+/**
+ * Queue a packet to be prepared and sent by the thread.
+ * The thread is only woken up by #Flush, so many packets can be queued at once.
+ * @param handler The connection to send the packet over.
+ * @param packet The packet.
+ */
+void NetworkIOThread::QueuePacket(NetworkTCPSocketHandler &handler, std::unique_ptr<Packet> &&packet)
+{
+	std::lock_guard<std::mutex> lock(this->mutex);
+	this->connections.at(&handler).send_queue.push_back(std::move(packet));
+	if (std::ranges::find(this->pending, &handler) == this->pending.end()) this->pending.push_back(&handler);
+	this->wake = true;
+}
+
+/**
+ * Take the next packet received over a connection.
+ * @param handler The connection.
+ * @param[out] lost Whether the connection got lost, and all packets have been taken.
+ * @return The packet, or nullptr when there is none.
+ */
+std::unique_ptr<Packet> NetworkIOThread::TakePacket(NetworkTCPSocketHandler &handler, bool &lost)
+{
+	std::lock_guard<std::mutex> lock(this->mutex);
+	Connection &connection = this->connections.at(&handler);
+
+	lost = false;
+	if (connection.receive_queue.empty()) {
+		lost = connection.lost;
+		return nullptr;
+	}
+
+	std::unique_ptr<Packet> p = std::move(connection.receive_queue.front());
+	connection.receive_queue.pop_front();
+	connection.received_bytes -= p->Size();
+
+	/* Let the thread continue reading once there is enough room again. */
+	if (!connection.reading && connection.received_bytes < MAX_RECEIVED_BYTES / 2 && std::ranges::find(this->pending, &handler) == this->pending.end()) {
+		this->pending.push_back(&handler);
+		this->wake = true;
+	}
+	return p;
+}
+
+/**
+ * Wake up the thread when packets have been queued, or when it can read again.
+ */
+void NetworkIOThread::Flush()
+{
+	std::lock_guard<std::mutex> lock(this->mutex);
+	if (!this->wake) return;
+
+	this->wake = false;
+	this->Wake();
+}
+
+/**
+ * Keep the connections the game thread did not take all packets of in the list of
+ * connections with received packets, so they are handled again the next time.
+ */
+void NetworkIOThread::KeepUnhandled()
+{
+	std::lock_guard<std::mutex> lock(this->mutex);
+	for (NetworkTCPSocketHandler *h : this->handling) {
+		if (h == nullptr) continue;
+		const Connection &connection = this->connections.at(h);
+		if (connection.receive_queue.empty() && !connection.lost) continue;
+		if (std::ranges::find(this->received, h) == this->received.end()) this->received.push_back(h);
+	}
+	this->handling.clear();
+}
+
+/**
+ * Take the work the game thread has for the I/O thread: the connections to start and
+ * stop watching, and the packets to send. Also decide how much can be read for the
+ * connections to do I/O for. Only call this while holding the mutex.
+ * @param[in,out] transfers The I/O to do; on entry the connections whose sockets are ready.
+ */
+void NetworkIOThread::TakeWork(std::vector<Transfer> &transfers)
+{
+	auto get_transfer = [&transfers](NetworkTCPSocketHandler *h) -> Transfer & {
+		auto it = std::ranges::find(transfers, h, &Transfer::handler);
+		return it != transfers.end() ? *it : transfers.emplace_back(h);
+	};
+
+	if (!this->releasing.empty()) {
+		for (NetworkTCPSocketHandler *h : this->releasing) {
+			this->poller.Unwatch(h->sock);
+			h->poller = nullptr;
+			std::erase_if(transfers, [h](const Transfer &t) { return t.handler == h; });
+		}
+		this->releasing.clear();
+		this->released.notify_all();
+	}
+
+	/* Data of new connections might already be received, so do not wait for the socket. */
+	for (NetworkTCPSocketHandler *h : this->adopting) {
+		Transfer &t = get_transfer(h);
+		t.adopt = true;
+		t.read = true;
+	}
+	this->adopting.clear();
+
+	for (NetworkTCPSocketHandler *h : this->pending) get_transfer(h);
+	this->pending.clear();
+
+	for (Transfer &t : transfers) {
+		Connection &connection = this->connections.at(t.handler);
+		std::swap(t.send_queue, connection.send_queue);
+
+		if (!connection.reading && connection.received_bytes < MAX_RECEIVED_BYTES / 2) {
+			connection.reading = true;
+			t.read = true;
+		}
+		if (!connection.reading) t.read = false;
+		t.max_bytes = MAX_RECEIVED_BYTES - connection.received_bytes;
+	}
+}
+
+/**
+ * Prepare and send the packets, and read the packets that have arrived, until too much
+ * is waiting for the game thread. This is done without holding the mutex; only the
+ * I/O thread uses the socket and the transfer.
+ * @param transfer The I/O to do.
+ */
+void NetworkIOThread::DoTransfer(Transfer &transfer)
+{
+	NetworkTCPSocketHandler &handler = *transfer.handler;
+	if (transfer.adopt) handler.WatchSocket(this->poller);
+	if (transfer.writable) handler.writable = true;
+
+	if (!handler.io_lost) {
+		for (auto &p : transfer.send_queue) {
+			p->PrepareToSend();
+			handler.packet_queue.push_back(std::move(p));
+		}
+		if (handler.writable) handler.WritePackets(false);
+	}
+	transfer.send_queue.clear();
+
+	while (transfer.read && transfer.received_bytes < transfer.max_bytes && !handler.io_lost) {
+		std::unique_ptr<Packet> p = handler.ReadPacket();
+		if (p == nullptr) break;
+
+		transfer.received_bytes += p->Size();
+		transfer.receive_queue.push_back(std::move(p));
+	}
+}
+
+/**
+ * Hand the received packets, and whether the connection got lost, to the game thread.
+ * Only call this while holding the mutex.
+ * @param transfer The I/O that has been done.
+ */
+void NetworkIOThread::Publish(Transfer &transfer)
+{
+	NetworkTCPSocketHandler *h = transfer.handler;
+	Connection &connection = this->connections.at(h);
+
+	for (auto &p : transfer.receive_queue) connection.receive_queue.push_back(std::move(p));
+	connection.received_bytes += transfer.received_bytes;
+	if (connection.received_bytes >= MAX_RECEIVED_BYTES) connection.reading = false;
+	connection.lost = h->io_lost;
+	transfer.reading = connection.reading;
+
+	if (connection.receive_queue.empty() && !connection.lost) return;
+	if (std::ranges::find(this->received, h) == this->received.end()) this->received.push_back(h);
+}
+
+/**
+ * Watch the socket of a connection for what the thread is waiting for.
+ * Lost connections are not watched anymore.
+ * @param handler The connection.
+ * @param reading Whether to read from the socket.
+ */
+void NetworkIOThread::UpdateWatch(NetworkTCPSocketHandler &handler, bool reading)
+{
+	SocketEvents events{};
+	if (!handler.io_lost) {
+		if (reading) events.Set(SocketEvent::Read);
+		if (!handler.writable) events.Set(SocketEvent::Write);
+	}
+
+	if (events.None()) {
+		this->poller.Unwatch(handler.sock);
+	} else {
+		this->poller.Watch(handler.sock, events, &handler);
+	}
+}
+
+/**
+ * The main loop of the thread. The mutex is only held to move packets between the
+ * connections and the transfers; the socket I/O and the encryption are done without it.
+ */
+void NetworkIOThread::ThreadMain()
+{
+	std::vector<Transfer> transfers;
+	for (;;) {
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			if (this->stop) break;
+			this->TakeWork(transfers);
+		}
+
+		for (Transfer &t : transfers) this->DoTransfer(t);
+
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			for (Transfer &t : transfers) this->Publish(t);
+		}
+
+		for (const Transfer &t : transfers) this->UpdateWatch(*t.handler, t.reading);
+		transfers.clear();
+
+		/* Released connections are only unwatched by the I/O thread, so the ready ones are still valid. */
+		for (const ReadySocket &r : this->poller.Poll(MAX_WAIT)) {
+			if (r.events.None()) continue;
+
+			if (r.handler == nullptr) {
+				/* Woken up; the work is taken at the start of the loop. */
+				std::array<uint8_t, 64> buffer;
+				while (SocketReceiver{this->wake_socket}(buffer) > 0) {}
+				continue;
+			}
+
+			Transfer &t = transfers.emplace_back(r.handler);
+			t.writable = r.events.Test(SocketEvent::Write);
+			t.read = r.events.Test(SocketEvent::Read);
+		}
+	}
+}
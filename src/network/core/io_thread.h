@@ -0,0 +1,127 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/** @file io_thread.h Thread doing the socket I/O of TCP connections. */
+
+#ifndef NETWORK_CORE_IO_THREAD_H
+#define NETWORK_CORE_IO_THREAD_H
+
+#include "tcp.h"
+#include "poller.h"
+
+#include <condition_variable>
+#include <mutex>
+
+/**
+ * Thread doing the socket I/O of TCP connections that are handed over to it.
+ * It reads from the sockets, splits the data into packets and decrypts them, and it
+ * encrypts and sends the packets the game thread queued. The game thread only gets
+ * complete packets; handling them, and thus anything that changes the game state,
+ * stays on the game thread.
+ *
+ * After a connection is handed over, the game thread must only send packets, take
+ * received packets and close the connection; everything else about the socket belongs
+ * to the I/O thread until the connection is released again.
+ */
+class NetworkIOThread {
+	/** The state of a handed over connection that is shared by the game thread and the I/O thread. */
+	struct Connection {
+		std::vector<std::unique_ptr<Packet>> send_queue{}; ///< Packets queued by the game thread, not yet prepared for sending.
+		std::deque<std::unique_ptr<Packet>> receive_queue{}; ///< Received packets the game thread has not taken yet.
+		size_t received_bytes = 0; ///< Number of bytes in #receive_queue.
+		bool reading = true; ///< Whether the I/O thread reads from the socket; it stops when too much is waiting in #receive_queue.
+		bool lost = false; ///< Whether the connection got lost; the game thread closes it after taking all packets.
+	};
+
+	/**
+	 * The I/O the thread does for a connection in one go, without holding the mutex.
+	 * The packets are moved from and to the #Connection while holding the mutex.
+	 */
+	struct Transfer {
+		NetworkTCPSocketHandler *handler; ///< The connection.
+		bool adopt = false; ///< Whether the thread has to start watching the socket.
+		bool writable = false; ///< Whether the socket can be written to again.
+		bool read = false; ///< Whether to read from the socket.
+		bool reading = false; ///< Whether to keep watching the socket for reading afterwards.
+		size_t max_bytes = 0; ///< Number of bytes that may be read before the game thread has taken some.
+		size_t received_bytes = 0; ///< Number of bytes in #receive_queue.
+		std::vector<std::unique_ptr<Packet>> send_queue{}; ///< Packets to prepare and send.
+		std::vector<std::unique_ptr<Packet>> receive_queue{}; ///< Packets that have been received.
+
+		/**
+		 * Create the transfer of a connection.
+		 * @param handler The connection.
+		 */
+		Transfer(NetworkTCPSocketHandler *handler) : handler(handler) {}
+	};
+
+	static constexpr size_t MAX_RECEIVED_BYTES = 128 * 1024; ///< Stop reading from a socket when this many bytes wait for the game thread.
+	static constexpr std::chrono::milliseconds MAX_WAIT{1000}; ///< Longest time the thread waits for a socket, without being woken up.
+
+	std::thread thread{}; ///< The thread itself.
+	std::mutex mutex{}; ///< Guards everything that is shared by the game thread and the I/O thread.
+	std::condition_variable released{}; ///< Signalled when the I/O thread released connections.
+	SocketPoller poller{}; ///< Watches the sockets; only used by the I/O thread.
+	SOCKET wake_socket = INVALID_SOCKET; ///< Socket sending datagrams to itself, to wake up the I/O thread.
+	bool stop = false; ///< Whether the thread has to stop.
+	bool wake = false; ///< Whether the I/O thread has work to do from the game thread.
+
+	std::unordered_map<NetworkTCPSocketHandler *, Connection> connections{}; ///< The handed over connections.
+	std::vector<NetworkTCPSocketHandler *> adopting{}; ///< Connections that the I/O thread still has to start watching.
+	std::vector<NetworkTCPSocketHandler *> releasing{}; ///< Connections that the I/O thread has to stop watching.
+	std::vector<NetworkTCPSocketHandler *> pending{}; ///< Connections with packets to send, or with room to read again.
+	std::vector<NetworkTCPSocketHandler *> received{}; ///< Connections with received packets, or that got lost.
+	std::vector<NetworkTCPSocketHandler *> handling{}; ///< Connections whose packets the game thread is handling; only used by the game thread.
+
+	void ThreadMain();
+	void Wake();
+	void TakeWork(std::vector<Transfer> &transfers);
+	void DoTransfer(Transfer &transfer);
+	void Publish(Transfer &transfer);
+	void UpdateWatch(NetworkTCPSocketHandler &handler, bool reading);
+	void KeepUnhandled();
+
+public:
+	NetworkIOThread() = default;
+	~NetworkIOThread();
+	NetworkIOThread(const NetworkIOThread &) = delete;
+	NetworkIOThread &operator=(const NetworkIOThread &) = delete;
+
+	bool Start();
+	void Stop();
+
+	void Adopt(NetworkTCPSocketHandler &handler);
+	void Release(NetworkTCPSocketHandler &handler);
+
+	void QueuePacket(NetworkTCPSocketHandler &handler, std::unique_ptr<Packet> &&packet);
+	std::unique_ptr<Packet> TakePacket(NetworkTCPSocketHandler &handler, bool &lost);
+	void Flush();
+
+	/**
+	 * Let the game thread handle the packets the I/O thread received.
+	 * Connections that still have packets waiting afterwards are handled again the next time.
+	 * @param handle Function taking the packets of a connection.
+	 * @tparam F The type of the function.
+	 */
+	template <typename F>
+	void HandleReceived(F handle)
+	{
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			std::swap(this->received, this->handling);
+		}
+
+		/* Connections released while handling are set to nullptr. */
+		for (size_t i = 0; i < this->handling.size(); i++) {
+			if (this->handling[i] != nullptr) handle(this->handling[i]);
+		}
+
+		this->KeepUnhandled();
+	}
+};
+
+#endif /* NETWORK_CORE_IO_THREAD_H */
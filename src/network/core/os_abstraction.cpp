@@ -190,3 +190,38 @@ NetworkError GetSocketError(SOCKET d)
 
 	return NetworkError(err);
 }
+
+/**
+ * Write the data of several buffers to a socket with a single call.
+ * @param d The socket to write to.
+ * @param buffers The buffers to write, in order; at most 64.
+ * @return The number of bytes that were written, or -1 upon an error.
+ */
+ssize_t SendGathered(SOCKET d, std::span<const std::span<const uint8_t>> buffers)
+{
+	static constexpr size_t MAX_BUFFERS = 64;
+	assert(buffers.size() <= MAX_BUFFERS);
+
+#if defined(_WIN32)
+	std::array<WSABUF, MAX_BUFFERS> wsa_buffers;
+	for (size_t i = 0; i < buffers.size(); i++) {
+		wsa_buffers[i].buf = reinterpret_cast<char *>(const_cast<uint8_t *>(buffers[i].data()));
+		wsa_buffers[i].len = static_cast<ULONG>(buffers[i].size());
+	}
+
+	DWORD sent = 0;
+	if (WSASend(d, wsa_buffers.data(), static_cast<DWORD>(buffers.size()), &sent, 0, nullptr, nullptr) != 0) return -1;
+	return sent;
+#else
+	std::array<iovec, MAX_BUFFERS> iov;
+	for (size_t i = 0; i < buffers.size(); i++) {
+		iov[i].iov_base = const_cast<uint8_t *>(buffers[i].data());
+		iov[i].iov_len = buffers[i].size();
+	}
+
+	msghdr msg{};
+	msg.msg_iov = iov.data();
+	msg.msg_iovlen = buffers.size();
+	return sendmsg(d, &msg, 0);
+#endif
+}
@@ -132,6 +132,7 @@ bool SetNonBlocking(SOCKET d);
 bool SetNoDelay(SOCKET d);
 bool SetReusePort(SOCKET d);
 NetworkError GetSocketError(SOCKET d);
+ssize_t SendGathered(SOCKET d, std::span<const std::span<const uint8_t>> buffers);
 
 /* Make sure these structures have the size we expect them to be */
 static_assert(sizeof(in_addr)  ==  4); ///< IPv4 addresses should be 4 bytes.
@@ -57,12 +57,29 @@ Packet::Packet(NetworkSocketHandler *cs, PacketType type, size_t limit) : pos(0)
 	this->Send_uint8(type);
 }
 
+/**
+ * Creates a packet to send with the contents of a packet that is sent to many sockets.
+ * Without encryption the bytes of the shared packet are sent as they are. Otherwise
+ * #PrepareToSend encrypts them straight into this packet, so the shared packet stays untouched.
+ * @param cs     The socket handler associated with the socket we are writing to; could be \c nullptr.
+ * @param shared The packet to send; created without socket handler and prepared to be sent.
+ */
+Packet::Packet(NetworkSocketHandler *cs, std::shared_ptr<const Packet> shared) : pos(0), limit(shared->limit), cs(cs), shared(std::move(shared))
+{
+	assert(this->shared->cs == nullptr && this->shared->pos == 0 && this->shared->Size() > Packet::ENCODED_LENGTH_OF_PACKET_SIZE);
+}
+
 
 /**
  * Writes the packet size from the raw packet from packet->size
  */
 void Packet::PrepareToSend()
 {
+	if (this->shared != nullptr) {
+		this->PrepareSharedToSend();
+		return;
+	}
+
 	/* Prevent this to be called twice and for packets that have been received. */
 	assert(this->buffer[0] == 0 && this->buffer[1] == 0);
 
@@ -80,6 +97,28 @@ void Packet::PrepareToSend()
 	this->buffer.shrink_to_fit();
 }
 
+/**
+ * Prepare a packet with the contents of a shared packet to be sent.
+ * When encrypting, the shared bytes are encrypted into this packet's own buffer.
+ */
+void Packet::PrepareSharedToSend()
+{
+	if (cs == nullptr || cs->send_encryption_handler == nullptr) return;
+
+	size_t offset = Packet::ENCODED_LENGTH_OF_PACKET_SIZE;
+	size_t mac_size = cs->send_encryption_handler->MACSize();
+	size_t message_offset = offset + mac_size;
+	auto message = std::span(this->shared->buffer).subspan(offset);
+
+	this->buffer.resize(message_offset + message.size());
+	this->buffer[0] = GB(this->buffer.size(), 0, 8);
+	this->buffer[1] = GB(this->buffer.size(), 8, 8);
+	assert(this->buffer.size() <= this->limit);
+	cs->send_encryption_handler->Encrypt(std::span(&this->buffer[offset], mac_size), message, std::span(&this->buffer[message_offset], message.size()));
+
+	this->shared = nullptr;
+}
+
 /**
  * Is it safe to write to the packet, i.e. didn't we run over the buffer?
  * @param bytes_to_write The amount of bytes we want to try to write.
@@ -247,7 +286,7 @@ bool Packet::HasPacketSizeData() const
  */
 size_t Packet::Size() const
 {
-	return this->buffer.size();
+	return this->GetBuffer().size();
 }
 
 /**
@@ -67,9 +67,24 @@ private:
 	/** Socket we're associated with. */
 	NetworkSocketHandler *cs;
 
+	/** Packet shared with other sockets whose bytes are sent as they are, instead of the ones in #buffer. */
+	std::shared_ptr<const Packet> shared;
+
+	/**
+	 * Get the buffer with the bytes to send or the received bytes.
+	 * @return The buffer.
+	 */
+	const std::vector<uint8_t> &GetBuffer() const
+	{
+		return this->shared != nullptr ? this->shared->buffer : this->buffer;
+	}
+
+	void PrepareSharedToSend();
+
 public:
 	Packet(NetworkSocketHandler *cs, size_t limit, size_t initial_read_size = Packet::ENCODED_LENGTH_OF_PACKET_SIZE);
 	Packet(NetworkSocketHandler *cs, PacketType type, size_t limit = COMPAT_MTU);
+	Packet(NetworkSocketHandler *cs, std::shared_ptr<const Packet> shared);
 
 	/**
 	 * Creates a packet to send
@@ -117,6 +132,16 @@ public:
 
 	size_t RemainingBytesToTransfer() const;
 
+	/**
+	 * Get the bytes that still have to be transferred out, without transferring them.
+	 * Once they are transferred by other means, use #TransferOutWithLimit to move past them.
+	 * @return The bytes.
+	 */
+	std::span<const uint8_t> PeekBytesToTransferOut() const
+	{
+		return std::span<const uint8_t>(this->GetBuffer()).subspan(this->pos);
+	}
+
 	/**
 	 * Transfer data from the packet to the given function. It starts reading at the
 	 * position the last transfer stopped.
@@ -133,9 +158,10 @@ public:
 		size_t amount = std::min(this->RemainingBytesToTransfer(), limit);
 		if (amount == 0) return 0;
 
-		assert(this->pos < this->buffer.size());
-		assert(this->pos + amount <= this->buffer.size());
-		auto output_buffer = std::span<const uint8_t>(this->buffer.data() + this->pos, amount);
+		const std::vector<uint8_t> &buffer = this->GetBuffer();
+		assert(this->pos < buffer.size());
+		assert(this->pos + amount <= buffer.size());
+		auto output_buffer = std::span<const uint8_t>(buffer.data() + this->pos, amount);
 		ssize_t bytes = transfer_function(output_buffer);
 		if (bytes > 0) this->pos += bytes;
 		return bytes;
@@ -0,0 +1,257 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/** @file poller.cpp Implementation of waiting for many sockets at once. */
+
+#include "../../stdafx.h"
+#include "../../debug.h"
+#include "poller.h"
+
+#include "../../safeguards.h"
+
+/**
+ * Convert the events to watch for to the flags of poll().
+ * @param events The events.
+ * @return The flags.
+ */
+static short ToPollEvents(SocketEvents events)
+{
+	short flags = 0;
+	if (events.Test(SocketEvent::Read)) flags |= POLLIN;
+	if (events.Test(SocketEvent::Write)) flags |= POLLOUT;
+	return flags;
+}
+
+/**
+ * Convert the flags returned by poll() to events.
+ * @param flags The flags.
+ * @return The events.
+ */
+static SocketEvents FromPollEvents(short flags)
+{
+	SocketEvents events{};
+	if ((flags & (POLLIN | POLLERR | POLLHUP | POLLNVAL)) != 0) events.Set(SocketEvent::Read);
+	if ((flags & POLLOUT) != 0) events.Set(SocketEvent::Write);
+	return events;
+}
+
+/**
+ * Poll sockets.
+ * @param fds The sockets to poll.
+ * @param count The number of sockets.
+ * @param timeout The number of milliseconds to wait for a socket to become ready.
+ * @return The number of ready sockets, or -1 on failure.
+ */
+static int PollSockets(pollfd *fds, size_t count, int timeout = 0)
+{
+#if defined(_WIN32)
+	return WSAPoll(fds, static_cast<ULONG>(count), timeout);
+#else
+	return poll(fds, static_cast<nfds_t>(count), timeout);
+#endif
+}
+
+#ifdef WITH_EPOLL
+/**
+ * Convert the events to watch for to the flags of epoll.
+ * @param events The events.
+ * @return The flags.
+ */
+static uint32_t ToEpollEvents(SocketEvents events)
+{
+	uint32_t flags = 0;
+	if (events.Test(SocketEvent::Read)) flags |= EPOLLIN;
+	if (events.Test(SocketEvent::Write)) flags |= EPOLLOUT;
+	return flags;
+}
+
+/**
+ * Convert the flags returned by epoll to events.
+ * @param flags The flags.
+ * @return The events.
+ */
+static SocketEvents FromEpollEvents(uint32_t flags)
+{
+	SocketEvents events{};
+	if ((flags & (EPOLLIN | EPOLLERR | EPOLLHUP | EPOLLRDHUP)) != 0) events.Set(SocketEvent::Read);
+	if ((flags & EPOLLOUT) != 0) events.Set(SocketEvent::Write);
+	return events;
+}
+#endif /* WITH_EPOLL */
+
+/** Create the poller; when epoll is not available, poll() is used. */
+SocketPoller::SocketPoller()
+{
+#ifdef WITH_EPOLL
+	this->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	if (this->epoll_fd < 0) Debug(net, 0, "epoll_create1() failed, falling back to poll(): {}", NetworkError::GetLast().AsString());
+#endif
+}
+
+SocketPoller::~SocketPoller()
+{
+#ifdef WITH_EPOLL
+	if (this->epoll_fd >= 0) close(this->epoll_fd);
+#endif
+}
+
+/**
+ * Watch a socket for events, or change the events it is watched for.
+ * @param s The socket.
+ * @param events The events to watch for.
+ * @param handler The handler to report with the events of the socket.
+ */
+void SocketPoller::Watch(SOCKET s, SocketEvents events, NetworkTCPSocketHandler *handler)
+{
+	if (s == INVALID_SOCKET) return;
+
+	auto [it, inserted] = this->watched.try_emplace(s, Watched{handler, events, this->fds.size()});
+	if (inserted) {
+		this->fds.push_back({s, 0, 0});
+	} else {
+		it->second.handler = handler;
+		if (it->second.events == events) return;
+		it->second.events = events;
+	}
+	this->fds[it->second.index].events = ToPollEvents(events);
+
+#ifdef WITH_EPOLL
+	if (this->epoll_fd < 0) return;
+
+	epoll_event ev{};
+	ev.events = ToEpollEvents(events);
+	ev.data.fd = s;
+	if (epoll_ctl(this->epoll_fd, inserted ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, s, &ev) < 0) {
+		Debug(net, 0, "epoll_ctl() failed: {}", NetworkError::GetLast().AsString());
+	}
+#endif
+}
+
+/**
+ * Stop watching a socket. This must be done before the socket is closed.
+ * When called while handling the result of #Poll, the socket will be reported without events.
+ * @param s The socket.
+ */
+void SocketPoller::Unwatch(SOCKET s)
+{
+	auto it = this->watched.find(s);
+	if (it == this->watched.end()) return;
+
+	/* Move the last socket into the gap, so the sockets to poll stay contiguous. */
+	size_t index = it->second.index;
+	this->watched.erase(it);
+	if (index != this->fds.size() - 1) {
+		this->fds[index] = this->fds.back();
+		this->watched.find(this->fds[index].fd)->second.index = index;
+	}
+	this->fds.pop_back();
+
+#ifdef WITH_EPOLL
+	/* Kernels before 2.6.9 require an event, even though it is ignored. */
+	epoll_event ev{};
+	if (this->epoll_fd >= 0) epoll_ctl(this->epoll_fd, EPOLL_CTL_DEL, s, &ev);
+#endif
+
+	this->SetPending(s, false);
+	for (ReadySocket &ready : this->ready) {
+		if (ready.sock == s) ready.events = {};
+	}
+}
+
+/**
+ * Set whether a watched socket has received data that is buffered outside of the OS.
+ * Such a socket is reported as readable, even when the OS has no data for it.
+ * @param s The socket.
+ * @param pending Whether there is pending data.
+ */
+void SocketPoller::SetPending(SOCKET s, bool pending)
+{
+	auto it = std::ranges::find(this->pending, s);
+	if (pending == (it != this->pending.end())) return;
+
+	if (pending) {
+		this->pending.push_back(s);
+	} else {
+		*it = this->pending.back();
+		this->pending.pop_back();
+	}
+}
+
+/**
+ * Report the sockets with pending data as readable.
+ */
+void SocketPoller::AddPending()
+{
+	for (SOCKET s : this->pending) {
+		auto watched = this->watched.find(s);
+		if (watched == this->watched.end()) continue;
+
+		auto it = std::ranges::find(this->ready, s, &ReadySocket::sock);
+		if (it != this->ready.end()) {
+			it->events.Set(SocketEvent::Read);
+		} else {
+			this->ready.push_back({s, watched->second.handler, SocketEvent::Read});
+		}
+	}
+}
+
+/**
+ * Find the watched sockets that are ready.
+ * @param timeout How long to wait for a socket to become ready; sockets with pending data do not wait.
+ * @return The ready sockets; valid until the next call.
+ */
+std::span<const ReadySocket> SocketPoller::Poll(std::chrono::milliseconds timeout)
+{
+	this->ready.clear();
+	if (this->watched.empty()) return {};
+	int wait = this->pending.empty() ? static_cast<int>(timeout.count()) : 0;
+
+#ifdef WITH_EPOLL
+	if (this->epoll_fd >= 0) {
+		this->events.resize(this->watched.size());
+		int n = epoll_wait(this->epoll_fd, this->events.data(), static_cast<int>(this->events.size()), wait);
+		if (n < 0) {
+			if (errno != EINTR) Debug(net, 0, "epoll_wait() failed: {}", NetworkError::GetLast().AsString());
+			return {};
+		}
+
+		for (const epoll_event &ev : std::span(this->events.data(), n)) {
+			auto it = this->watched.find(ev.data.fd);
+			if (it == this->watched.end()) continue;
+			this->ready.push_back({ev.data.fd, it->second.handler, FromEpollEvents(ev.events)});
+		}
+		this->AddPending();
+		return this->ready;
+	}
+#endif
+
+	if (PollSockets(this->fds.data(), this->fds.size(), wait) < 0) {
+		if (errno == EINTR) return {};
+		Debug(net, 0, "poll() failed: {}", NetworkError::GetLast().AsString());
+		return {};
+	}
+
+	for (const pollfd &fd : this->fds) {
+		if (fd.revents == 0) continue;
+		this->ready.push_back({fd.fd, this->watched.find(fd.fd)->second.handler, FromPollEvents(fd.revents)});
+	}
+	this->AddPending();
+	return this->ready;
+}
+
+/**
+ * Check a single socket for events, without waiting.
+ * @param s The socket.
+ * @param events The events to check for.
+ * @return The events the socket is ready for.
+ */
+/* static */ SocketEvents SocketPoller::Check(SOCKET s, SocketEvents events)
+{
+	pollfd fd{s, ToPollEvents(events), 0};
+	if (PollSockets(&fd, 1) <= 0) return {};
+	return FromPollEvents(fd.revents);
+}
@@ -0,0 +1,81 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/** @file poller.h Waiting for many sockets at once to become readable or writable. */
+
+#ifndef NETWORK_CORE_POLLER_H
+#define NETWORK_CORE_POLLER_H
+
+#include "os_abstraction.h"
+#include "../../core/enum_type.hpp"
+
+#include <chrono>
+
+#if !defined(_WIN32)
+#	include <poll.h>
+#endif
+#if defined(__linux__) && !defined(__EMSCRIPTEN__)
+#	define WITH_EPOLL
+#	include <sys/epoll.h>
+#endif
+
+class NetworkTCPSocketHandler;
+
+/** Events a socket can be watched for. */
+enum class SocketEvent : uint8_t {
+	Read, ///< Data can be received or a connection can be accepted. Errors and hang-ups are reported as this too.
+	Write, ///< Data can be sent.
+};
+/** Bitset of #SocketEvent elements. */
+using SocketEvents = EnumBitSet<SocketEvent, uint8_t>;
+
+/** A socket that is ready for some of the events it is watched for. */
+struct ReadySocket {
+	SOCKET sock; ///< The socket.
+	NetworkTCPSocketHandler *handler; ///< The handler given when watching the socket.
+	SocketEvents events; ///< The events the socket is ready for; empty when the socket was unwatched after polling.
+};
+
+/**
+ * Watches many sockets at once, so only the sockets that are ready have to be handled.
+ * On Linux this uses epoll, so polling costs depend on the number of ready sockets only.
+ * Elsewhere it falls back to poll(); unlike select() neither is limited to FD_SETSIZE sockets.
+ */
+class SocketPoller {
+	/** What a socket is watched for. */
+	struct Watched {
+		NetworkTCPSocketHandler *handler; ///< The handler to report with the events.
+		SocketEvents events; ///< The events to watch for.
+		size_t index; ///< Index into #fds.
+	};
+
+	std::unordered_map<SOCKET, Watched> watched{}; ///< The watched sockets.
+	std::vector<ReadySocket> ready{}; ///< The sockets that were ready during the last poll.
+	std::vector<SOCKET> pending{}; ///< Watched sockets with received data outside of the OS; they are always readable.
+	std::vector<pollfd> fds{}; ///< The watched sockets, in the form poll() wants them; used when epoll is not available.
+#ifdef WITH_EPOLL
+	int epoll_fd = -1; ///< The epoll instance, or -1 when poll() is used instead.
+	std::vector<epoll_event> events{}; ///< Buffer for the events returned by epoll.
+#endif
+
+	void AddPending();
+
+public:
+	SocketPoller();
+	~SocketPoller();
+	SocketPoller(const SocketPoller &) = delete;
+	SocketPoller &operator=(const SocketPoller &) = delete;
+
+	void Watch(SOCKET s, SocketEvents events, NetworkTCPSocketHandler *handler = nullptr);
+	void Unwatch(SOCKET s);
+	void SetPending(SOCKET s, bool pending);
+	std::span<const ReadySocket> Poll(std::chrono::milliseconds timeout = {});
+
+	static SocketEvents Check(SOCKET s, SocketEvents events);
+};
+
+#endif /* NETWORK_CORE_POLLER_H */
@@ -11,6 +11,7 @@
 #include "../../debug.h"
 
 #include "tcp.h"
+#include "io_thread.h"
 
 #include "../../safeguards.h"
 
@@ -27,7 +28,11 @@ NetworkTCPSocketHandler::~NetworkTCPSocketHandler()
  */
 void NetworkTCPSocketHandler::CloseSocket()
 {
-	if (this->sock != INVALID_SOCKET) closesocket(this->sock);
+	if (this->io_thread != nullptr) this->io_thread->Release(*this);
+	if (this->sock == INVALID_SOCKET) return;
+
+	if (this->poller != nullptr) this->poller->Unwatch(this->sock);
+	closesocket(this->sock);
 	this->sock = INVALID_SOCKET;
 }
 
@@ -39,11 +44,15 @@ void NetworkTCPSocketHandler::CloseSocket()
  */
 NetworkRecvStatus NetworkTCPSocketHandler::CloseConnection([[maybe_unused]] bool error)
 {
+	if (this->io_thread != nullptr) this->io_thread->Release(*this);
+
 	this->MarkClosed();
 	this->writable = false;
 
 	this->packet_queue.clear();
 	this->packet_recv = nullptr;
+	this->receive_buffer = {};
+	this->receive_buffer_pos = this->receive_buffer_end = 0;
 
 	return NETWORK_RECV_STATUS_OKAY;
 }
@@ -58,52 +67,114 @@ void NetworkTCPSocketHandler::SendPacket(std::unique_ptr<Packet> &&packet)
 {
 	assert(packet != nullptr);
 
+	if (this->io_thread != nullptr) {
+		this->io_thread->QueuePacket(*this, std::move(packet));
+		return;
+	}
+
 	packet->PrepareToSend();
 	this->packet_queue.push_back(std::move(packet));
 }
 
+/**
+ * Put a packet that is sent to many sockets in the send-queue.
+ * Only the encryption, if any, is done for this socket; the contents are shared.
+ * @param packet The packet to send; created without socket handler and prepared to be sent.
+ */
+void NetworkTCPSocketHandler::SendPacket(std::shared_ptr<const Packet> packet)
+{
+	assert(packet != nullptr);
+
+	this->SendPacket(std::make_unique<Packet>(this, std::move(packet)));
+}
+
+/**
+ * Mark the socket as not writable, as the network buffer of the OS is full.
+ * When a poller watches the socket, it reports when the socket can be written to again.
+ */
+void NetworkTCPSocketHandler::WaitUntilWritable()
+{
+	this->writable = false;
+	if (this->poller != nullptr) this->poller->Watch(this->sock, {SocketEvent::Read, SocketEvent::Write}, this);
+}
+
 /**
  * Sends all the buffered packets out for this client. It stops when:
  *   1) all packets are send (queue is empty)
  *   2) the OS reports back that it can not send any more
  *      data right now (full network-buffer, it happens ;))
  *   3) sending took too long
+ * The data of many packets is handed to the OS with a single call.
+ * When an I/O thread handles this socket, it is only told to send the packets,
+ * unless the connection is closing down; then the socket is taken back from it.
  * @param closing_down Whether we are closing down the connection.
  * @return \c true if a (part of a) packet could be sent and
  *         the connection is not closed yet.
  */
 SendPacketsState NetworkTCPSocketHandler::SendPackets(bool closing_down)
+{
+	if (this->io_thread != nullptr) {
+		if (!closing_down) {
+			this->io_thread->Flush();
+			return SPS_ALL_SENT;
+		}
+		this->io_thread->Release(*this);
+	}
+
+	return this->WritePackets(closing_down);
+}
+
+/**
+ * Write the buffered packets to the socket.
+ * @param closing_down Whether we are closing down the connection.
+ * @return The state of sending the packets.
+ */
+SendPacketsState NetworkTCPSocketHandler::WritePackets(bool closing_down)
 {
 	/* We can not write to this socket!! */
 	if (!this->writable) return SPS_NONE_SENT;
 	if (!this->IsConnected()) return SPS_CLOSED;
 
 	while (!this->packet_queue.empty()) {
-		Packet &p = *this->packet_queue.front();
-		ssize_t res = p.TransferOut(SocketSender{this->sock});
+		std::array<std::span<const uint8_t>, MAX_PACKETS_PER_SEND> buffers;
+		size_t count = 0;
+		size_t to_send = 0;
+		for (auto it = this->packet_queue.begin(); it != this->packet_queue.end() && count < buffers.size(); ++it) {
+			buffers[count] = (*it)->PeekBytesToTransferOut();
+			to_send += buffers[count].size();
+			count++;
+		}
+
+		ssize_t res = SendGathered(this->sock, std::span(buffers.data(), count));
 		if (res == -1) {
 			NetworkError err = NetworkError::GetLast();
 			if (!err.WouldBlock()) {
 				/* Something went wrong.. close client! */
 				if (!closing_down) {
 					Debug(net, 0, "Send failed: {}", err.AsString());
-					this->CloseConnection();
+					this->CloseConnectionAfterError();
 				}
 				return SPS_CLOSED;
 			}
+			this->WaitUntilWritable();
 			return SPS_PARTLY_SENT;
 		}
 		if (res == 0) {
 			/* Client/server has left us :( */
-			if (!closing_down) this->CloseConnection();
+			if (!closing_down) this->CloseConnectionAfterError();
 			return SPS_CLOSED;
 		}
 
-		/* Is this packet sent? */
-		if (p.RemainingBytesToTransfer() == 0) {
-			/* Go to the next packet */
-			this->packet_queue.pop_front();
-		} else {
+		/* Move past the sent data; the packets that are sent completely go. */
+		for (size_t sent = res; sent > 0;) {
+			Packet &p = *this->packet_queue.front();
+			sent -= p.TransferOutWithLimit([](std::span<const uint8_t> buffer) { return static_cast<ssize_t>(buffer.size()); }, sent);
+			if (p.RemainingBytesToTransfer() == 0) this->packet_queue.pop_front();
+		}
+
+		/* Not everything could be sent, so the network buffer is full. */
+		if (static_cast<size_t>(res) < to_send) {
+			this->WaitUntilWritable();
 			return SPS_PARTLY_SENT;
 		}
 	}
@@ -111,14 +182,87 @@ SendPacketsState NetworkTCPSocketHandler::SendPackets(bool closing_down)
 	return SPS_ALL_SENT;
 }
 
+/**
+ * Transfer received data into a packet, until the packet has all the data it asks for.
+ * Data is read from the socket in large chunks, which may hold several packets.
+ * @param p The packet to fill.
+ * @return \c true when the packet is filled, \c false when more data has to arrive first or the connection got closed.
+ */
+bool NetworkTCPSocketHandler::FillPacket(Packet &p)
+{
+	while (p.RemainingBytesToTransfer() != 0) {
+		if (!this->HasReceivedData()) {
+			if (this->poller != nullptr) this->poller->SetPending(this->sock, false);
+
+			this->receive_buffer.resize(RECEIVE_BUFFER_SIZE);
+			size_t to_read = this->read_exactly ? std::min(p.RemainingBytesToTransfer(), RECEIVE_BUFFER_SIZE) : RECEIVE_BUFFER_SIZE;
+			ssize_t res = SocketReceiver{this->sock}(std::span(this->receive_buffer).first(to_read));
+			if (res == -1) {
+				NetworkError err = NetworkError::GetLast();
+				if (!err.WouldBlock()) {
+					/* Something went wrong... */
+					if (!err.IsConnectionReset()) Debug(net, 0, "Recv failed: {}", err.AsString());
+					this->CloseConnectionAfterError();
+					return false;
+				}
+				/* Connection would block, so stop for now */
+				return false;
+			}
+			if (res == 0) {
+				/* Client/server has left */
+				this->CloseConnectionAfterError();
+				return false;
+			}
+			this->receive_buffer_pos = 0;
+			this->receive_buffer_end = res;
+		}
+
+		p.TransferIn([this](std::span<uint8_t> buffer) {
+			size_t amount = std::min(buffer.size(), this->receive_buffer_end - this->receive_buffer_pos);
+			std::copy_n(this->receive_buffer.data() + this->receive_buffer_pos, amount, buffer.data());
+			this->receive_buffer_pos += amount;
+			return static_cast<ssize_t>(amount);
+		});
+	}
+
+	/* Make sure the rest of the data is handled, even when the OS has nothing more for us. */
+	if (this->poller != nullptr) this->poller->SetPending(this->sock, this->HasReceivedData());
+	return true;
+}
+
+/**
+ * Close the connection after sending or receiving failed.
+ * An I/O thread leaves that to the game thread, which notices when it takes the received packets.
+ */
+void NetworkTCPSocketHandler::CloseConnectionAfterError()
+{
+	if (this->io_thread != nullptr) {
+		this->io_lost = true;
+		return;
+	}
+	this->CloseConnection();
+}
+
 /**
  * Receives a packet for the given client
  * @return The received packet (or nullptr when it didn't receive one)
  */
 std::unique_ptr<Packet> NetworkTCPSocketHandler::ReceivePacket()
 {
-	ssize_t res;
+	if (this->io_thread == nullptr) return this->ReadPacket();
 
+	bool lost;
+	std::unique_ptr<Packet> p = this->io_thread->TakePacket(*this, lost);
+	if (lost) this->CloseConnection();
+	return p;
+}
+
+/**
+ * Read a packet from the socket.
+ * @return The read packet, or nullptr when there is no complete packet yet or the connection got closed.
+ */
+std::unique_ptr<Packet> NetworkTCPSocketHandler::ReadPacket()
+{
 	if (!this->IsConnected()) return nullptr;
 
 	if (this->packet_recv == nullptr) {
@@ -129,57 +273,21 @@ std::unique_ptr<Packet> NetworkTCPSocketHandler::ReceivePacket()
 
 	/* Read packet size */
 	if (!p.HasPacketSizeData()) {
-		while (p.RemainingBytesToTransfer() != 0) {
-			res = p.TransferIn(SocketReceiver{this->sock});
-			if (res == -1) {
-				NetworkError err = NetworkError::GetLast();
-				if (!err.WouldBlock()) {
-					/* Something went wrong... */
-					if (!err.IsConnectionReset()) Debug(net, 0, "Recv failed: {}", err.AsString());
-					this->CloseConnection();
-					return nullptr;
-				}
-				/* Connection would block, so stop for now */
-				return nullptr;
-			}
-			if (res == 0) {
-				/* Client/server has left */
-				this->CloseConnection();
-				return nullptr;
-			}
-		}
+		if (!this->FillPacket(p)) return nullptr;
 
 		/* Parse the size in the received packet and if not valid, close the connection. */
 		if (!p.ParsePacketSize()) {
-			this->CloseConnection();
+			this->CloseConnectionAfterError();
 			return nullptr;
 		}
 	}
 
 	/* Read rest of packet */
-	while (p.RemainingBytesToTransfer() != 0) {
-		res = p.TransferIn(SocketReceiver{this->sock});
-		if (res == -1) {
-			NetworkError err = NetworkError::GetLast();
-			if (!err.WouldBlock()) {
-				/* Something went wrong... */
-				if (!err.IsConnectionReset()) Debug(net, 0, "Recv failed: {}", err.AsString());
-				this->CloseConnection();
-				return nullptr;
-			}
-			/* Connection would block */
-			return nullptr;
-		}
-		if (res == 0) {
-			/* Client/server has left */
-			this->CloseConnection();
-			return nullptr;
-		}
-	}
+	if (!this->FillPacket(p)) return nullptr;
 
 	if (!p.PrepareToRead()) {
 		Debug(net, 0, "Invalid packet received (too small / decryption error)");
-		this->CloseConnection();
+		this->CloseConnectionAfterError();
 		return nullptr;
 	}
 	return std::move(this->packet_recv);
@@ -187,25 +295,28 @@ std::unique_ptr<Packet> NetworkTCPSocketHandler::ReceivePacket()
 
 /**
  * Check whether this socket can send or receive something.
- * @return \c true when there is something to receive.
+ * @return \c true when there is something to receive, or data that has been received but not handled yet.
  * @note Sets #writable if more data can be sent.
  */
 bool NetworkTCPSocketHandler::CanSendReceive()
 {
 	assert(this->sock != INVALID_SOCKET);
+	assert(this->poller == nullptr);
 
-	fd_set read_fd, write_fd;
-	struct timeval tv;
-
-	FD_ZERO(&read_fd);
-	FD_ZERO(&write_fd);
+	SocketEvents events = SocketPoller::Check(this->sock, {SocketEvent::Read, SocketEvent::Write});
 
-	FD_SET(this->sock, &read_fd);
-	FD_SET(this->sock, &write_fd);
-
-	tv.tv_sec = tv.tv_usec = 0; // don't block at all.
-	if (select(FD_SETSIZE, &read_fd, &write_fd, nullptr, &tv) < 0) return false;
+	this->writable = events.Test(SocketEvent::Write);
+	return events.Test(SocketEvent::Read) || this->HasReceivedData();
+}
 
-	this->writable = !!FD_ISSET(this->sock, &write_fd);
-	return FD_ISSET(this->sock, &read_fd) != 0;
+/**
+ * Let a poller watch this socket, instead of checking it with #CanSendReceive.
+ * The socket is watched for incoming data, and for becoming writable only after sending had to stop.
+ * @param poller The poller.
+ */
+void NetworkTCPSocketHandler::WatchSocket(SocketPoller &poller)
+{
+	this->poller = &poller;
+	this->writable = true;
+	poller.Watch(this->sock, SocketEvent::Read, this);
 }
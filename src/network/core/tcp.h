@@ -12,11 +12,14 @@
 
 #include "address.h"
 #include "packet.h"
+#include "poller.h"
 
 #include <atomic>
 #include <chrono>
 #include <thread>
 
+class NetworkIOThread;
+
 /** The states of sending the packets. */
 enum SendPacketsState : uint8_t {
 	SPS_CLOSED,      ///< The connection got closed.
@@ -30,10 +33,31 @@ class NetworkTCPSocketHandler : public NetworkSocketHandler {
 private:
 	std::deque<std::unique_ptr<Packet>> packet_queue{}; ///< Packets that are awaiting delivery. Cannot be std::queue as that does not have a clear() function.
 	std::unique_ptr<Packet> packet_recv = nullptr; ///< Partially received packet
+	std::vector<uint8_t> receive_buffer{}; ///< Data read from the socket in one go, to be split into packets.
+	size_t receive_buffer_pos = 0; ///< Position of the first byte in #receive_buffer that is not in a packet yet.
+	size_t receive_buffer_end = 0; ///< End of the data in #receive_buffer.
+
+	static constexpr size_t MAX_PACKETS_PER_SEND = 64; ///< Maximum number of packets handed to the OS in one call.
+	static constexpr size_t RECEIVE_BUFFER_SIZE = 32768; ///< Number of bytes read from the socket in one go.
+
+	NetworkIOThread *io_thread = nullptr; ///< The thread doing the I/O of this socket, or \c nullptr when the game thread does it.
+	bool io_lost = false; ///< Whether the I/O thread found the connection to be lost; only used by the I/O thread.
+
+	void WaitUntilWritable();
+	bool FillPacket(Packet &p);
+	std::unique_ptr<Packet> ReadPacket();
+	SendPacketsState WritePackets(bool closing_down);
+	void CloseConnectionAfterError();
+
+	friend class NetworkIOThread;
+
+protected:
+	bool read_exactly = false; ///< Whether to read only the data of the packet being received, as the socket is handed over to another handler later.
 
 public:
 	SOCKET sock = INVALID_SOCKET; ///< The socket currently connected to
 	bool writable = false; ///< Can we write to this socket?
+	SocketPoller *poller = nullptr; ///< The poller watching this socket, or \c nullptr when #CanSendReceive is used instead.
 
 	/**
 	 * Whether this socket is currently bound to a socket.
@@ -45,11 +69,13 @@ public:
 	void CloseSocket();
 
 	virtual void SendPacket(std::unique_ptr<Packet> &&packet);
+	void SendPacket(std::shared_ptr<const Packet> packet);
 	SendPacketsState SendPackets(bool closing_down = false);
 
 	virtual std::unique_ptr<Packet> ReceivePacket();
 
 	bool CanSendReceive();
+	void WatchSocket(SocketPoller &poller);
 
 	/**
 	 * Whether there is something pending in the send queue.
@@ -57,6 +83,18 @@ public:
 	 */
 	bool HasSendQueue() { return !this->packet_queue.empty(); }
 
+	/**
+	 * Whether an I/O thread does the sending and receiving for this socket.
+	 * @return true when an I/O thread handles this socket.
+	 */
+	bool HasIOThread() const { return this->io_thread != nullptr; }
+
+	/**
+	 * Whether data has been read from the socket that has not been handled yet.
+	 * @return true when there is unhandled data.
+	 */
+	bool HasReceivedData() const { return this->receive_buffer_pos != this->receive_buffer_end; }
+
 	/**
 	 * Construct a socket handler for a TCP connection.
 	 * @param s The just opened TCP connection.
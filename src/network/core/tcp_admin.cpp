@@ -78,6 +78,7 @@ NetworkRecvStatus NetworkAdminSocketHandler::HandlePacket(Packet &p)
 		case PacketAdminType::ServerPong: return this->ReceiveServerPong(p);
 		case PacketAdminType::ServerAuthenticationRequest: return this->ReceiveServerAuthenticationRequest(p);
 		case PacketAdminType::ServerEnableEncryption: return this->ReceiveServerEnableEncryption(p);
+		case PacketAdminType::ServerPerformance: return this->ReceiveServerPerformance(p);
 
 		default:
 			Debug(net, 0, "[tcp/admin] Received invalid packet type {} from '{}' ({})", type, this->admin_name, this->admin_version);
@@ -156,3 +157,4 @@ NetworkRecvStatus NetworkAdminSocketHandler::ReceiveServerRemoteConsoleCommandEn
 NetworkRecvStatus NetworkAdminSocketHandler::ReceiveServerPong(Packet &) { return this->ReceiveInvalidPacket(PacketAdminType::ServerPong); }
 NetworkRecvStatus NetworkAdminSocketHandler::ReceiveServerAuthenticationRequest(Packet &) { return this->ReceiveInvalidPacket(PacketAdminType::ServerAuthenticationRequest); }
 NetworkRecvStatus NetworkAdminSocketHandler::ReceiveServerEnableEncryption(Packet &) { return this->ReceiveInvalidPacket(PacketAdminType::ServerEnableEncryption); }
+NetworkRecvStatus NetworkAdminSocketHandler::ReceiveServerPerformance(Packet &) { return this->ReceiveInvalidPacket(PacketAdminType::ServerPerformance); }
@@ -63,6 +63,7 @@ enum class PacketAdminType : uint8_t {
 	ServerCommandLogging, ///< The server gives the admin copies of incoming command packets.
 	ServerAuthenticationRequest, ///< The server gives the admin the used authentication method and required parameters.
 	ServerEnableEncryption, ///< The server tells that authentication has completed and requests to enable encryption with the keys of the last \c PacketAdminType::AdminAuthenticationResponse.
+	ServerPerformance, ///< The server gives the admin the performance statistics of the game loop and drawing.
 };
 /** Mark PacketAdminType as a PacketType. */
 template <> struct IsEnumPacketType<PacketAdminType> {
@@ -89,6 +90,7 @@ enum AdminUpdateType : uint8_t {
 	ADMIN_UPDATE_CMD_NAMES,       ///< The admin would like a list of all DoCommand names.
 	ADMIN_UPDATE_CMD_LOGGING,     ///< The admin would like to have DoCommand information.
 	ADMIN_UPDATE_GAMESCRIPT,      ///< The admin would like to have gamescript messages.
+	ADMIN_UPDATE_PERFORMANCE,     ///< The admin would like to have performance statistics.
 	ADMIN_UPDATE_END,             ///< Must ALWAYS be on the end of this list!! (period)
 };
 
@@ -523,6 +525,24 @@ protected:
 	 */
 	virtual NetworkRecvStatus ReceiveServerEnableEncryption(Packet &p);
 
+	/**
+	 * Send the performance statistics of the recent game loops and frames; timings are in microseconds.
+	 * Multiple of these packets can follow each other.
+	 * For each element with measurements:
+	 *   bool     Data to follow.
+	 *   uint8_t  ID of the performance element.
+	 *   string   Name of the performance element.
+	 *   uint16_t Number of measurements the statistics are based on.
+	 *   uint32_t Mean time.
+	 *   uint32_t Median time.
+	 *   uint32_t 99th percentile time.
+	 *   uint32_t Maximum time.
+	 * bool      No more data in this packet.
+	 * @param p The packet that was just received.
+	 * @return The state the network should have.
+	 */
+	virtual NetworkRecvStatus ReceiveServerPerformance(Packet &p);
+
 	/**
 	 * Send a ping-reply (pong) to the admin that sent us the ping packet.
 	 * uint32_t  Integer identifier - should be the same as read from the admins ping packet.
@@ -562,7 +562,7 @@ public:
 	NetworkRecvStatus ReceivePackets();
 
 	std::optional<std::string_view> ReceiveCommand(Packet &p, CommandPacket &cp);
-	void SendCommand(Packet &p, const CommandPacket &cp);
+	static void SendCommand(Packet &p, const CommandPacket &cp);
 
 	/**
 	 * Is this pending for deletion and as such should not be accessed anymore.
@@ -11,6 +11,7 @@
 #define NETWORK_CORE_TCP_LISTEN_H
 
 #include "tcp.h"
+#include "io_thread.h"
 #include "../network.h"
 #include "../network_func.h"
 #include "../network_internal.h"
@@ -29,6 +30,10 @@ template <class Tsocket, typename EnumPacketType, EnumPacketType Tfull_packet, E
 class TCPListenHandler {
 	/** List of sockets we listen on. */
 	static SocketList sockets;
+	/** Watches the sockets we listen on and the sockets of the connections. */
+	static SocketPoller poller;
+	/** Does the socket I/O of the connections handed over to it. */
+	static NetworkIOThread io_thread;
 
 public:
 	/**
@@ -100,44 +105,52 @@ public:
 		}
 	}
 
+	/**
+	 * Start watching the socket of a new connection.
+	 * @param cs The new connection.
+	 */
+	static void WatchConnection(Tsocket *cs)
+	{
+		cs->WatchSocket(poller);
+	}
+
+	/**
+	 * Let the I/O thread do the socket I/O of a connection from now on.
+	 * When the thread can not be started, the game thread keeps doing it.
+	 * @param cs The connection.
+	 */
+	static void HandOverToIOThread(Tsocket *cs)
+	{
+		if (io_thread.Start()) io_thread.Adopt(*cs);
+	}
+
 	/**
 	 * Handle the receiving of packets.
+	 * Only the sockets that have something to accept or receive, or that became writable again, are handled.
 	 * @return true if everything went okay.
 	 */
 	static bool Receive()
 	{
-		fd_set read_fd, write_fd;
-		struct timeval tv;
-
-		FD_ZERO(&read_fd);
-		FD_ZERO(&write_fd);
-
+		for (const ReadySocket &ready : poller.Poll()) {
+			if (ready.events.None()) continue;
 
-		for (Tsocket *cs : Tsocket::Iterate()) {
-			FD_SET(cs->sock, &read_fd);
-			FD_SET(cs->sock, &write_fd);
-		}
-
-		/* take care of listener port */
-		for (auto &s : sockets) {
-			FD_SET(s.first, &read_fd);
-		}
-
-		tv.tv_sec = tv.tv_usec = 0; // don't block at all.
-		if (select(FD_SETSIZE, &read_fd, &write_fd, nullptr, &tv) < 0) return false;
-
-		/* accept clients.. */
-		for (auto &s : sockets) {
-			if (FD_ISSET(s.first, &read_fd)) AcceptClient(s.first);
-		}
+			/* take care of listener port */
+			if (ready.handler == nullptr) {
+				AcceptClient(ready.sock);
+				continue;
+			}
 
-		/* read stuff from clients */
-		for (Tsocket *cs : Tsocket::Iterate()) {
-			cs->writable = !!FD_ISSET(cs->sock, &write_fd);
-			if (FD_ISSET(cs->sock, &read_fd)) {
-				cs->ReceivePackets();
+			Tsocket *cs = static_cast<Tsocket *>(ready.handler);
+			if (ready.events.Test(SocketEvent::Write)) {
+				cs->writable = true;
+				poller.Watch(cs->sock, SocketEvent::Read, cs);
 			}
+			/* read stuff from clients */
+			if (ready.events.Test(SocketEvent::Read)) cs->ReceivePackets();
 		}
+
+		/* handle what the I/O thread received */
+		io_thread.HandleReceived([](NetworkTCPSocketHandler *handler) { static_cast<Tsocket *>(handler)->ReceivePackets(); });
 		return _networking;
 	}
 
@@ -156,6 +169,9 @@ public:
 		for (NetworkAddress &address : addresses) {
 			address.Listen(SOCK_STREAM, &sockets);
 		}
+		for (auto &s : sockets) {
+			poller.Watch(s.first, SocketEvent::Read);
+		}
 
 		if (sockets.empty()) {
 			Debug(net, 0, "Could not start network: could not create listening socket");
@@ -170,14 +186,20 @@ public:
 	static void CloseListeners()
 	{
 		for (auto &s : sockets) {
+			poller.Unwatch(s.first);
 			closesocket(s.first);
 		}
 		sockets.clear();
+		io_thread.Stop();
 		Debug(net, 5, "[{}] Closed listeners", Tsocket::GetName());
 	}
 };
 
 /** Instantiate the sockets. */
 template <class Tsocket, typename EnumPacketType, EnumPacketType Tfull_packet, EnumPacketType Tban_packet> SocketList TCPListenHandler<Tsocket, EnumPacketType, Tfull_packet, Tban_packet>::sockets;
+/** Instantiate the poller. */
+template <class Tsocket, typename EnumPacketType, EnumPacketType Tfull_packet, EnumPacketType Tban_packet> SocketPoller TCPListenHandler<Tsocket, EnumPacketType, Tfull_packet, Tban_packet>::poller;
+/** Instantiate the I/O thread. */
+template <class Tsocket, typename EnumPacketType, EnumPacketType Tfull_packet, EnumPacketType Tban_packet> NetworkIOThread TCPListenHandler<Tsocket, EnumPacketType, Tfull_packet, Tban_packet>::io_thread;
 
 #endif /* NETWORK_CORE_TCP_LISTEN_H */
@@ -74,7 +74,11 @@ public:
 	 * Create a new cs socket handler for a given cs.
 	 * @param s The socket we are connected with.
 	 */
-	NetworkTurnSocketHandler(SOCKET s = INVALID_SOCKET) : NetworkTCPSocketHandler(s) {}
+	NetworkTurnSocketHandler(SOCKET s = INVALID_SOCKET) : NetworkTCPSocketHandler(s)
+	{
+		/* Once connected the socket is handed to the game, which has to receive everything after the last TURN packet. */
+		this->read_exactly = true;
+	}
 
 	bool ReceivePackets();
 };
@@ -22,6 +22,7 @@
 #include "../map_func.h"
 #include "../rev.h"
 #include "../game/game.hpp"
+#include "../framerate_type.h"
 
 #include "table/strings.h"
 
@@ -56,6 +57,7 @@ static const AdminUpdateFrequencies _admin_update_type_frequencies[] = {
 	{AdminUpdateFrequency::Poll,                                                                                                                                                          }, // ADMIN_UPDATE_CMD_NAMES
 	{                            AdminUpdateFrequency::Automatic,                                                                                                                         }, // ADMIN_UPDATE_CMD_LOGGING
 	{                            AdminUpdateFrequency::Automatic,                                                                                                                         }, // ADMIN_UPDATE_GAMESCRIPT
+	{AdminUpdateFrequency::Poll, AdminUpdateFrequency::Automatic,                                                                                                                         }, // ADMIN_UPDATE_PERFORMANCE
 };
 /** Sanity check. */
 static_assert(lengthof(_admin_update_type_frequencies) == ADMIN_UPDATE_END);
@@ -70,6 +72,7 @@ ServerNetworkAdminSocketHandler::ServerNetworkAdminSocketHandler(AdminID index,
 {
 	this->status = ADMIN_STATUS_INACTIVE;
 	this->connect_time = std::chrono::steady_clock::now();
+	ServerNetworkAdminSocketHandler::WatchConnection(this);
 }
 
 /**
@@ -589,6 +592,50 @@ NetworkRecvStatus ServerNetworkAdminSocketHandler::SendGameScript(std::string_vi
 	return NETWORK_RECV_STATUS_OKAY;
 }
 
+/**
+ * Send the performance statistics of the recent game loops and frames.
+ * @return The new state the network.
+ */
+NetworkRecvStatus ServerNetworkAdminSocketHandler::SendPerformance()
+{
+	auto p = std::make_unique<Packet>(this, PacketAdminType::ServerPerformance);
+
+	/* Convert milliseconds to microseconds, saturating at the largest value the packet can hold. */
+	auto to_us = [](double ms) { return static_cast<uint32_t>(std::min<double>(ms * 1000.0, UINT32_MAX)); };
+
+	for (PerformanceElement e = PFE_FIRST; e < PFE_MAX; e++) {
+		PerformanceStatistics stats = GetPerformanceStatistics(e);
+		if (stats.count == 0) continue;
+
+		std::string key = GetPerformanceElementKey(e);
+
+		/* Should COMPAT_MTU be exceeded, start a new packet
+		 * (magic 22: 1 bool "more data", one uint8_t "element", one uint16_t "count",
+		 * four uint32_t "timings", one byte for string '\0' termination and 1 bool "no more data" */
+		if (!p->CanWriteToPacket(key.size() + 22)) {
+			p->Send_bool(false);
+			this->SendPacket(std::move(p));
+
+			p = std::make_unique<Packet>(this, PacketAdminType::ServerPerformance);
+		}
+
+		p->Send_bool(true);
+		p->Send_uint8(e);
+		p->Send_string(key);
+		p->Send_uint16(static_cast<uint16_t>(std::min<size_t>(stats.count, UINT16_MAX)));
+		p->Send_uint32(to_us(stats.mean));
+		p->Send_uint32(to_us(stats.p50));
+		p->Send_uint32(to_us(stats.p99));
+		p->Send_uint32(to_us(stats.max));
+	}
+
+	/* Marker to notify the end of the packet has been reached. */
+	p->Send_bool(false);
+	this->SendPacket(std::move(p));
+
+	return NETWORK_RECV_STATUS_OKAY;
+}
+
 /**
  * Send ping-reply (pong) to admin.
  * @param d1 Request ID from the admin, to return back to them.
@@ -774,6 +821,11 @@ NetworkRecvStatus ServerNetworkAdminSocketHandler::ReceiveAdminPoll(Packet &p)
 			this->SendCmdNames();
 			break;
 
+		case ADMIN_UPDATE_PERFORMANCE:
+			/* The admin is requesting the performance statistics. */
+			this->SendPerformance();
+			break;
+
 		default:
 			/* An unsupported "poll" update type. */
 			Debug(net, 1, "[admin] Not supported poll {} ({}) from '{}' ({}).", type, d1, this->admin_name, this->admin_version);
@@ -1082,6 +1134,18 @@ void NetworkAdminGameScript(std::string_view json)
 	}
 }
 
+/**
+ * Send the performance statistics to the admin network (if they did opt in for the respective update).
+ */
+void NetworkAdminPerformance()
+{
+	for (ServerNetworkAdminSocketHandler *as : ServerNetworkAdminSocketHandler::IterateActive()) {
+		if (as->update_frequency[ADMIN_UPDATE_PERFORMANCE].Test(AdminUpdateFrequency::Automatic)) {
+			as->SendPerformance();
+		}
+	}
+}
+
 /**
  * Distribute CommandPacket details over the admin network for logging purposes.
  * @param owner The owner of the CommandPacket (who sent us the CommandPacket).
@@ -74,6 +74,7 @@ public:
 	NetworkRecvStatus SendConsole(std::string_view origin, std::string_view command);
 	NetworkRecvStatus SendGameScript(std::string_view json);
 	NetworkRecvStatus SendCmdNames();
+	NetworkRecvStatus SendPerformance();
 	NetworkRecvStatus SendCmdLogging(ClientID client_id, const CommandPacket &cp);
 	NetworkRecvStatus SendRconEnd(std::string_view command);
 
@@ -125,6 +126,7 @@ void NetworkAdminUpdate(AdminUpdateFrequency freq);
 void NetworkServerSendAdminRcon(AdminID admin_index, TextColour colour_code, std::string_view string);
 void NetworkAdminConsole(std::string_view origin, std::string_view string);
 void NetworkAdminGameScript(std::string_view json);
+void NetworkAdminPerformance();
 void NetworkAdminCmdLogging(const NetworkClientSocket *owner, const CommandPacket &cp);
 
 #endif /* NETWORK_ADMIN_H */
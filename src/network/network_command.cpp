@@ -244,9 +244,9 @@ void NetworkSendCommand(Commands cmd, StringID err_message, CommandCallback *cal
  */
 void NetworkSyncCommandQueue(NetworkClientSocket *cs)
 {
-	for (auto &p : _local_execution_queue) {
-		CommandPacket &c = cs->outgoing_queue.emplace_back(p);
+	for (CommandPacket c : _local_execution_queue) {
 		c.callback = nullptr;
+		cs->outgoing_queue.push_back(ServerNetworkGameSocketHandler::CreateCommandPacket(c));
 	}
 }
 
@@ -303,14 +303,26 @@ static void DistributeCommandPacket(CommandPacket &cp, const NetworkClientSocket
 	CommandCallback *callback = cp.callback;
 	cp.frame = _frame_counter_max + 1;
 
+	/* The packet for everybody but the owner is only created once, and then shared. */
+	std::shared_ptr<const Packet> packet = nullptr;
 	for (NetworkClientSocket *cs : NetworkClientSocket::Iterate()) {
-		if (cs->status >= NetworkClientSocket::STATUS_MAP) {
+		if (cs->status < NetworkClientSocket::STATUS_MAP) continue;
+
+		if (cs == owner) {
 			/* Callbacks are only send back to the client who sent them in the
 			 *  first place. This filters that out. */
-			cp.callback = (cs != owner) ? nullptr : callback;
-			cp.my_cmd = (cs == owner);
-			cs->outgoing_queue.push_back(cp);
+			cp.callback = callback;
+			cp.my_cmd = true;
+			cs->outgoing_queue.push_back(ServerNetworkGameSocketHandler::CreateCommandPacket(cp));
+			continue;
+		}
+
+		if (packet == nullptr) {
+			cp.callback = nullptr;
+			cp.my_cmd = false;
+			packet = ServerNetworkGameSocketHandler::CreateCommandPacket(cp);
 		}
+		cs->outgoing_queue.push_back(packet);
 	}
 
 	cp.callback = (nullptr != owner) ? nullptr : callback;
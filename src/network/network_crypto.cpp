@@ -130,6 +130,12 @@ public:
 	{
 		crypto_aead_write(&this->context, message.data(), mac.data(), nullptr, 0, message.data(), message.size());
 	}
+
+	void Encrypt(std::span<std::uint8_t> mac, std::span<const std::uint8_t> message, std::span<std::uint8_t> destination) override
+	{
+		assert(destination.size() == message.size());
+		crypto_aead_write(&this->context, destination.data(), mac.data(), nullptr, 0, message.data(), message.size());
+	}
 };
 
 /** Ensure the key does not get leaked when we're done with it. */
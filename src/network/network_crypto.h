@@ -63,6 +63,15 @@ public:
 	 * @param message The location of the message to encrypt.
 	 */
 	virtual void Encrypt(std::span<std::uint8_t> mac, std::span<std::uint8_t> message) = 0;
+
+	/**
+	 * Encrypt the given message into another location, and write the associated MAC.
+	 * The message itself is not changed, so it can be shared with other connections.
+	 * @param mac The location to write the message authentication code (MAC) to.
+	 * @param message The message to encrypt.
+	 * @param destination The location to write the encrypted message to; of the same size as the message.
+	 */
+	virtual void Encrypt(std::span<std::uint8_t> mac, std::span<const std::uint8_t> message, std::span<std::uint8_t> destination) = 0;
 };
 
 
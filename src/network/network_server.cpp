@@ -194,6 +194,7 @@ ServerNetworkGameSocketHandler::ServerNetworkGameSocketHandler(ClientPoolID inde
 {
 	this->client_id = _network_client_id++;
 	this->receive_limit = _settings_client.network.bytes_per_frame_burst;
+	ServerNetworkGameSocketHandler::WatchConnection(this);
 
 	Debug(net, 9, "client[{}] status = INACTIVE", this->client_id);
 
@@ -305,6 +306,13 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::CloseConnection(NetworkRecvSta
 /* static */ void ServerNetworkGameSocketHandler::Send()
 {
 	for (NetworkClientSocket *cs : NetworkClientSocket::Iterate()) {
+		if (cs->HasIOThread()) {
+			/* The I/O thread sends the packets whenever the socket is writable. */
+			if (cs->status == STATUS_MAP) cs->SendMap();
+			cs->SendPackets();
+			continue;
+		}
+
 		if (cs->writable) {
 			if (cs->SendPackets() != SPS_CLOSED && cs->status == STATUS_MAP) {
 				/* This client is in the middle of a map-send, call the function for that */
@@ -314,8 +322,6 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::CloseConnection(NetworkRecvSta
 	}
 }
 
-static void NetworkHandleCommandQueue(NetworkClientSocket *cs);
-
 /***********
  * Sending functions
  ************/
@@ -643,66 +649,115 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::SendJoin(ClientID client_id)
 }
 
 /**
- * Tell the client that they may run to a particular frame.
- * @return The new state the network.
+ * Write the frame the clients may run to.
+ * @param p The packet to write to.
  */
-NetworkRecvStatus ServerNetworkGameSocketHandler::SendFrame()
+static void WriteFrame(Packet &p)
 {
-	auto p = std::make_unique<Packet>(this, PacketGameType::ServerFrame);
-	p->Send_uint32(_frame_counter);
-	p->Send_uint32(_frame_counter_max);
+	p.Send_uint32(_frame_counter);
+	p.Send_uint32(_frame_counter_max);
 #ifdef ENABLE_NETWORK_SYNC_EVERY_FRAME
+	p.Send_uint32(_sync_seed_1);
+#ifdef NETWORK_SEND_DOUBLE_SEED
+	p.Send_uint32(_sync_seed_2);
+#endif
+#endif
+}
+
+/**
+ * Create the packet telling the clients that they may run to a particular frame.
+ * It is shared by all clients that do not get a new token.
+ * @return The packet.
+ */
+static std::shared_ptr<const Packet> CreateFramePacket()
+{
+	auto p = std::make_shared<Packet>(nullptr, PacketGameType::ServerFrame);
+	WriteFrame(*p);
+	p->PrepareToSend();
+	return p;
+}
+
+/**
+ * Create the packet requesting the clients to sync; it is shared by all clients.
+ * @return The packet.
+ */
+static std::shared_ptr<const Packet> CreateSyncPacket()
+{
+	auto p = std::make_shared<Packet>(nullptr, PacketGameType::ServerSync);
+	p->Send_uint32(_frame_counter);
 	p->Send_uint32(_sync_seed_1);
 #ifdef NETWORK_SEND_DOUBLE_SEED
 	p->Send_uint32(_sync_seed_2);
 #endif
-#endif
+	p->PrepareToSend();
+	return p;
+}
 
-	/* If token equals 0, we need to make a new token and send that. */
+/**
+ * Create the packet with a command for the clients to execute.
+ * Only the owner of the command gets its callback, so the owner and the other clients get different packets.
+ * @param cp The command to send.
+ * @return The packet.
+ */
+/* static */ std::shared_ptr<const Packet> ServerNetworkGameSocketHandler::CreateCommandPacket(const CommandPacket &cp)
+{
+	Debug(net, 9, "CreateCommandPacket(): cmd={}, my_cmd={}", cp.cmd, cp.my_cmd);
+
+	auto p = std::make_shared<Packet>(nullptr, PacketGameType::ServerCommand);
+
+	NetworkGameSocketHandler::SendCommand(*p, cp);
+	p->Send_uint32(cp.frame);
+	p->Send_bool  (cp.my_cmd);
+
+	p->PrepareToSend();
+	return p;
+}
+
+/**
+ * Tell the client that they may run to a particular frame.
+ * @param frame The packet with the frame, shared with the other clients.
+ * @return The new state the network.
+ */
+NetworkRecvStatus ServerNetworkGameSocketHandler::SendFrame(const std::shared_ptr<const Packet> &frame)
+{
+	/* If token equals 0, we need to make a new token and send that. That makes the packet unique to this client. */
 	if (this->last_token == 0) {
 		this->last_token = InteractiveRandomRange(UINT8_MAX - 1) + 1;
+
+		auto p = std::make_unique<Packet>(this, PacketGameType::ServerFrame);
+		WriteFrame(*p);
 		p->Send_uint8(this->last_token);
+		this->SendPacket(std::move(p));
+		return NETWORK_RECV_STATUS_OKAY;
 	}
 
-	this->SendPacket(std::move(p));
+	this->SendPacket(frame);
 	return NETWORK_RECV_STATUS_OKAY;
 }
 
 /**
  * Request the client to sync.
+ * @param sync The packet with the sync request, shared with the other clients.
  * @return The new state the network.
  */
-NetworkRecvStatus ServerNetworkGameSocketHandler::SendSync()
+NetworkRecvStatus ServerNetworkGameSocketHandler::SendSync(const std::shared_ptr<const Packet> &sync)
 {
 	Debug(net, 9, "client[{}] SendSync(), frame_counter={}, sync_seed_1={}", this->client_id, _frame_counter, _sync_seed_1);
 
-	auto p = std::make_unique<Packet>(this, PacketGameType::ServerSync);
-	p->Send_uint32(_frame_counter);
-	p->Send_uint32(_sync_seed_1);
-
-#ifdef NETWORK_SEND_DOUBLE_SEED
-	p->Send_uint32(_sync_seed_2);
-#endif
-	this->SendPacket(std::move(p));
+	this->SendPacket(sync);
 	return NETWORK_RECV_STATUS_OKAY;
 }
 
 /**
- * Send a command to the client to execute.
- * @param cp The command to send.
+ * Send the commands that are waiting for delivery to the client.
  * @return The new state the network.
  */
-NetworkRecvStatus ServerNetworkGameSocketHandler::SendCommand(const CommandPacket &cp)
+NetworkRecvStatus ServerNetworkGameSocketHandler::SendCommands()
 {
-	Debug(net, 9, "client[{}] SendCommand(): cmd={}", this->client_id, cp.cmd);
-
-	auto p = std::make_unique<Packet>(this, PacketGameType::ServerCommand);
-
-	this->NetworkGameSocketHandler::SendCommand(*p, cp);
-	p->Send_uint32(cp.frame);
-	p->Send_bool  (cp.my_cmd);
+	Debug(net, 9, "client[{}] SendCommands(): count={}", this->client_id, this->outgoing_queue.size());
 
-	this->SendPacket(std::move(p));
+	for (const auto &p : this->outgoing_queue) this->SendPacket(p);
+	this->outgoing_queue.clear();
 	return NETWORK_RECV_STATUS_OKAY;
 }
 
@@ -1029,6 +1084,9 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::ReceiveClientAuthenticationRes
 	this->send_encryption_handler = this->authentication_handler->CreateServerToClientEncryptionHandler();
 	this->authentication_handler = nullptr;
 
+	/* Encryption does not change anymore, so from now on the I/O thread can read and write the socket. */
+	HandOverToIOThread(this);
+
 	Debug(net, 9, "client[{}] status = IDENTIFY", this->client_id);
 	this->status = STATUS_IDENTIFY;
 
@@ -1079,9 +1137,9 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::ReceiveClientMapOk(Packet &)
 		 *  so we know it is done loading and in sync with us */
 		Debug(net, 9, "client[{}] status = PRE_ACTIVE", this->client_id);
 		this->status = STATUS_PRE_ACTIVE;
-		NetworkHandleCommandQueue(this);
-		this->SendFrame();
-		this->SendSync();
+		this->SendCommands();
+		this->SendFrame(CreateFramePacket());
+		this->SendSync(CreateSyncPacket());
 
 		/* This is the frame the client receives
 		 *  we need it later on to make sure the client is not too slow */
@@ -1723,16 +1781,6 @@ bool NetworkServerChangeClientName(ClientID client_id, const std::string &new_na
 	return true;
 }
 
-/**
- * Handle the command-queue of a socket.
- * @param cs The socket to handle the queue for.
- */
-static void NetworkHandleCommandQueue(NetworkClientSocket *cs)
-{
-	for (auto &cp : cs->outgoing_queue) cs->SendCommand(cp);
-	cs->outgoing_queue.clear();
-}
-
 /**
  * This is called every tick if this is a _network_server
  * @param send_frame Whether to send the frame to the clients.
@@ -1750,6 +1798,12 @@ void NetworkServer_Tick(bool send_frame)
 	}
 #endif
 
+	/* The frame and sync packets are the same for every client, so they are only created once. */
+	std::shared_ptr<const Packet> frame = send_frame ? CreateFramePacket() : nullptr;
+#ifndef ENABLE_NETWORK_SYNC_EVERY_FRAME
+	std::shared_ptr<const Packet> sync = send_sync ? CreateSyncPacket() : nullptr;
+#endif
+
 	/* Now we are done with the frame, inform the clients that they can
 	 *  do their frame! */
 	for (NetworkClientSocket *cs : NetworkClientSocket::Iterate()) {
@@ -1857,14 +1911,14 @@ void NetworkServer_Tick(bool send_frame)
 
 		if (cs->status >= NetworkClientSocket::STATUS_PRE_ACTIVE) {
 			/* Check if we can send command, and if we have anything in the queue */
-			NetworkHandleCommandQueue(cs);
+			cs->SendCommands();
 
 			/* Send an updated _frame_counter_max to the client */
-			if (send_frame) cs->SendFrame();
+			if (send_frame) cs->SendFrame(frame);
 
 #ifndef ENABLE_NETWORK_SYNC_EVERY_FRAME
 			/* Send a sync-check packet */
-			if (send_sync) cs->SendSync();
+			if (send_sync) cs->SendSync(sync);
 #endif
 		}
 	}
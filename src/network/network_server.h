@@ -68,7 +68,7 @@ public:
 	uint8_t last_token = 0; ///< The last random token we did send to verify the client is listening
 	uint32_t last_token_frame = 0; ///< The last frame we received the right token
 	ClientStatus status = STATUS_INACTIVE; ///< Status of this client
-	CommandQueue outgoing_queue{}; ///< The command-queue awaiting delivery; conceptually more a bucket to gather commands in, after which the whole bucket is sent to the client.
+	std::vector<std::shared_ptr<const Packet>> outgoing_queue{}; ///< The command packets awaiting delivery; conceptually more a bucket to gather commands in, after which the whole bucket is sent to the client.
 	size_t receive_limit = 0; ///< Amount of bytes that we can receive at this moment
 
 	std::shared_ptr<struct PacketWriter> savegame = nullptr; ///< Writer used to write the savegame.
@@ -97,11 +97,13 @@ public:
 	NetworkRecvStatus SendChat(NetworkAction action, ClientID client_id, bool self_send, std::string_view msg, int64_t data);
 	NetworkRecvStatus SendExternalChat(std::string_view source, TextColour colour, std::string_view user, std::string_view msg);
 	NetworkRecvStatus SendJoin(ClientID client_id);
-	NetworkRecvStatus SendFrame();
-	NetworkRecvStatus SendSync();
-	NetworkRecvStatus SendCommand(const CommandPacket &cp);
+	NetworkRecvStatus SendFrame(const std::shared_ptr<const Packet> &frame);
+	NetworkRecvStatus SendSync(const std::shared_ptr<const Packet> &sync);
+	NetworkRecvStatus SendCommands();
 	NetworkRecvStatus SendConfigUpdate();
 
+	static std::shared_ptr<const Packet> CreateCommandPacket(const CommandPacket &cp);
+
 	static void Send();
 	static void AcceptConnection(SOCKET s, const NetworkAddress &address);
 	static bool AllowConnection();
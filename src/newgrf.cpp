@@ -1257,16 +1257,15 @@ struct InvokeGrfActionHandler {
  * better make this more robust in the future. */
 static void DecodeSpecialSprite(ReusableBuffer<uint8_t> &allocator, uint num, GrfLoadingStage stage)
 {
-	uint8_t *buf;
+	std::span<const uint8_t> buf;
 	auto it = _grf_line_to_action6_sprite_override.find({_cur_gps.grfconfig->ident.grfid, _cur_gps.nfo_line});
 	if (it == _grf_line_to_action6_sprite_override.end()) {
 		/* No preloaded sprite to work with; read the
-		 * pseudo sprite content. */
-		buf = allocator.Allocate(num);
-		_cur_gps.file->ReadBlock(buf, num);
+		 * pseudo sprite content, directly from memory if possible. */
+		buf = _cur_gps.file->ReadSpan(num, allocator);
 	} else {
 		/* Use the preloaded sprite data. */
-		buf = it->second.data();
+		buf = it->second;
 		assert(it->second.size() == num);
 		GrfMsg(7, "DecodeSpecialSprite: Using preloaded pseudo sprite data");
 
@@ -1274,7 +1273,7 @@ static void DecodeSpecialSprite(ReusableBuffer<uint8_t> &allocator, uint num, Gr
 		_cur_gps.file->SeekTo(num, SEEK_CUR);
 	}
 
-	ByteReader br(buf, num);
+	ByteReader br(buf.data(), buf.size());
 
 	try {
 		uint8_t action = br.ReadByte();
@@ -34,6 +34,7 @@
 #include "newgrf_debug.h"
 #include "vehicle_func.h"
 #include "station_func.h"
+#include "station_base.h"
 #include "object_cmd.h"
 #include "landscape_cmd.h"
 #include "pathfinder/water_regions.h"
@@ -128,6 +129,13 @@ void BuildObject(ObjectType type, TileIndex tile, CompanyID owner, Town *town, u
 		MarkTileDirtyByTile(t);
 	}
 
+	if (type == OBJECT_HQ) {
+		ForAllStationsAroundTiles(ta, [](Station *st, TileIndex tile) {
+			st->AddAcceptanceOfTile(tile);
+			return false;
+		});
+	}
+
 	Object::IncTypeCount(type);
 	if (spec->flags.Test(ObjectFlag::Animation)) TriggerObjectAnimation(o, ObjectAnimationTrigger::Built, spec);
 }
@@ -513,6 +521,13 @@ static int GetSlopePixelZ_Object(TileIndex tile, uint x, uint y, [[maybe_unused]
  */
 static void ReallyClearObjectTile(Object *o)
 {
+	if (o->type == OBJECT_HQ) {
+		ForAllStationsAroundTiles(o->location, [](Station *st, TileIndex tile) {
+			st->RemoveAcceptanceOfTile(tile);
+			return false;
+		});
+	}
+
 	Object::DecTypeCount(o->type);
 	for (TileIndex tile_cur : o->location) {
 		DeleteNewGRFInspectWindow(GSF_OBJECTS, tile_cur.base());
@@ -289,6 +289,7 @@ static void ParseResolution(Dimension &res, std::string_view s)
  */
 static void ShutdownGame()
 {
+	CancelSpritePrefetch();
 	IConsoleFree();
 
 	if (_network_available) NetworkShutDown(); // Shut down the network and close any open connections
@@ -1220,6 +1221,10 @@ void StateGameLoop()
 		PerformanceMeasurer::Paused(PFE_GL_SHIPS);
 		PerformanceMeasurer::Paused(PFE_GL_AIRCRAFT);
 		PerformanceMeasurer::Paused(PFE_GL_LANDSCAPE);
+		PerformanceMeasurer::Paused(PFE_GL_TILELOOP);
+		PerformanceMeasurer::Paused(PFE_GL_TOWNS);
+		PerformanceMeasurer::Paused(PFE_GL_STATIONS);
+		PerformanceMeasurer::Paused(PFE_GL_INDUSTRIES);
 
 		if (!HasModalProgress()) UpdateLandscapingLimits();
 #ifndef DEBUG_DUMP_COMMANDS
@@ -1230,6 +1235,10 @@ void StateGameLoop()
 
 	PerformanceMeasurer framerate(PFE_GAMELOOP);
 	PerformanceAccumulator::Reset(PFE_GL_LANDSCAPE);
+	PerformanceAccumulator::Reset(PFE_GL_TILELOOP);
+	PerformanceAccumulator::Reset(PFE_GL_TOWNS);
+	PerformanceAccumulator::Reset(PFE_GL_STATIONS);
+	PerformanceAccumulator::Reset(PFE_GL_INDUSTRIES);
 
 	if (_game_mode == GM_EDITOR) {
 		BasePersistentStorageArray::SwitchMode(PSM_ENTER_GAMELOOP);
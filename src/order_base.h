@@ -10,6 +10,7 @@
 #ifndef ORDER_BASE_H
 #define ORDER_BASE_H
 
+#include <ranges>
 #include "order_type.h"
 #include "core/pool_type.hpp"
 #include "core/bitmath_func.hpp"
@@ -23,6 +24,10 @@
 using OrderListPool = Pool<OrderList, OrderListID, 128>;
 extern OrderListPool _orderlist_pool;
 
+/** Index from the destinations of orders to the order lists containing them, sorted by destination and then by order list. */
+using OrderListDestinationIndex = std::set<std::pair<DestinationID::BaseType, OrderListID>>;
+extern OrderListDestinationIndex _orderlist_destination_index;
+
 template <typename, typename>
 class EndianBufferWriter;
 
@@ -398,6 +403,20 @@ private:
 	TimerGameTick::Ticks timetable_duration{}; ///< NOSAVE: Total timetabled duration of the order list.
 	TimerGameTick::Ticks total_duration{}; ///< NOSAVE: Total (timetabled or not) duration of the order list.
 
+	std::vector<DestinationID::BaseType> indexed_destinations; ///< NOSAVE: Destinations this order list is registered for in #_orderlist_destination_index.
+
+	/** The next stopping stations of the vehicles that are at one order. */
+	struct NextStoppingStations {
+		StationID last_station_visited = StationID::Invalid(); ///< Last visited station of the vehicles the stations were determined for.
+		std::vector<StationID> stations{}; ///< The next stopping stations.
+		bool valid = false; ///< Whether the stations have been determined.
+	};
+	mutable std::vector<NextStoppingStations> next_stopping_stations; ///< NOSAVE: Cache of #GetNextStoppingStation per order, with one more entry for vehicles past the last order.
+
+	void AddToDestinationIndex(const Order &order);
+	void RemoveFromDestinationIndex();
+	void FindNextStoppingStation(std::vector<StationID> &next_station, const Vehicle *v, VehicleOrderID first, uint hops) const;
+
 public:
 	/**
 	 * Default constructor producing an invalid order list.
@@ -429,7 +448,7 @@ public:
 	}
 
 	/** Destructor. Invalidates OrderList for re-usage by the pool. */
-	~OrderList() {}
+	~OrderList() { this->RemoveFromDestinationIndex(); }
 
 	void Initialize(Vehicle *v);
 
@@ -494,6 +513,9 @@ public:
 	void GetNextStoppingStation(std::vector<StationID> &next_station, const Vehicle *v, VehicleOrderID first = INVALID_VEH_ORDER_ID, uint hops = 0) const;
 	VehicleOrderID GetNextDecisionNode(VehicleOrderID next, uint hops) const;
 
+	/** Make #GetNextStoppingStation walk the orders again, after they have been changed. */
+	inline void InvalidateNextStoppingStations() { this->next_stopping_stations.clear(); }
+
 	void InsertOrderAt(Order &&order, VehicleOrderID index);
 	void DeleteOrderAt(VehicleOrderID index);
 	void MoveOrder(VehicleOrderID from, VehicleOrderID to);
@@ -560,6 +582,22 @@ public:
 
 	void FreeChain(bool keep_orderlist = false);
 
+	void UpdateDestinationIndex();
+	static void RebuildDestinationIndex();
+
+	/**
+	 * Iterate over the order lists that (might) have an order to the given destination.
+	 * Station, waypoint and depot identifiers share the index, so the caller must still check the orders of each list.
+	 * @param destination The destination to look for.
+	 * @return The order lists, in order of their index.
+	 */
+	static auto IterateWithDestination(DestinationID destination)
+	{
+		auto first = _orderlist_destination_index.lower_bound({destination.base(), OrderListID::Begin()});
+		auto last = _orderlist_destination_index.upper_bound({destination.base(), OrderListID::Invalid()});
+		return std::ranges::subrange(first, last) | std::views::transform([](const auto &entry) { return OrderList::Get(entry.second); });
+	}
+
 	void DebugCheckSanity() const;
 };
 
@@ -40,6 +40,18 @@ static_assert(sizeof(DestinationID) >= sizeof(StationID));
 OrderListPool _orderlist_pool("OrderList");
 INSTANTIATE_POOL_METHODS(OrderList)
 
+OrderListDestinationIndex _orderlist_destination_index;
+
+/**
+ * Does the order have a destination that is tracked by the destination index of the order lists?
+ * @param order The order to check.
+ * @return True iff the order goes to a station, waypoint or depot.
+ */
+static bool IsIndexedDestinationOrder(const Order &order)
+{
+	return order.IsType(OT_GOTO_STATION) || order.IsType(OT_GOTO_WAYPOINT) || order.IsType(OT_IMPLICIT) || order.IsType(OT_GOTO_DEPOT);
+}
+
 /**
  * 'Free' the order
  * @note ONLY use on "current_order" vehicle orders!
@@ -270,6 +282,55 @@ void OrderList::Initialize(Vehicle *v)
 	}
 
 	for (const Vehicle *u = v->NextShared(); u != nullptr; u = u->NextShared()) ++this->num_vehicles;
+
+	this->UpdateDestinationIndex();
+	this->InvalidateNextStoppingStations();
+}
+
+/**
+ * Register the destination of an order of this list in the destination index.
+ * @param order The order to register.
+ */
+void OrderList::AddToDestinationIndex(const Order &order)
+{
+	if (!IsIndexedDestinationOrder(order)) return;
+
+	DestinationID::BaseType destination = order.GetDestination().base();
+	if (std::ranges::find(this->indexed_destinations, destination) != std::end(this->indexed_destinations)) return;
+
+	this->indexed_destinations.push_back(destination);
+	_orderlist_destination_index.emplace(destination, this->index);
+}
+
+/** Remove all destinations of this list from the destination index. */
+void OrderList::RemoveFromDestinationIndex()
+{
+	for (DestinationID::BaseType destination : this->indexed_destinations) {
+		_orderlist_destination_index.erase({destination, this->index});
+	}
+	this->indexed_destinations.clear();
+}
+
+/**
+ * Update the destination index for the current orders of this list.
+ * Must be called after changing the destination or type of orders in place.
+ */
+void OrderList::UpdateDestinationIndex()
+{
+	this->RemoveFromDestinationIndex();
+	for (const Order &o : this->orders) this->AddToDestinationIndex(o);
+}
+
+/**
+ * Rebuild the destination index of all order lists, e.g. after loading a game.
+ */
+/* static */ void OrderList::RebuildDestinationIndex()
+{
+	_orderlist_destination_index.clear();
+	for (OrderList *list : OrderList::Iterate()) {
+		list->indexed_destinations.clear();
+		list->UpdateDestinationIndex();
+	}
 }
 
 /**
@@ -307,6 +368,7 @@ void OrderList::FreeChain(bool keep_orderlist)
 		this->orders.clear();
 		this->num_manual_orders = 0;
 		this->timetable_duration = 0;
+		this->RemoveFromDestinationIndex();
 	} else {
 		delete this;
 	}
@@ -351,15 +413,44 @@ VehicleOrderID OrderList::GetNextDecisionNode(VehicleOrderID next, uint hops) co
 }
 
 /**
- * Recursively determine the next deterministic station to stop at.
+ * Determine the next deterministic stations to stop at.
+ * When starting at the vehicle's current order, the stations are looked up in a cache that is
+ * kept per order and only walked again after the orders changed.
  * @param next_station The next stations that we have already seen, and might be adding to.
  * @param v The vehicle we're looking at.
  * @param first Order to start searching at or INVALID_VEH_ORDER_ID to start at cur_implicit_order_index + 1.
  * @param hops Number of orders we have already looked at.
  * @pre The vehicle is currently loading and v->last_station_visited is meaningful.
- * @note This function may draw a random number. Don't use it from the GUI.
  */
 void OrderList::GetNextStoppingStation(std::vector<StationID> &next_station, const Vehicle *v, VehicleOrderID first, uint hops) const
+{
+	if (first != INVALID_VEH_ORDER_ID) {
+		this->FindNextStoppingStation(next_station, v, first, hops);
+		return;
+	}
+
+	/* All vehicles past the last order start at the first one, so they share the entry after the last order. */
+	if (this->next_stopping_stations.empty()) this->next_stopping_stations.resize(this->GetNumOrders() + 1);
+	NextStoppingStations &cache = this->next_stopping_stations[std::min(v->cur_implicit_order_index, this->GetNumOrders())];
+	if (!cache.valid || cache.last_station_visited != v->last_station_visited) {
+		cache.stations.clear();
+		this->FindNextStoppingStation(cache.stations, v, first, hops);
+		cache.last_station_visited = v->last_station_visited;
+		cache.valid = true;
+	}
+
+	next_station.insert(next_station.end(), cache.stations.begin(), cache.stations.end());
+}
+
+/**
+ * Recursively determine the next deterministic station to stop at.
+ * @param next_station The next stations that we have already seen, and might be adding to.
+ * @param v The vehicle we're looking at.
+ * @param first Order to start searching at or INVALID_VEH_ORDER_ID to start at cur_implicit_order_index + 1.
+ * @param hops Number of orders we have already looked at.
+ * @pre The vehicle is currently loading and v->last_station_visited is meaningful.
+ */
+void OrderList::FindNextStoppingStation(std::vector<StationID> &next_station, const Vehicle *v, VehicleOrderID first, uint hops) const
 {
 	VehicleOrderID next = first;
 	if (first == INVALID_VEH_ORDER_ID) {
@@ -390,8 +481,8 @@ void OrderList::GetNextStoppingStation(std::vector<StationID> &next_station, con
 			} else if (skip_to == INVALID_VEH_ORDER_ID || skip_to == first) {
 				next = (advance == first) ? INVALID_VEH_ORDER_ID : advance;
 			} else {
-				this->GetNextStoppingStation(next_station, v, skip_to, hops);
-				this->GetNextStoppingStation(next_station, v, advance, hops);
+				this->FindNextStoppingStation(next_station, v, skip_to, hops);
+				this->FindNextStoppingStation(next_station, v, advance, hops);
 				return;
 			}
 			++hops;
@@ -421,6 +512,8 @@ void OrderList::InsertOrderAt(Order &&order, VehicleOrderID index)
 	if (!new_order->IsType(OT_IMPLICIT)) ++this->num_manual_orders;
 	this->timetable_duration += new_order->GetTimetabledWait() + new_order->GetTimetabledTravel();
 	this->total_duration += new_order->GetWaitTime() + new_order->GetTravelTime();
+	this->AddToDestinationIndex(*new_order);
+	this->InvalidateNextStoppingStations();
 
 	/* We can visit oil rigs and buoys that are not our own. They will be shown in
 	 * the list of stations. So, we need to invalidate that window if needed. */
@@ -446,6 +539,8 @@ void OrderList::DeleteOrderAt(VehicleOrderID index)
 	this->total_duration -= (to_remove->GetWaitTime() + to_remove->GetTravelTime());
 
 	this->orders.erase(to_remove);
+	this->UpdateDestinationIndex();
+	this->InvalidateNextStoppingStations();
 }
 
 /**
@@ -465,6 +560,7 @@ void OrderList::MoveOrder(VehicleOrderID from, VehicleOrderID to)
 	} else {
 		std::rotate(it + to, it + from, it + from + 1);
 	}
+	this->InvalidateNextStoppingStations();
 }
 
 /**
@@ -517,6 +613,10 @@ void OrderList::DebugCheckSanity() const
 	assert(this->timetable_duration == check_timetable_duration);
 	assert(this->total_duration == check_total_duration);
 
+	for (const Order &o : this->orders) {
+		if (IsIndexedDestinationOrder(o)) assert(_orderlist_destination_index.contains({o.GetDestination().base(), this->index}));
+	}
+
 	for (const Vehicle *v = this->first_shared; v != nullptr; v = v->NextShared()) {
 		++check_num_vehicles;
 		assert(v->orders == this);
@@ -1424,6 +1524,7 @@ CommandCost CmdModifyOrder(DoCommandFlags flags, VehicleID veh, VehicleOrderID s
 
 			default: NOT_REACHED();
 		}
+		v->orders->InvalidateNextStoppingStations();
 
 		/* Update the windows and full load flags, also for vehicles that share the same order list */
 		Vehicle *u = v->FirstShared();
@@ -1657,6 +1758,7 @@ CommandCost CmdOrderRefit(DoCommandFlags flags, VehicleID veh, VehicleOrderID or
 			order->SetDepotOrderType(order->GetDepotOrderType().Reset(OrderDepotTypeFlag::Service));
 			order->SetDepotActionType(order->GetDepotActionType().Reset(OrderDepotActionFlag::Halt));
 		}
+		v->orders->InvalidateNextStoppingStations();
 
 		for (Vehicle *u = v->FirstShared(); u != nullptr; u = u->NextShared()) {
 			/* Update any possible open window of the vehicle */
@@ -1758,15 +1860,24 @@ void RemoveOrderFromAllVehicles(OrderType type, DestinationID destination, bool
 	 * This fact is handled specially below
 	 */
 
-	/* Go through all vehicles */
+	/* Go through all vehicles, as their current order is not part of any order list. */
 	for (Vehicle *v : Vehicle::Iterate()) {
 		if ((v->type == VEH_AIRCRAFT && v->current_order.IsType(OT_GOTO_DEPOT) && !hangar ? OT_GOTO_STATION : v->current_order.GetType()) == type &&
 				(!hangar || v->type == VEH_AIRCRAFT) && v->current_order.GetDestination() == destination) {
 			v->current_order.MakeDummy();
 			InvalidateWindowData(WC_VEHICLE_VIEW, v->index);
 		}
+	}
+
+	/* Only the order lists with an order to the destination need to be changed. Copy them
+	 * first, as changing the orders updates the index we would be iterating. */
+	std::vector<OrderList *> lists;
+	for (OrderList *list : OrderList::IterateWithDestination(destination)) lists.push_back(list);
 
-		if (v->orders == nullptr) continue;
+	for (OrderList *list : lists) {
+		/* All vehicles sharing the list are of the same type, so the first one can stand in for all of them. */
+		Vehicle *v = list->GetFirstSharedVehicle();
+		if (v == nullptr) continue;
 
 		/* Clear the order from the order-list */
 		for (VehicleOrderID id = 0, next_id = 0; id < v->GetNumOrders(); id = next_id) {
@@ -1806,6 +1917,9 @@ void RemoveOrderFromAllVehicles(OrderType type, DestinationID destination, bool
 				}
 			}
 		}
+
+		list->UpdateDestinationIndex();
+		list->InvalidateNextStoppingStations();
 	}
 
 	OrderBackup::RemoveOrder(type, destination, hangar);
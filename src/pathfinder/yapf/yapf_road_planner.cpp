@@ -0,0 +1,395 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/** @file yapf_road_planner.cpp Pathfinder for planning new roads. */
+
+#include "../../stdafx.h"
+
+#include "../../road_func.h"
+#include "../../road_map.h"
+#include "../../station_map.h"
+#include "../../tilearea_type.h"
+#include "../../tree_map.h"
+#include "../../tunnelbridge_map.h"
+#include "yapf.hpp"
+#include "yapf_road_planner.h"
+
+#include "../../safeguards.h"
+
+/** How a planned road can use a tile. */
+enum class PlannerTileType : uint8_t {
+	Blocked, ///< No road can be built on the tile.
+	Buildable, ///< A road can be built on the tile.
+	Road, ///< The tile has a road, to which pieces can be added.
+	Fixed, ///< The tile has a road that cannot be changed, like a level crossing or the end of a bridge or tunnel.
+};
+
+/** What the road planner knows of a tile. */
+struct PlannerTile {
+	PlannerTileType type = PlannerTileType::Blocked; ///< How a road can use the tile.
+	RoadBits road{}; ///< The road pieces on the tile.
+	Axis climb = INVALID_AXIS; ///< The axis along which a road goes up or down on this tile.
+};
+
+/** The other end of a bridge or tunnel for road vehicles. */
+struct PlannerTunnelBridgeEnd {
+	TileIndex tile; ///< The tile of the other end.
+	DiagDirection dir; ///< The direction from this end to the other end.
+};
+
+/**
+ * Get what the road planner has to know of a tile.
+ * @param tile The tile.
+ * @return The information of the tile.
+ */
+static PlannerTile GetPlannerTile(TileIndex tile)
+{
+	PlannerTile pt;
+	if (!IsValidTile(tile)) return pt;
+
+	switch (GetTileType(tile)) {
+		case TileType::Clear:
+			pt.type = PlannerTileType::Buildable;
+			break;
+
+		case TileType::Trees:
+			if (GetTreeGround(tile) != TreeGround::Shore) pt.type = PlannerTileType::Buildable;
+			break;
+
+		case TileType::Road:
+			if (IsNormalRoadTile(tile)) {
+				pt.type = PlannerTileType::Road;
+				pt.road = GetRoadBits(tile, RoadTramType::Road);
+			} else if (IsLevelCrossingTile(tile)) {
+				pt.type = PlannerTileType::Fixed;
+				pt.road = AxisToRoadBits(GetCrossingRoadAxis(tile));
+			}
+			break;
+
+		case TileType::Station:
+			if (IsDriveThroughStopTile(tile) && HasTileRoadType(tile, RoadTramType::Road)) {
+				pt.type = PlannerTileType::Fixed;
+				pt.road = AxisToRoadBits(GetDriveThroughStopAxis(tile));
+			}
+			break;
+
+		case TileType::TunnelBridge:
+			/* Only the side of the land connects; the ends themselves are handled by the pathfinder. */
+			if (GetTunnelBridgeTransportType(tile) == TRANSPORT_ROAD && HasTileRoadType(tile, RoadTramType::Road)) {
+				pt.type = PlannerTileType::Fixed;
+				pt.road = DiagDirToRoadBits(ReverseDiagDir(GetTunnelBridgeDirection(tile)));
+			}
+			return pt;
+
+		default:
+			break;
+	}
+
+	Slope slope = GetTileSlope(tile);
+	if (pt.type == PlannerTileType::Buildable && IsSteepSlope(slope)) pt.type = PlannerTileType::Blocked;
+
+	DiagDirection dir = GetInclinedSlopeDirection(slope);
+	if (dir != INVALID_DIAGDIR) pt.climb = DiagDirToAxis(dir);
+	return pt;
+}
+
+/** Road planner pathfinder node; the trackdir is the direction the road enters the tile in. */
+struct YapfRoadPlannerNode : CYapfNodeT<CYapfNodeKeyTrackDir, YapfRoadPlannerNode> {};
+
+/** Road planner pathfinder node list. */
+using RoadPlannerNodeList = NodeList<YapfRoadPlannerNode, 10, 12>;
+
+/* We don't need a follower but YAPF requires one. */
+struct RoadPlannerFollower {};
+
+/* We don't need a vehicle but YAPF requires one. */
+struct RoadPlannerVehicle : Vehicle {};
+
+/** Types struct required for YAPF components. */
+struct RoadPlannerTypes {
+	using Tpf = YapfRoadPlanner;
+	using TrackFollower = RoadPlannerFollower;
+	using NodeList = RoadPlannerNodeList;
+	using VehicleType = RoadPlannerVehicle;
+};
+
+/**
+ * Road planner pathfinder implementation. It searches a copy of the map around
+ * the sources and goals, so it does not touch the map while searching.
+ */
+class YapfRoadPlanner
+	: public CYapfBaseT<RoadPlannerTypes>
+	, public CYapfSegmentCostCacheNoneT<RoadPlannerTypes>
+{
+public:
+	using Node = RoadPlannerTypes::NodeList::Item;
+	using Key = Node::Key;
+
+protected:
+	static constexpr uint MIN_MARGIN = 16; ///< Minimum number of tiles around the sources and goals that are searched.
+
+	RoadPlannerCosts costs; ///< The costs of the parts of the road.
+	const std::atomic<bool> &aborted; ///< Whether the search has to stop.
+	std::vector<TileIndex> goals{}; ///< The tiles the road has to reach, sorted.
+
+	uint left = 0; ///< X coordinate of the west side of the searched area.
+	uint top = 0; ///< Y coordinate of the north side of the searched area.
+	uint width = 0; ///< Width of the searched area.
+	uint height = 0; ///< Height of the searched area.
+	std::vector<PlannerTile> tiles{}; ///< The tiles of the searched area, row by row.
+	std::unordered_map<TileIndex, PlannerTunnelBridgeEnd> tunnel_bridge_ends{}; ///< Other ends of the bridges and tunnels in the searched area.
+
+	inline YapfRoadPlanner &Yapf()
+	{
+		return *static_cast<YapfRoadPlanner *>(this);
+	}
+
+	/**
+	 * Get the copy of a tile.
+	 * @param x The X coordinate of the tile.
+	 * @param y The Y coordinate of the tile.
+	 * @return The copy of the tile, or nullptr when it is outside the searched area.
+	 */
+	inline const PlannerTile *GetTile(uint x, uint y) const
+	{
+		if (x < this->left || y < this->top || x - this->left >= this->width || y - this->top >= this->height) return nullptr;
+		return &this->tiles[(y - this->top) * this->width + (x - this->left)];
+	}
+
+	/**
+	 * Get the copy of a tile in the searched area.
+	 * @param tile The tile.
+	 * @return The copy of the tile.
+	 */
+	inline const PlannerTile &GetTile(TileIndex tile) const
+	{
+		const PlannerTile *pt = this->GetTile(TileX(tile), TileY(tile));
+		assert(pt != nullptr);
+		return *pt;
+	}
+
+	/**
+	 * Check whether a tile has a road piece towards a direction.
+	 * @param tile The tile.
+	 * @param dir The direction.
+	 * @return True iff the road piece exists.
+	 */
+	inline bool HasRoad(TileIndex tile, DiagDirection dir) const
+	{
+		return this->GetTile(tile).road.Any(DiagDirToRoadBits(dir));
+	}
+
+	/**
+	 * Add a node for continuing the road on a tile.
+	 * @param parent The node of the tile the road comes from.
+	 * @param tile The tile.
+	 * @param dir The direction the road enters the tile in.
+	 */
+	inline void AddNode(Node &parent, TileIndex tile, DiagDirection dir)
+	{
+		Node &node = Yapf().CreateNewNode();
+		node.Set(&parent, tile, DiagDirToDiagTrackdir(dir), true);
+		Yapf().AddNewNode(node, RoadPlannerFollower{});
+	}
+
+public:
+	/**
+	 * Get the area around the sources and goals that is copied for a search, with some
+	 * room for going around obstacles. The room is made smaller when the area would
+	 * otherwise have more than RoadPlan::MAX_SEARCH_AREA tiles.
+	 * @param sources The tiles the road can start at.
+	 * @param goals The tiles the road can end at.
+	 * @return The area to copy; it only exceeds the maximum size when the sources and goals alone do.
+	 */
+	static OrthogonalTileArea GetSearchArea(std::span<const TileIndex> sources, std::span<const TileIndex> goals)
+	{
+		uint min_x = UINT_MAX, min_y = UINT_MAX, max_x = 0, max_y = 0;
+		for (std::span<const TileIndex> tiles : {sources, goals}) {
+			for (TileIndex tile : tiles) {
+				min_x = std::min(min_x, TileX(tile));
+				min_y = std::min(min_y, TileY(tile));
+				max_x = std::max(max_x, TileX(tile));
+				max_y = std::max(max_y, TileY(tile));
+			}
+		}
+
+		for (uint margin = std::max(MIN_MARGIN, std::max(max_x - min_x, max_y - min_y) / 4);; margin /= 2) {
+			uint left = min_x - std::min(min_x, margin);
+			uint top = min_y - std::min(min_y, margin);
+			uint width = std::min(max_x + margin, Map::MaxX()) - left + 1;
+			uint height = std::min(max_y + margin, Map::MaxY()) - top + 1;
+			if (width * height <= RoadPlan::MAX_SEARCH_AREA || margin == 0) return OrthogonalTileArea(TileXY(left, top), width, height);
+		}
+	}
+
+	YapfRoadPlanner(const RoadPlannerCosts &costs, std::span<const TileIndex> sources, std::span<const TileIndex> goals, const std::atomic<bool> &aborted) : costs(costs), aborted(aborted)
+	{
+		assert(!sources.empty() && !goals.empty());
+		this->max_search_nodes = costs.max_nodes;
+
+		this->goals.assign(goals.begin(), goals.end());
+		std::ranges::sort(this->goals);
+
+		OrthogonalTileArea area = GetSearchArea(sources, goals);
+		assert(static_cast<uint>(area.w) * area.h <= RoadPlan::MAX_SEARCH_AREA);
+		this->left = TileX(area.tile);
+		this->top = TileY(area.tile);
+		this->width = area.w;
+		this->height = area.h;
+
+		this->tiles.reserve(this->width * this->height);
+		for (uint y = this->top; y < this->top + this->height; y++) {
+			for (uint x = this->left; x < this->left + this->width; x++) {
+				TileIndex tile = TileXY(x, y);
+				this->tiles.push_back(GetPlannerTile(tile));
+				if (this->tiles.back().type != PlannerTileType::Fixed || !IsTileType(tile, TileType::TunnelBridge)) continue;
+
+				TileIndex other = GetOtherTunnelBridgeEnd(tile);
+				if (this->GetTile(TileX(other), TileY(other)) != nullptr) this->tunnel_bridge_ends[tile] = {other, GetTunnelBridgeDirection(tile)};
+			}
+		}
+
+		for (TileIndex source : sources) {
+			Node &node = Yapf().CreateNewNode();
+			node.Set(nullptr, source, INVALID_TRACKDIR, false);
+			Yapf().AddStartupNode(node);
+		}
+	}
+
+	/** @copydoc CYapfBaseT::PfDetectDestinationFunc */
+	inline bool PfDetectDestination(Node &n) const
+	{
+		return std::ranges::binary_search(this->goals, n.GetTile());
+	}
+
+	/** @copydoc CYapfBaseT::PfCalcCostFunc */
+	inline bool PfCalcCost(Node &n, [[maybe_unused]] const RoadPlannerFollower *follower)
+	{
+		TileIndex from = n.parent->GetTile();
+		TileIndex to = n.GetTile();
+		DiagDirection dir = TrackdirToExitdir(n.GetTrackdir());
+
+		uint distance = DistanceManhattan(from, to);
+		int cost = static_cast<int>(distance) * this->costs.tile;
+		if (distance == 1) {
+			if (!this->HasRoad(from, dir) || !this->HasRoad(to, ReverseDiagDir(dir))) cost += this->costs.new_road;
+			if (this->GetTile(to).climb == DiagDirToAxis(dir)) cost += this->costs.slope;
+		}
+		if (n.parent->GetTrackdir() != INVALID_TRACKDIR && TrackdirToExitdir(n.parent->GetTrackdir()) != dir) cost += this->costs.turn;
+
+		n.cost = n.parent->cost + cost;
+		return true;
+	}
+
+	/** @copydoc CYapfBaseT::PfCalcEstimateFunc */
+	inline bool PfCalcEstimate(Node &n)
+	{
+		uint distance = UINT_MAX;
+		for (TileIndex goal : this->goals) distance = std::min(distance, DistanceManhattan(goal, n.GetTile()));
+
+		n.estimate = n.cost + static_cast<int>(distance) * this->costs.tile;
+		assert(n.estimate >= n.parent->estimate);
+		return true;
+	}
+
+	/** @copydoc CYapfBaseT::PfFollowNodeFunc */
+	inline void PfFollowNode(Node &old_node)
+	{
+		/* Without new nodes the open list runs empty soon. */
+		if (this->aborted.load(std::memory_order_relaxed)) return;
+
+		TileIndex tile = old_node.GetTile();
+		DiagDirection entry = old_node.GetTrackdir() == INVALID_TRACKDIR ? INVALID_DIAGDIR : TrackdirToExitdir(old_node.GetTrackdir());
+
+		/* A road entering a bridge or tunnel can only go to its other end. */
+		auto it = this->tunnel_bridge_ends.find(tile);
+		if (it != this->tunnel_bridge_ends.end() && (entry == INVALID_DIAGDIR || entry == it->second.dir)) {
+			this->AddNode(old_node, it->second.tile, it->second.dir);
+			if (entry != INVALID_DIAGDIR) return;
+		}
+
+		const PlannerTile &from = this->GetTile(tile);
+		for (DiagDirection d = DIAGDIR_BEGIN; d < DIAGDIR_END; ++d) {
+			/* Roads cannot turn around. */
+			if (entry != INVALID_DIAGDIR && d == ReverseDiagDir(entry)) continue;
+			if (from.type == PlannerTileType::Fixed && !from.road.Any(DiagDirToRoadBits(d))) continue;
+
+			TileIndexDiffC diff = TileIndexDiffCByDiagDir(d);
+			const PlannerTile *to = this->GetTile(TileX(tile) + diff.x, TileY(tile) + diff.y);
+			if (to == nullptr || to->type == PlannerTileType::Blocked) continue;
+			if (to->type == PlannerTileType::Fixed && !to->road.Any(DiagDirToRoadBits(ReverseDiagDir(d)))) continue;
+
+			this->AddNode(old_node, TileAddByDiagDir(tile, d), d);
+		}
+	}
+
+	/** @copydoc CYapfBaseT::TransportTypeCharFunc */
+	inline char TransportTypeChar() const
+	{
+		return 'p';
+	}
+
+	/**
+	 * Get the tiles of the road that was found, from the source to the goal.
+	 * @return The tiles.
+	 */
+	std::vector<TileIndex> GetPath()
+	{
+		std::vector<TileIndex> path;
+		for (Node *node = this->best_dest_node; node != nullptr; node = node->parent) path.push_back(node->GetTile());
+		std::ranges::reverse(path);
+		return path;
+	}
+};
+
+/**
+ * Prepare planning a road; this copies the map around the tiles.
+ * @param costs The costs of the parts of the road.
+ * @param sources The tiles the road can start at.
+ * @param goals The tiles the road can end at.
+ * @pre !sources.empty() && !goals.empty()
+ * @pre All tiles are valid tile indices.
+ * @pre GetSearchAreaSize(sources, goals) <= MAX_SEARCH_AREA
+ */
+RoadPlan::RoadPlan(const RoadPlannerCosts &costs, std::span<const TileIndex> sources, std::span<const TileIndex> goals)
+{
+	this->pf = std::make_unique<YapfRoadPlanner>(costs, sources, goals, this->aborted);
+}
+
+RoadPlan::~RoadPlan() = default;
+
+/**
+ * Get the number of tiles that are copied for a search.
+ * @param sources The tiles the road can start at.
+ * @param goals The tiles the road can end at.
+ * @pre !sources.empty() && !goals.empty()
+ * @return The number of tiles.
+ */
+/* static */ uint RoadPlan::GetSearchAreaSize(std::span<const TileIndex> sources, std::span<const TileIndex> goals)
+{
+	OrthogonalTileArea area = YapfRoadPlanner::GetSearchArea(sources, goals);
+	return static_cast<uint>(area.w) * area.h;
+}
+
+/**
+ * Search for the cheapest road. This only uses the copy of the map, so it can be
+ * called from any thread. The copy is freed afterwards.
+ */
+void RoadPlan::Search()
+{
+	assert(this->pf != nullptr);
+	if (this->pf->FindPath(nullptr)) this->path = this->pf->GetPath();
+	this->pf.reset();
+}
+
+/**
+ * Make a search that is running on another thread stop soon, without finding a road.
+ */
+void RoadPlan::Abort()
+{
+	this->aborted.store(true, std::memory_order_relaxed);
+}
@@ -0,0 +1,60 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/** @file yapf_road_planner.h Pathfinder for planning new roads. */
+
+#ifndef YAPF_ROAD_PLANNER_H
+#define YAPF_ROAD_PLANNER_H
+
+#include "../../tile_type.h"
+
+#include <atomic>
+
+/** Costs of the parts of a planned road. All costs are non-negative. */
+struct RoadPlannerCosts {
+	int tile = 100; ///< Cost of every tile the road passes, including the tiles under bridges and in tunnels.
+	int new_road = 40; ///< Extra cost of every connection between tiles that has no road yet.
+	int turn = 100; ///< Extra cost of every turn of the road.
+	int slope = 200; ///< Extra cost of every tile where the road goes up or down.
+	int max_nodes = 100000; ///< Maximum number of nodes to visit before giving up.
+};
+
+class YapfRoadPlanner;
+
+/**
+ * Plan of a road between tiles, over existing roads, bridges and tunnels and over
+ * buildable land. The map around the tiles is copied when the plan is created, so
+ * the search itself can run on any thread while the game goes on.
+ */
+class RoadPlan {
+	std::atomic<bool> aborted = false; ///< Whether the search has to stop. This is accessed by multiple threads.
+	std::unique_ptr<YapfRoadPlanner> pf; ///< The pathfinder, with its copy of the map; freed after searching.
+	std::vector<TileIndex> path{}; ///< The planned road, or empty if none was found.
+
+public:
+	static constexpr uint MAX_SEARCH_AREA = 256 * 256; ///< Maximum number of tiles of the map that are copied for a search.
+
+	static uint GetSearchAreaSize(std::span<const TileIndex> sources, std::span<const TileIndex> goals);
+
+	RoadPlan(const RoadPlannerCosts &costs, std::span<const TileIndex> sources, std::span<const TileIndex> goals);
+	~RoadPlan();
+
+	void Search();
+	void Abort();
+
+	/**
+	 * Get the planned road, from a source to a goal. Consecutive tiles of the road are
+	 * adjacent, except for the two ends of a bridge or tunnel.
+	 * @return The tiles of the road, or an empty span when no road was found.
+	 */
+	std::span<const TileIndex> GetPath() const
+	{
+		return this->path;
+	}
+};
+
+#endif /* YAPF_ROAD_PLANNER_H */
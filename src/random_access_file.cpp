@@ -11,10 +11,20 @@
 #include "random_access_file_type.h"
 
 #include "debug.h"
+#include "core/math_func.hpp"
 #include "error_func.h"
 #include "fileio_func.h"
 #include "string_func.h"
 
+#if defined(_WIN32)
+#	include <windows.h>
+#	include <io.h>
+#elif defined(UNIX)
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
+
 #include "safeguards.h"
 
 /**
@@ -42,9 +52,109 @@ RandomAccessFile::RandomAccessFile(std::string_view filename, Subdirectory subdi
 	this->simplified_filename = name_without_path.substr(0, name_without_path.rfind('.'));
 	strtolower(this->simplified_filename);
 
+	this->MapFile();
 	this->SeekTo(static_cast<size_t>(pos), SEEK_SET);
 }
 
+/**
+ * Create a view on a memory mapped file, with its own read position.
+ * The view does not access the file itself, so views can be read by other threads,
+ * as long as the viewed file remains open. When the file changed on the disk, a view
+ * reads nothing.
+ * @param file The memory mapped file to view.
+ * @pre file.IsMapped()
+ */
+RandomAccessFile::RandomAccessFile(const RandomAccessFile &file, View) :
+		filename(file.filename), simplified_filename(file.simplified_filename), start_pos(file.start_pos), end_pos(file.end_pos),
+		mapping(file.mapping), mapping_size(file.mapping_size), mapping_offset(file.mapping_offset),
+		mapped_file_size(file.mapped_file_size), mapped_fd(file.mapped_fd), use_mapping(true), is_view(true)
+{
+	assert(this->mapping != nullptr);
+	this->SeekTo(this->start_pos, SEEK_SET);
+}
+
+RandomAccessFile::~RandomAccessFile()
+{
+	/* A mapping that is no longer used is kept until here, as views may still read it. */
+	if (this->mapping == nullptr || this->is_view) return;
+
+#if defined(_WIN32)
+	UnmapViewOfFile(this->mapping);
+#elif defined(UNIX)
+	munmap(this->mapping, this->mapping_size);
+#endif
+}
+
+/**
+ * Try to map the part of the file between the start and end position into memory.
+ * When this fails, or is not supported, the file is read through the local buffer instead.
+ * Only done for 64 bits builds, as mapping all the NewGRFs could exhaust the address space of 32 bits builds.
+ *
+ * A file can be replaced while it is open, for example when a NewGRF is rebuilt while the game runs.
+ * Windows does not allow changing a mapped file, so there only read-only files are mapped. Elsewhere
+ * reading a mapping beyond the end of a file that became shorter crashes the game, so the size of the
+ * file is checked whenever a new position is read from, see #IsMappedFileChanged.
+ */
+void RandomAccessFile::MapFile()
+{
+	if constexpr (sizeof(void *) < 8) return;
+	if (this->end_pos == this->start_pos) return;
+
+#if defined(_WIN32)
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	this->mapping_offset = this->start_pos - this->start_pos % info.dwAllocationGranularity;
+	this->mapping_size = this->end_pos - this->mapping_offset;
+
+	HANDLE file = reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(*this->file_handle)));
+	if (file == INVALID_HANDLE_VALUE) return;
+	BY_HANDLE_FILE_INFORMATION file_info;
+	if (!GetFileInformationByHandle(file, &file_info) || (file_info.dwFileAttributes & FILE_ATTRIBUTE_READONLY) == 0) return;
+	HANDLE map = CreateFileMapping(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (map == nullptr) return;
+	this->mapping = MapViewOfFile(map, FILE_MAP_READ, static_cast<DWORD>(static_cast<uint64_t>(this->mapping_offset) >> 32), static_cast<DWORD>(this->mapping_offset), this->mapping_size);
+	/* The view keeps the mapping alive. */
+	CloseHandle(map);
+	if (this->mapping == nullptr) Debug(misc, 1, "Mapping {} into memory failed, reading it through a buffer", this->filename);
+	this->use_mapping = this->mapping != nullptr;
+#elif defined(UNIX)
+	long page_size = sysconf(_SC_PAGESIZE);
+	if (page_size <= 0) return;
+	this->mapping_offset = this->start_pos - this->start_pos % page_size;
+	this->mapping_size = this->end_pos - this->mapping_offset;
+
+	int fd = fileno(*this->file_handle);
+	struct stat st;
+	if (fstat(fd, &st) != 0 || static_cast<uint64_t>(st.st_size) < this->end_pos) return;
+
+	void *mapping = mmap(nullptr, this->mapping_size, PROT_READ, MAP_PRIVATE, fd, this->mapping_offset);
+	if (mapping == MAP_FAILED) {
+		Debug(misc, 1, "Mapping {} into memory failed, reading it through a buffer", this->filename);
+		return;
+	}
+	this->mapping = mapping;
+	this->mapped_file_size = st.st_size;
+	this->mapped_fd = fd;
+	this->use_mapping = true;
+#endif
+}
+
+/**
+ * Check whether the mapped file has a different size than when it was mapped. Reading the
+ * mapping is then not safe anymore, as the file may have become shorter than the mapping.
+ * @return True iff the file changed, or its size cannot be determined.
+ */
+bool RandomAccessFile::IsMappedFileChanged() const
+{
+#if defined(UNIX)
+	struct stat st;
+	return fstat(this->mapped_fd, &st) != 0 || static_cast<uint64_t>(st.st_size) != this->mapped_file_size;
+#else
+	/* Only read-only files are mapped, and those cannot change while they are mapped. */
+	return false;
+#endif
+}
+
 /**
  * Get the filename of the opened file with the path from the SubDirectory and the extension.
  * @return Name of the file.
@@ -91,6 +201,27 @@ void RandomAccessFile::SeekTo(size_t pos, int mode)
 {
 	if (mode == SEEK_CUR) pos += this->GetPos();
 
+	if (this->use_mapping && this->IsMappedFileChanged()) {
+		Debug(misc, 1, "{} changed since it was mapped into memory, reading it through a buffer", this->filename);
+		if (this->is_view) {
+			/* A view cannot read the file itself, so it reads nothing anymore. */
+			this->pos = this->end_pos;
+			this->buffer = this->buffer_end = this->buffer_start;
+			this->use_mapping = false;
+			return;
+		}
+		this->use_mapping = false;
+	}
+
+	if (this->use_mapping) {
+		/* The whole file is in memory, so let the buffer span all of it. */
+		pos = Clamp(pos, this->mapping_offset, this->end_pos);
+		this->pos = this->end_pos;
+		this->buffer_end = static_cast<const uint8_t *>(this->mapping) + this->mapping_size;
+		this->buffer = this->buffer_end - (this->end_pos - pos);
+		return;
+	}
+
 	this->pos = pos;
 	if (fseek(*this->file_handle, this->pos, SEEK_SET) < 0) {
 		Debug(misc, 0, "Seeking in {} failed", this->filename);
@@ -101,20 +232,19 @@ void RandomAccessFile::SeekTo(size_t pos, int mode)
 }
 
 /**
- * Read a byte from the file.
- * @return Read byte.
+ * Refill the local buffer with the next bytes of the file.
+ * @return True iff there is at least one byte in the buffer.
  */
-uint8_t RandomAccessFile::ReadByte()
+bool RandomAccessFile::FillBuffer()
 {
-	if (this->buffer == this->buffer_end) {
-		this->buffer = this->buffer_start;
-		size_t size = fread(this->buffer, 1, RandomAccessFile::BUFFER_SIZE, *this->file_handle);
-		this->pos += size;
-		this->buffer_end = this->buffer_start + size;
+	/* A memory mapped file is completely in the buffer already, and a view cannot read the file. */
+	if (this->use_mapping || this->is_view) return false;
 
-		if (size == 0) return 0;
-	}
-	return *this->buffer++;
+	size_t size = fread(this->buffer_start, 1, RandomAccessFile::BUFFER_SIZE, *this->file_handle);
+	this->pos += size;
+	this->buffer = this->buffer_start;
+	this->buffer_end = this->buffer_start + size;
+	return size != 0;
 }
 
 /**
@@ -153,9 +283,34 @@ void RandomAccessFile::ReadBlock(void *ptr, size_t size)
 		ptr = static_cast<char *>(ptr) + to_copy;
 	}
 
+	/* A memory mapped file has nothing beyond the buffer, and a view cannot read the file. */
+	if (this->use_mapping || this->is_view) return;
+
 	this->pos += fread(ptr, 1, size, *this->file_handle);
 }
 
+/**
+ * Read a block without copying it, if the file is memory mapped.
+ * @param size Number of bytes to read.
+ * @param fallback Buffer to read the block into when the file is not memory mapped.
+ * @return The read bytes. They are valid until the next use of \a fallback or until the file is closed.
+ *         When the end of the file is reached, fewer than \a size bytes are returned.
+ */
+std::span<const uint8_t> RandomAccessFile::ReadSpan(size_t size, ReusableBuffer<uint8_t> &fallback)
+{
+	if (this->use_mapping) {
+		size = std::min<size_t>(size, this->buffer_end - this->buffer);
+		std::span<const uint8_t> block{this->buffer, size};
+		this->buffer += size;
+		return block;
+	}
+	if (this->is_view) return {};
+
+	uint8_t *block = fallback.Allocate(size);
+	this->ReadBlock(block, size);
+	return {block, size};
+}
+
 /**
  * Skip \a n bytes ahead in the file.
  * @param n Number of bytes to skip reading.
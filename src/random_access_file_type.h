@@ -11,6 +11,7 @@
 #define RANDOM_ACCESS_FILE_TYPE_H
 
 #include "fileio_type.h"
+#include "core/alloc_type.hpp"
 
 /**
  * A file from which bytes, words and double words are read in (potentially) a random order.
@@ -18,6 +19,10 @@
  * This is mostly intended to be used for things that can be read from GRFs when needed, so
  * the graphics but also the sounds. This also ties into the spritecache as it uses these
  * files to load the sprites from when needed.
+ *
+ * Where possible the whole file is mapped into memory, so reading from it does not need
+ * any system calls and blocks of data can be used without copying them; otherwise the
+ * file is read through a small buffer.
  */
 class RandomAccessFile {
 	/** The number of bytes to allocate for the buffer. */
@@ -31,17 +36,32 @@ class RandomAccessFile {
 	size_t start_pos; ///< Start position of file. May be non-zero if file is within a tar file.
 	size_t end_pos; ///< End position of file.
 
-	uint8_t *buffer;                    ///< Current position within the local buffer.
-	uint8_t *buffer_end;                ///< Last valid byte of buffer.
+	void *mapping = nullptr;         ///< Memory mapping of the file, or \c nullptr when the file is not mapped.
+	size_t mapping_size = 0;         ///< Size of the memory mapping.
+	size_t mapping_offset = 0;       ///< Position in the file of the start of the memory mapping.
+	size_t mapped_file_size = 0;     ///< Size of the file on the disk when it was mapped.
+	int mapped_fd = -1;              ///< Descriptor of the mapped file, to check whether it changed; shared with the views.
+	bool use_mapping = false;        ///< Whether the file is read from #mapping, instead of through #buffer_start.
+	bool is_view = false;            ///< Whether this reads the memory mapping of another RandomAccessFile.
+
+	const uint8_t *buffer;              ///< Current position within the local buffer or the memory mapping.
+	const uint8_t *buffer_end;          ///< Last valid byte of buffer.
 	uint8_t buffer_start[BUFFER_SIZE];  ///< Local buffer when read from file.
 
+	void MapFile();
+	bool IsMappedFileChanged() const;
+	bool FillBuffer();
+
 public:
+	/** Tag to select the constructor that creates a view on a memory mapped file. */
+	struct View {};
+
 	RandomAccessFile(std::string_view filename, Subdirectory subdir);
+	RandomAccessFile(const RandomAccessFile &file, View);
 	RandomAccessFile(const RandomAccessFile&) = delete;
 	void operator=(const RandomAccessFile&) = delete;
 
-	/** Ensure the destructor of the sub classes are called as well. */
-	virtual ~RandomAccessFile() = default;
+	virtual ~RandomAccessFile();
 
 	const std::string &GetFilename() const;
 	const std::string &GetSimplifiedFilename() const;
@@ -49,14 +69,29 @@ public:
 	size_t GetPos() const;
 	size_t GetStartPos() const { return this->start_pos; }
 	size_t GetEndPos() const { return this->end_pos; }
+	/**
+	 * Whether the file is mapped into memory, so views on it can be created.
+	 * @return True iff the file is memory mapped.
+	 */
+	bool IsMapped() const { return this->use_mapping; }
 	void SeekTo(size_t pos, int mode);
 	bool AtEndOfFile() const;
 
-	uint8_t ReadByte();
+	/**
+	 * Read a byte from the file.
+	 * @return Read byte, or 0 when reading beyond the end of the file.
+	 */
+	inline uint8_t ReadByte()
+	{
+		if (this->buffer == this->buffer_end && !this->FillBuffer()) return 0;
+		return *this->buffer++;
+	}
+
 	uint16_t ReadWord();
 	uint32_t ReadDword();
 
 	void ReadBlock(void *ptr, size_t size);
+	std::span<const uint8_t> ReadSpan(size_t size, ReusableBuffer<uint8_t> &fallback);
 	void SkipBytes(size_t n);
 };
 
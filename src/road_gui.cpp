@@ -1405,7 +1405,7 @@ public:
 		this->LowerWidget(WID_BROS_STATION_NE + _roadstop_gui.orientation);
 		this->LowerWidget(WID_BROS_LT_OFF + _settings_client.gui.station_show_coverage);
 
-		this->window_class = (rs == RoadStopType::Bus) ? WC_BUS_STATION : WC_TRUCK_STATION;
+		this->ChangeWindowClass((rs == RoadStopType::Bus) ? WC_BUS_STATION : WC_TRUCK_STATION);
 	}
 
 	void Close([[maybe_unused]] int data = 0) override
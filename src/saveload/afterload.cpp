@@ -28,6 +28,7 @@
 #include "../roadveh_cmd.h"
 #include "../train.h"
 #include "../station_base.h"
+#include "../station_func.h"
 #include "../waypoint_base.h"
 #include "../roadstop_base.h"
 #include "../tunnelbridge_map.h"
@@ -3436,6 +3437,7 @@ bool AfterLoadGame()
 	ResetSignalHandlers();
 
 	AfterLoadLinkGraphs();
+	_station_tick_scheduler.Rebuild();
 
 	CheckGroundVehiclesAtCorrectZ();
 
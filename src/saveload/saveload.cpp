@@ -2307,10 +2307,15 @@ static void SlSaveChunk(const ChunkHandler &ch)
 	if (_sl.expect_table_header) SlErrorCorrupt("Table chunk without header");
 }
 
-/** Save all chunks */
-static void SlSaveChunks()
+/**
+ * Save all chunks
+ * @param game_state_only Leave out the chunks that are not part of the game state, like the gamelog.
+ */
+static void SlSaveChunks(bool game_state_only = false)
 {
 	for (auto &ch : ChunkHandlers()) {
+		/* The gamelog holds the revision of the game, and the viewport depends on the client. */
+		if (game_state_only && (ch.get().id == 'GLOG' || ch.get().id == 'VIEW')) continue;
 		SlSaveChunk(ch);
 	}
 
@@ -3119,6 +3124,53 @@ SaveOrLoadResult SaveWithFilter(std::shared_ptr<SaveFilter> writer, bool threade
 	}
 }
 
+/** Save filter that does not write anything, but calculates a 64 bit FNV-1a hash of all written bytes. */
+struct HashSaveFilter : SaveFilter {
+	uint64_t hash = 0xCBF29CE484222325ULL; ///< The hash of the bytes written so far.
+
+	HashSaveFilter() : SaveFilter(nullptr) {}
+
+	void Write(uint8_t *buf, size_t len) override
+	{
+		for (size_t i = 0; i < len; i++) {
+			this->hash = (this->hash ^ buf[i]) * 0x100000001B3ULL;
+		}
+	}
+};
+
+/**
+ * Calculate a hash of the game state, by hashing the uncompressed chunks of a savegame.
+ * The savegame header and the chunks that differ between builds or clients of the
+ * same game, like the gamelog, are left out. So the same game gives the same hash
+ * with any build that has the same savegame version. The random ID of the savegame
+ * is left out as well, so two new games with the same seed give the same hash.
+ * @return The hash, or std::nullopt when saving failed.
+ */
+std::optional<uint64_t> CalculateGameStateHash()
+{
+	WaitTillSaved();
+
+	auto filter = std::make_shared<HashSaveFilter>();
+	std::string savegame_id = std::exchange(_game_session_stats.savegame_id, {});
+	try {
+		_sl.action = SLA_SAVE;
+		_sl.dumper = std::make_unique<MemoryDumper>();
+		_sl.sf = filter;
+		_sl_version = SAVEGAME_VERSION;
+
+		SlSaveChunks(true);
+		_sl.dumper->Flush(_sl.sf);
+
+		ClearSaveLoadState();
+		_game_session_stats.savegame_id = std::move(savegame_id);
+		return filter->hash;
+	} catch (...) {
+		ClearSaveLoadState();
+		_game_session_stats.savegame_id = std::move(savegame_id);
+		return std::nullopt;
+	}
+}
+
 /**
  * Determines the SaveLoadFormat that is connected to the given tag.
  * When the given tag is known, that format is chosen and a check on the validity of the version is performed.
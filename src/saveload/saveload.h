@@ -462,6 +462,7 @@ void DoExitSave();
 void DoAutoOrNetsave(FiosNumberedSaveName &counter);
 
 SaveOrLoadResult SaveWithFilter(std::shared_ptr<struct SaveFilter> writer, bool threaded);
+std::optional<uint64_t> CalculateGameStateHash();
 SaveOrLoadResult LoadWithFilter(std::shared_ptr<struct LoadFilter> reader);
 
 typedef void AutolengthProc(int);
@@ -13,6 +13,7 @@
 #include "compat/station_sl_compat.h"
 
 #include "../station_base.h"
+#include "../station_func.h"
 #include "../waypoint_base.h"
 #include "../roadstop_base.h"
 #include "../vehicle_base.h"
@@ -125,6 +126,9 @@ void AfterLoadStations()
 			Station *sta = Station::From(st);
 			for (const RoadStop *rs = sta->bus_stops; rs != nullptr; rs = rs->next) sta->bus_station.Add(rs->xy);
 			for (const RoadStop *rs = sta->truck_stops; rs != nullptr; rs = rs->next) sta->truck_station.Add(rs->xy);
+
+			/* The acceptance of houses may have changed with the NewGRFs. */
+			sta->InvalidateAcceptanceCache();
 		}
 
 		StationUpdateCachedTriggers(st);
@@ -728,6 +732,8 @@ struct STNNChunkHandler : ChunkHandler {
 	{
 		SlTableHeader(_station_desc);
 
+		_station_tick_scheduler.SyncDeleteCounters();
+
 		/* Write the stations */
 		for (BaseStation *st : BaseStation::Iterate()) {
 			SlSetArrayIndex(st->index);
@@ -433,6 +433,9 @@ void AfterLoadVehiclesPhase1(bool part_of_load)
  */
 void AfterLoadVehiclesPhase2(bool part_of_load)
 {
+	/* Orders might have been converted in place, so only now the destinations are final. */
+	OrderList::RebuildDestinationIndex();
+
 	for (Vehicle *v : Vehicle::Iterate()) {
 		assert(v->First() != nullptr);
 
@@ -568,12 +571,12 @@ void FixupTrainLengths()
 {
 	/* Vehicle center was moved from 4 units behind the front to half the length
 	 * behind the front. Move vehicles so they end up on the same spot. */
-	for (Vehicle *v : Vehicle::Iterate()) {
-		if (v->type == VEH_TRAIN && v->IsPrimaryVehicle()) {
+	for (Train *v : Train::Iterate()) {
+		if (v->IsPrimaryVehicle()) {
 			/* The vehicle center is now more to the front depending on vehicle length,
 			 * so we need to move all vehicles forward to cover the difference to the
 			 * old center, otherwise wagon spacing in trains would be broken upon load. */
-			for (Train *u = Train::From(v); u != nullptr; u = u->Next()) {
+			for (Train *u = v; u != nullptr; u = u->Next()) {
 				if (u->track == TRACK_BIT_DEPOT || u->vehstatus.Test(VehState::Crashed)) continue;
 
 				Train *next = u->Next();
@@ -11,7 +11,7 @@
 #include "../waypoint_base.h"
 #include "../debug.h"
 #include "../newgrf_station.h"
-#include "../vehicle_base.h"
+#include "../train.h"
 #include "../town.h"
 #include "../newgrf.h"
 #include "../timer/timer_game_calendar.h"
@@ -152,10 +152,8 @@ void MoveWaypointsToBaseStations()
 		for (Order &o : ol->GetOrders()) UpdateWaypointOrder(o);
 	}
 
-	for (Vehicle *v : Vehicle::Iterate()) {
-		if (v->type != VEH_TRAIN) continue;
-
-		UpdateWaypointOrder(v->current_order);
+	for (Train *t : Train::Iterate()) {
+		UpdateWaypointOrder(t->current_order);
 	}
 
 	ResetOldWaypoints();
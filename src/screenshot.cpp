@@ -336,11 +336,7 @@ bool MakeHeightmapScreenshot(std::string_view filename)
 		palette[i].b = i;
 	}
 
-	_heightmap_highest_peak = 0;
-	for (const auto tile : Map::Iterate()) {
-		uint h = TileHeight(tile);
-		_heightmap_highest_peak = std::max(h, _heightmap_highest_peak);
-	}
+	_heightmap_highest_peak = Map::GetMaxHeightInArea(0, 0, Map::SizeX(), Map::SizeY());
 
 	return provider->MakeImage(filename, HeightmapCallback, Map::SizeX(), Map::SizeY(), 8, palette);
 }
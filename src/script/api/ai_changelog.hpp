@@ -19,6 +19,11 @@
  *
  * This version is not yet released. The following changes are not set in stone yet.
  *
+ * API additions:
+ * \li AIList::NativeValuator
+ * \li AIList::ValuateNative
+ * \li AIRoadPathfinder
+ *
  * \b 15.0
  *
  * API additions:
@@ -19,6 +19,11 @@
  *
  * This version is not yet released. The following changes are not set in stone yet.
  *
+ * API additions:
+ * \li GSList::NativeValuator
+ * \li GSList::ValuateNative
+ * \li GSRoadPathfinder
+ *
  * \b 15.0
  *
  * API additions:
@@ -183,11 +183,8 @@
 
 	Money profit = 0;
 
-	for (const Vehicle *v : Vehicle::Iterate()) {
-		if (v->group_id != group_id) continue;
-		if (!v->IsPrimaryVehicle()) continue;
-
-		profit += v->GetDisplayProfitThisYear();
+	for (VehicleID vehicle : ::Group::Get(group_id)->statistics.vehicles) {
+		profit += ::Vehicle::Get(vehicle)->GetDisplayProfitThisYear();
 	}
 
 	return profit;
@@ -207,11 +204,8 @@
 	uint32_t occupancy = 0;
 	uint32_t vehicle_count = 0;
 
-	for (const Vehicle *v : Vehicle::Iterate()) {
-		if (v->group_id != group_id) continue;
-		if (!v->IsPrimaryVehicle()) continue;
-
-		occupancy += v->trip_occupancy;
+	for (VehicleID vehicle : ::Group::Get(group_id)->statistics.vehicles) {
+		occupancy += ::Vehicle::Get(vehicle)->trip_occupancy;
 		vehicle_count++;
 	}
 
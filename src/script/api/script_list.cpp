@@ -9,7 +9,10 @@
 
 #include "../../stdafx.h"
 #include "script_list.hpp"
+#include "script_tile.hpp"
+#include "script_error.hpp"
 #include "../../debug.h"
+#include "../../thread.h"
 #include "../../script/squirrel.hpp"
 
 #include "../../safeguards.h"
@@ -863,3 +866,55 @@ SQInteger ScriptList::Valuate(HSQUIRRELVM vm)
 	sq_pushbool(vm, SQFalse);
 	return 1;
 }
+
+/** A built-in valuator for ScriptList::ValuateNative. */
+struct NativeValuatorSpec {
+	SQInteger (*valuate)(TileIndex tile, TileIndex param); ///< Get the value of a tile.
+	bool parallel; ///< Whether the valuator only reads the map, so it can run on worker threads.
+};
+
+/** The built-in valuators, indexed by ScriptList::NativeValuator. */
+static const NativeValuatorSpec _native_valuators[] = {
+	{ [](TileIndex tile, TileIndex) -> SQInteger { return ScriptTile::IsBuildable(tile); }, false },
+	{ [](TileIndex tile, TileIndex) -> SQInteger { return ScriptTile::IsWaterTile(tile); }, true },
+	{ [](TileIndex tile, TileIndex) -> SQInteger { return ScriptTile::IsSeaTile(tile); }, true },
+	{ [](TileIndex tile, TileIndex) -> SQInteger { return ScriptTile::IsCoastTile(tile); }, true },
+	{ [](TileIndex tile, TileIndex) -> SQInteger { return ScriptTile::GetSlope(tile); }, true },
+	{ [](TileIndex tile, TileIndex) -> SQInteger { return ScriptTile::GetMinHeight(tile); }, true },
+	{ [](TileIndex tile, TileIndex) -> SQInteger { return ScriptTile::GetMaxHeight(tile); }, true },
+	{ [](TileIndex tile, TileIndex) -> SQInteger { return ScriptTile::GetTerrainType(tile); }, true },
+	{ [](TileIndex tile, TileIndex param) -> SQInteger { return ScriptTile::GetDistanceManhattanToTile(tile, param); }, true },
+	{ [](TileIndex tile, TileIndex param) -> SQInteger { return ScriptTile::GetDistanceSquareToTile(tile, param); }, true },
+};
+static_assert(std::size(_native_valuators) == ScriptList::NV_TILE_DISTANCE_SQUARE + 1);
+
+bool ScriptList::ValuateNative(NativeValuator valuator, SQInteger param)
+{
+	EnforcePrecondition(false, valuator <= NV_TILE_DISTANCE_SQUARE);
+	const NativeValuatorSpec &spec = _native_valuators[valuator];
+
+	this->modifications++;
+
+	/* Items are converted to tiles the same way as when they are passed to a script function. */
+	auto to_tile = [](SQInteger item) { return TileIndex(static_cast<uint32_t>(static_cast<int32_t>(item))); };
+	TileIndex param_tile = to_tile(param);
+
+	std::vector<std::pair<SQInteger, SQInteger>> values;
+	values.reserve(this->items.size());
+	for (const auto &[item, _] : this->items) values.emplace_back(item, 0);
+
+	auto valuate = [&values, &spec, &to_tile, param_tile](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) values[i].second = spec.valuate(to_tile(values[i].first), param_tile);
+	};
+	if (spec.parallel) {
+		ParallelFor(values.size(), 4096, valuate);
+	} else {
+		valuate(0, values.size());
+	}
+
+	for (const auto &[item, value] : values) this->SetValue(item, value);
+
+	/* Charge a single op per item, instead of the call of a valuator function. */
+	ScriptController::DecreaseOps(static_cast<int>(std::min<size_t>(values.size(), MAX_VALUATE_OPS)));
+	return true;
+}
@@ -31,6 +31,20 @@ public:
 		SORT_BY_ITEM,  ///< Sort the list based on the item itself.
 	};
 
+	/** Built-in valuators for ValuateNative; they all take the items as tiles. */
+	enum NativeValuator : uint8_t {
+		NV_TILE_IS_BUILDABLE,        ///< The value of ScriptTile::IsBuildable.
+		NV_TILE_IS_WATER,            ///< The value of ScriptTile::IsWaterTile.
+		NV_TILE_IS_SEA,              ///< The value of ScriptTile::IsSeaTile.
+		NV_TILE_IS_COAST,            ///< The value of ScriptTile::IsCoastTile.
+		NV_TILE_GET_SLOPE,           ///< The value of ScriptTile::GetSlope.
+		NV_TILE_GET_MIN_HEIGHT,      ///< The value of ScriptTile::GetMinHeight.
+		NV_TILE_GET_MAX_HEIGHT,      ///< The value of ScriptTile::GetMaxHeight.
+		NV_TILE_GET_TERRAIN_TYPE,    ///< The value of ScriptTile::GetTerrainType.
+		NV_TILE_DISTANCE_MANHATTAN,  ///< The value of ScriptTile::GetDistanceManhattanToTile to the tile given as parameter.
+		NV_TILE_DISTANCE_SQUARE,     ///< The value of ScriptTile::GetDistanceSquareToTile to the tile given as parameter.
+	};
+
 	/** Sort ascending */
 	static const bool SORT_ASCENDING = true;
 	/** Sort descending */
@@ -503,6 +517,24 @@ public:
 	 */
 	void Valuate(function valuator_function, ...);
 #endif /* DOXYGEN_API */
+
+	/**
+	 * Give all items in this list a value by one of the built-in valuators.
+	 * This gives the same values as Valuate with the matching ScriptTile function,
+	 * but no script function is called for each item, so it is a lot cheaper on
+	 * large lists of tiles.
+	 * @param valuator The built-in valuator to use.
+	 * @param param The tile to measure the distance to for the distance valuators; ignored by the others.
+	 * @pre valuator is one of the NativeValuator values.
+	 * @return True if the items were given a value.
+	 * @note Valuating with NV_TILE_IS_BUILDABLE requires the same mode as ScriptTile::IsBuildable.
+	 * @note Example:
+	 * @code
+	 *  list.ValuateNative(ScriptList.NV_TILE_DISTANCE_MANHATTAN, town_tile);
+	 *  list.KeepBelowValue(10);
+	 * @endcode
+	 */
+	bool ValuateNative(NativeValuator valuator, SQInteger param);
 };
 
 #endif /* SCRIPT_LIST_HPP */
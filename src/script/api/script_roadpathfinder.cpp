@@ -0,0 +1,112 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/** @file script_roadpathfinder.cpp Implementation of ScriptRoadPathfinder. */
+
+#include "../../stdafx.h"
+#include "script_roadpathfinder.hpp"
+#include "script_controller.hpp"
+#include "script_error.hpp"
+#include "script_map.hpp"
+#include "../../thread.h"
+
+#include "../../safeguards.h"
+
+ScriptRoadPathfinder::~ScriptRoadPathfinder()
+{
+	this->StopSearch();
+}
+
+/**
+ * Stop the running search, if any, and forget its result.
+ */
+void ScriptRoadPathfinder::StopSearch()
+{
+	if (this->plan == nullptr) return;
+
+	this->plan->Abort();
+	if (this->thread.joinable()) this->thread.join();
+	this->plan.reset();
+}
+
+bool ScriptRoadPathfinder::SetCost(CostType type, SQInteger cost)
+{
+	EnforcePrecondition(false, cost >= 0 && cost <= MAX_COST);
+
+	switch (type) {
+		case COST_TILE: this->costs.tile = cost; break;
+		case COST_NEW_ROAD: this->costs.new_road = cost; break;
+		case COST_TURN: this->costs.turn = cost; break;
+		case COST_SLOPE: this->costs.slope = cost; break;
+		default: return false;
+	}
+	return true;
+}
+
+SQInteger ScriptRoadPathfinder::GetCost(CostType type) const
+{
+	switch (type) {
+		case COST_TILE: return this->costs.tile;
+		case COST_NEW_ROAD: return this->costs.new_road;
+		case COST_TURN: return this->costs.turn;
+		case COST_SLOPE: return this->costs.slope;
+		default: return -1;
+	}
+}
+
+bool ScriptRoadPathfinder::SetMaxSearchNodes(SQInteger nodes)
+{
+	EnforcePrecondition(false, nodes > 0 && nodes <= MAX_SEARCH_NODES);
+
+	this->costs.max_nodes = nodes;
+	return true;
+}
+
+bool ScriptRoadPathfinder::StartSearch(Array<TileIndex> &&sources, Array<TileIndex> &&goals)
+{
+	EnforcePrecondition(false, !sources.empty() && !goals.empty());
+	for (std::span<const TileIndex> tiles : {std::span<const TileIndex>(sources), std::span<const TileIndex>(goals)}) {
+		for (TileIndex tile : tiles) EnforcePrecondition(false, ScriptMap::IsValidTile(tile));
+	}
+	uint area = RoadPlan::GetSearchAreaSize(sources, goals);
+	EnforcePrecondition(false, area <= RoadPlan::MAX_SEARCH_AREA);
+
+	this->StopSearch();
+
+	/* The map is copied here, on the game thread; the search only uses the copy. Charge for copying it. */
+	ScriptController::DecreaseOps(area);
+	this->plan = std::make_unique<RoadPlan>(this->costs, sources, goals);
+	this->done = false;
+	if (!StartNewThread(&this->thread, "ottd:roadplan", [this, plan = this->plan.get()]() {
+			plan->Search();
+			this->done = true;
+		})) {
+		this->plan->Search();
+		this->done = true;
+	}
+	return true;
+}
+
+ScriptRoadPathfinder::SearchStatus ScriptRoadPathfinder::GetStatus()
+{
+	if (this->plan == nullptr) return SEARCH_NONE;
+	if (!this->done) return SEARCH_RUNNING;
+
+	if (this->thread.joinable()) this->thread.join();
+	return this->plan->GetPath().empty() ? SEARCH_NOT_FOUND : SEARCH_FOUND;
+}
+
+ScriptList *ScriptRoadPathfinder::GetPath()
+{
+	if (this->GetStatus() != SEARCH_FOUND) return nullptr;
+
+	ScriptList *list = new ScriptList();
+	SQInteger position = 0;
+	for (TileIndex tile : this->plan->GetPath()) list->AddItem(tile.base(), position++);
+	list->Sort(ScriptList::SORT_BY_VALUE, ScriptList::SORT_ASCENDING);
+	return list;
+}
@@ -0,0 +1,119 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/** @file script_roadpathfinder.hpp Native pathfinder for planning roads. */
+
+#ifndef SCRIPT_ROADPATHFINDER_HPP
+#define SCRIPT_ROADPATHFINDER_HPP
+
+#include "script_list.hpp"
+#include "../squirrel_helper_type.hpp"
+#include "../../pathfinder/yapf/yapf_road_planner.h"
+
+#include <thread>
+
+/**
+ * Pathfinder that plans roads between tiles, over existing roads, bridges and
+ * tunnels and over land where a road can be built. The search runs in the
+ * background against a copy of the map made when the search starts, so the
+ * script can go on while it runs.
+ * @api ai game
+ */
+class ScriptRoadPathfinder : public ScriptObject {
+public:
+	/** The costs of the parts of a road, used to find the cheapest road. */
+	enum CostType {
+		COST_TILE,     ///< Cost of every tile of the road, including the tiles under bridges and in tunnels.
+		COST_NEW_ROAD, ///< Extra cost of every connection between two tiles that has no road yet.
+		COST_TURN,     ///< Extra cost of every turn of the road.
+		COST_SLOPE,    ///< Extra cost of every tile where the road goes up or down.
+	};
+
+	/** The state of the search. */
+	enum SearchStatus {
+		SEARCH_NONE,      ///< No search has been started.
+		SEARCH_RUNNING,   ///< The search is still running.
+		SEARCH_FOUND,     ///< The search found a road.
+		SEARCH_NOT_FOUND, ///< The search did not find a road.
+	};
+
+	/** The maximum cost of a part of a road. */
+	static const SQInteger MAX_COST = 1000;
+	/** The maximum number of nodes a search can visit. */
+	static const SQInteger MAX_SEARCH_NODES = 500000;
+	/** The maximum number of tiles in the area around the sources and goals that is searched. */
+	static const SQInteger MAX_SEARCH_AREA = RoadPlan::MAX_SEARCH_AREA;
+
+	~ScriptRoadPathfinder() override;
+
+	/**
+	 * Set the cost of a part of the road. Searches that are already running are not affected.
+	 * @param type The part of the road.
+	 * @param cost The new cost.
+	 * @pre cost >= 0 && cost <= MAX_COST.
+	 * @return True if the cost is set.
+	 */
+	bool SetCost(CostType type, SQInteger cost);
+
+	/**
+	 * Get the cost of a part of the road.
+	 * @param type The part of the road.
+	 * @return The cost, or -1 for an invalid type.
+	 */
+	SQInteger GetCost(CostType type) const;
+
+	/**
+	 * Set the number of nodes a search visits before it gives up. Searches that are
+	 * already running are not affected.
+	 * @param nodes The number of nodes; the default is 100000.
+	 * @pre nodes > 0 && nodes <= MAX_SEARCH_NODES.
+	 * @return True if the number of nodes is set.
+	 */
+	bool SetMaxSearchNodes(SQInteger nodes);
+
+	/**
+	 * Start searching for the cheapest road from any of the sources to any of the
+	 * goals. A search that is still running is stopped first. Only the area around
+	 * the sources and goals is searched; the room around them is made smaller when
+	 * the area would have more than MAX_SEARCH_AREA tiles. Starting a search costs
+	 * one operation for every tile of the area.
+	 * @param sources The tiles the road can start at.
+	 * @param goals The tiles the road can end at.
+	 * @pre sources and goals are not empty.
+	 * @pre All sources and goals are valid tiles.
+	 * @pre The rectangle around the sources and goals has at most MAX_SEARCH_AREA tiles.
+	 * @return True if the search is started.
+	 * @note When the search finishes depends on the speed of the computer, not on the game.
+	 */
+	bool StartSearch(Array<TileIndex> &&sources, Array<TileIndex> &&goals);
+
+	/**
+	 * Get the state of the last started search.
+	 * @return The state of the search.
+	 */
+	SearchStatus GetStatus();
+
+	/**
+	 * Get the road the last search found. The items are the tiles of the road, and
+	 * the values their position along the road, starting with 0 at the source. The
+	 * list is sorted from the source to the goal. Consecutive tiles are adjacent,
+	 * except for the two ends of a bridge or tunnel.
+	 * @pre GetStatus() == SEARCH_FOUND.
+	 * @return The tiles of the road.
+	 */
+	ScriptList *GetPath();
+
+private:
+	RoadPlannerCosts costs{}; ///< The costs for new searches.
+	std::unique_ptr<RoadPlan> plan{}; ///< The last started search.
+	std::thread thread{}; ///< The thread running the search, if it runs on a thread.
+	std::atomic<bool> done = false; ///< Whether the search is done. This is accessed by multiple threads.
+
+	void StopSearch();
+};
+
+#endif /* SCRIPT_ROADPATHFINDER_HPP */
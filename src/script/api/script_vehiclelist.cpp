@@ -14,6 +14,8 @@
 #include "script_station.hpp"
 #include "script_waypoint.hpp"
 #include "../../depot_map.h"
+#include "../../group.h"
+#include "../../company_base.h"
 #include "../../vehicle_base.h"
 #include "../../vehiclelist_func.h"
 #include "../../train.h"
@@ -62,7 +64,7 @@ ScriptVehicleList_Station::ScriptVehicleList_Station(HSQUIRRELVM vm)
 		type = static_cast<::VehicleType>(sqtype);
 	}
 
-	FindVehiclesWithOrder(
+	FindVehiclesWithOrder(station_id,
 		[is_deity, owner, type](const Vehicle *v) { return (is_deity || v->owner == owner) && (type == VEH_INVALID || v->type == type); },
 		[station_id](const Order *order) { return (order->IsType(OT_GOTO_STATION) || order->IsType(OT_GOTO_WAYPOINT)) && order->GetDestination() == station_id; },
 		[this](const Vehicle *v) { this->AddItem(v->index.base()); }
@@ -77,7 +79,7 @@ ScriptVehicleList_Waypoint::ScriptVehicleList_Waypoint(StationID waypoint_id)
 	bool is_deity = ScriptCompanyMode::IsDeity();
 	::CompanyID owner = ScriptObject::GetCompany();
 
-	FindVehiclesWithOrder(
+	FindVehiclesWithOrder(waypoint_id,
 		[is_deity, owner](const Vehicle *v) { return is_deity || v->owner == owner; },
 		[waypoint_id](const Order *order) { return order->IsType(OT_GOTO_WAYPOINT) && order->GetDestination() == waypoint_id; },
 		[this](const Vehicle *v) { this->AddItem(v->index.base()); }
@@ -124,7 +126,7 @@ ScriptVehicleList_Depot::ScriptVehicleList_Depot(TileIndex tile)
 	bool is_deity = ScriptCompanyMode::IsDeity();
 	::CompanyID owner = ScriptObject::GetCompany();
 
-	FindVehiclesWithOrder(
+	FindVehiclesWithOrder(dest,
 		[is_deity, owner, type](const Vehicle *v) { return (is_deity || v->owner == owner) && v->type == type; },
 		[dest](const Order *order) { return order->IsType(OT_GOTO_DEPOT) && order->GetDestination() == dest; },
 		[this](const Vehicle *v) { this->AddItem(v->index.base()); }
@@ -145,12 +147,9 @@ ScriptVehicleList_Group::ScriptVehicleList_Group(GroupID group_id)
 	EnforceCompanyModeValid_Void();
 	if (!ScriptGroup::IsValidGroup(group_id)) return;
 
-	::CompanyID owner = ScriptObject::GetCompany();
-
-	ScriptList::FillList<Vehicle>(this,
-		[owner](const Vehicle *v) { return v->owner == owner && v->IsPrimaryVehicle(); },
-		[group_id](const Vehicle *v) { return v->group_id == group_id; }
-	);
+	for (VehicleID vehicle : ::Group::Get(group_id)->statistics.vehicles) {
+		this->AddItem(vehicle.base());
+	}
 }
 
 ScriptVehicleList_DefaultGroup::ScriptVehicleList_DefaultGroup(ScriptVehicle::VehicleType vehicle_type)
@@ -160,8 +159,7 @@ ScriptVehicleList_DefaultGroup::ScriptVehicleList_DefaultGroup(ScriptVehicle::Ve
 
 	::CompanyID owner = ScriptObject::GetCompany();
 
-	ScriptList::FillList<Vehicle>(this,
-		[owner](const Vehicle *v) { return v->owner == owner && v->IsPrimaryVehicle(); },
-		[vehicle_type](const Vehicle *v) { return v->type == (::VehicleType)vehicle_type && v->group_id == ScriptGroup::GROUP_DEFAULT; }
-	);
+	for (VehicleID vehicle : GroupStatistics::Get(owner, DEFAULT_GROUP, (::VehicleType)vehicle_type).vehicles) {
+		this->AddItem(vehicle.base());
+	}
 }
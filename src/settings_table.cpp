@@ -43,6 +43,7 @@
 #include "game/game_config.hpp"
 #include "ship.h"
 #include "smallmap_gui.h"
+#include "spritecache_disk.h"
 #include "roadveh.h"
 #include "roadveh_cmd.h"
 #include "vehicle_func.h"
@@ -405,6 +405,8 @@ struct NetworkSettings {
 	std::string last_joined; ///< Last joined server
 	UseRelayService use_relay_service; ///< Use relay service?
 	ParticipateSurvey participate_survey; ///< Participate in the automated survey
+	uint16_t performance_telemetry_interval; ///< Seconds between exports of the performance statistics, 0 to disable.
+	std::string performance_telemetry_file; ///< File to export the performance statistics to, empty for no file.
 
 	bool AdminAuthenticationConfigured() const { return !this->admin_password.empty() || !this->admin_authorized_keys.empty(); }
 };
@@ -613,17 +613,43 @@ static const PixelColour _vehicle_type_colours[6] = {
 	PC_RED, PC_YELLOW, PC_LIGHT_BLUE, PC_WHITE, PC_BLACK, PC_RED
 };
 
-/** Types of legends in the #WID_SM_LEGEND widget. */
-enum SmallMapType : uint8_t {
-	SMT_CONTOUR,
-	SMT_VEHICLES,
-	SMT_INDUSTRY,
-	SMT_LINKSTATS,
-	SMT_ROUTES,
-	SMT_VEGETATION,
-	SMT_OWNER,
-};
-DECLARE_ENUM_AS_ADDABLE(SmallMapType)
+/**
+ * Make sure the cache is allocated and matches the way the smallmap is currently displayed.
+ * @param map_type The mode the smallmap is displayed in.
+ */
+void SmallMapTileCache::Validate(SmallMapType map_type)
+{
+	if (this->importance.size() != Map::Size()) {
+		this->colours.resize(Map::Size());
+		this->importance.assign(Map::Size(), UNCACHED);
+	} else if (this->map_type != map_type || this->land_colour != _settings_client.gui.smallmap_land_colour || this->show_heightmap != _smallmap_show_heightmap) {
+		this->Invalidate();
+	}
+
+	this->map_type = map_type;
+	this->land_colour = _settings_client.gui.smallmap_land_colour;
+	this->show_heightmap = _smallmap_show_heightmap;
+}
+
+SmallMapTileCache _smallmap_tile_cache; ///< Colours of the tiles shown in the smallmap.
+
+/**
+ * Mark the colour of a tile in the smallmap as outdated.
+ * @param tile The tile that has changed.
+ */
+void InvalidateSmallMapTile(TileIndex tile)
+{
+	if (tile.base() < _smallmap_tile_cache.importance.size()) _smallmap_tile_cache.importance[tile.base()] = SmallMapTileCache::UNCACHED;
+}
+
+/**
+ * Mark the colours of all tiles in the smallmap as outdated.
+ * This is for changes to many tiles at once that do not mark the tiles dirty, like a company changing owner.
+ */
+void InvalidateSmallMap()
+{
+	_smallmap_tile_cache.Invalidate();
+}
 
 /** Class managing the smallmap window. */
 class SmallMapWindow : public Window {
@@ -816,6 +842,7 @@ protected:
 			legend[click_pos].show_on_map = !legend[click_pos].show_on_map;
 		}
 
+		_smallmap_tile_cache.Invalidate();
 		if (this->map_type == SMT_INDUSTRY) this->BreakIndustryChainLink();
 	}
 
@@ -1064,6 +1091,8 @@ protected:
 		Blitter *blitter = BlitterFactory::GetCurrentBlitter();
 		AutoRestoreBackup dpi_backup(_cur_dpi, dpi);
 
+		_smallmap_tile_cache.Validate(this->map_type);
+
 		/* If freeform edges are off, draw infinite water off the edges of the map. */
 		const PixelColour map_clear_color = (_settings_game.construction.freeform_edges ? PC_BLACK : PC_WATER);
 		GfxFillRect(dpi->left, dpi->top, dpi->left + dpi->width - 1, dpi->top + dpi->height - 1, map_clear_color);
@@ -1319,86 +1348,107 @@ protected:
 	}
 
 	/**
-	 * Decide which colours to show to the user for a group of tiles.
-	 * @param ta Tile area to investigate.
+	 * Decide which colour to show to the user for a single tile.
+	 * @param ti Tile to investigate.
+	 * @param[out] importance How interesting the tile is to show when it is part of a group of tiles.
 	 * @return Colours to display.
 	 */
-	uint32_t GetTileColours(const TileArea &ta) const
+	uint32_t GetTileColour(TileIndex ti, uint8_t &importance) const
 	{
-		int importance = 0;
-		TileIndex tile = INVALID_TILE; // Position of the most important tile.
-		TileType et = TileType::Void;         // Effective tile type at that position.
-
-		for (TileIndex ti : ta) {
-			TileType ttype = GetTileType(ti);
+		TileType ttype = GetTileType(ti);
 
-			switch (ttype) {
-				case TileType::TunnelBridge: {
-					TransportType tt = GetTunnelBridgeTransportType(ti);
+		switch (ttype) {
+			case TileType::TunnelBridge: {
+				TransportType tt = GetTunnelBridgeTransportType(ti);
 
-					switch (tt) {
-						case TRANSPORT_RAIL: ttype = TileType::Railway; break;
-						case TRANSPORT_ROAD: ttype = TileType::Road;    break;
-						default:             ttype = TileType::Water;   break;
-					}
-					break;
+				switch (tt) {
+					case TRANSPORT_RAIL: ttype = TileType::Railway; break;
+					case TRANSPORT_ROAD: ttype = TileType::Road;    break;
+					default:             ttype = TileType::Water;   break;
 				}
+				break;
+			}
 
-				case TileType::Industry:
-					/* Special handling of industries while in "Industries" smallmap view. */
-					if (this->map_type == SMT_INDUSTRY) {
-						/* If industry is allowed to be seen, use its colour on the map.
-						 * This has the highest priority above any value in _tiletype_importance. */
-						IndustryType type = Industry::GetByTile(ti)->type;
-						if (_legend_from_industries[_industry_to_list_pos[type]].show_on_map) {
-							if (type == _smallmap_industry_highlight) {
-								if (_smallmap_industry_highlight_state) return MKCOLOUR_XXXX(PC_WHITE);
-							} else {
-								return GetIndustrySpec(type)->map_colour.p * 0x01010101;
+			case TileType::Industry:
+				/* Special handling of industries while in "Industries" smallmap view. */
+				if (this->map_type == SMT_INDUSTRY) {
+					/* If industry is allowed to be seen, use its colour on the map.
+					 * This has the highest priority above any value in _tiletype_importance. */
+					IndustryType type = Industry::GetByTile(ti)->type;
+					if (_legend_from_industries[_industry_to_list_pos[type]].show_on_map) {
+						if (type == _smallmap_industry_highlight) {
+							if (_smallmap_industry_highlight_state) {
+								importance = SmallMapTileCache::IMPORTANCE_INDUSTRY;
+								return MKCOLOUR_XXXX(PC_WHITE);
 							}
+						} else {
+							importance = SmallMapTileCache::IMPORTANCE_INDUSTRY;
+							return GetIndustrySpec(type)->map_colour.p * 0x01010101;
 						}
-						/* Otherwise make it disappear */
-						ttype = IsTileOnWater(ti) ? TileType::Water : TileType::Clear;
 					}
-					break;
-
-				default:
-					break;
-			}
+					/* Otherwise make it disappear */
+					ttype = IsTileOnWater(ti) ? TileType::Water : TileType::Clear;
+				}
+				break;
 
-			if (_tiletype_importance[ttype] > importance) {
-				importance = _tiletype_importance[ttype];
-				tile = ti;
-				et = ttype;
-			}
+			default:
+				break;
 		}
 
+		importance = _tiletype_importance[ttype];
+
 		switch (this->map_type) {
 			case SMT_CONTOUR:
-				return GetSmallMapContoursPixels(tile, et);
+				return GetSmallMapContoursPixels(ti, ttype);
 
 			case SMT_VEHICLES:
-				return GetSmallMapVehiclesPixels(et);
+				return GetSmallMapVehiclesPixels(ttype);
 
 			case SMT_INDUSTRY:
-				return GetSmallMapIndustriesPixels(tile, et);
+				return GetSmallMapIndustriesPixels(ti, ttype);
 
 			case SMT_LINKSTATS:
-				return GetSmallMapLinkStatsPixels(tile, et);
+				return GetSmallMapLinkStatsPixels(ti, ttype);
 
 			case SMT_ROUTES:
-				return GetSmallMapRoutesPixels(tile, et);
+				return GetSmallMapRoutesPixels(ti, ttype);
 
 			case SMT_VEGETATION:
-				return GetSmallMapVegetationPixels(tile, et);
+				return GetSmallMapVegetationPixels(ti, ttype);
 
 			case SMT_OWNER:
-				return GetSmallMapOwnerPixels(tile, et, IncludeHeightmap::IfEnabled);
+				return GetSmallMapOwnerPixels(ti, ttype, IncludeHeightmap::IfEnabled);
 
 			default: NOT_REACHED();
 		}
 	}
 
+	/**
+	 * Decide which colours to show to the user for a group of tiles.
+	 * The colour of the first most important tile of the group is used.
+	 * @param ta Tile area to investigate.
+	 * @return Colours to display.
+	 */
+	uint32_t GetTileColours(const TileArea &ta) const
+	{
+		uint8_t importance = 0;
+		uint32_t colour = 0;
+
+		for (TileIndex ti : ta) {
+			uint8_t &tile_importance = _smallmap_tile_cache.importance[ti.base()];
+			if (tile_importance == SmallMapTileCache::UNCACHED) {
+				_smallmap_tile_cache.colours[ti.base()] = this->GetTileColour(ti, tile_importance);
+			}
+
+			if (tile_importance > importance) {
+				importance = tile_importance;
+				colour = _smallmap_tile_cache.colours[ti.base()];
+			}
+		}
+
+		return colour;
+	}
+
 	/**
 	 * Determines the mouse position on the legend.
 	 * @param pt Mouse position.
@@ -1439,6 +1489,7 @@ protected:
 		if (_smallmap_industry_highlight == IT_INVALID) return;
 
 		_smallmap_industry_highlight_state = !_smallmap_industry_highlight_state;
+		_smallmap_tile_cache.Invalidate();
 
 		this->UpdateLinks();
 		this->SetDirty();
@@ -1515,6 +1566,7 @@ public:
 	void Close([[maybe_unused]] int data) override
 	{
 		this->BreakIndustryChainLink();
+		_smallmap_tile_cache.Clear();
 		this->Window::Close();
 	}
 
@@ -1804,6 +1856,7 @@ public:
 				for (;!tbl->end && tbl->legend != STR_LINKGRAPH_LEGEND_UNUSED; ++tbl) {
 					tbl->show_on_map = (widget == WID_SM_ENABLE_ALL);
 				}
+				_smallmap_tile_cache.Invalidate();
 				if (this->map_type == SMT_LINKSTATS) this->SetOverlayCargoMask();
 				this->SetDirty();
 				break;
@@ -1851,6 +1904,7 @@ public:
 
 			default: NOT_REACHED();
 		}
+		_smallmap_tile_cache.Invalidate();
 		this->SetDirty();
 	}
 
@@ -1898,6 +1952,7 @@ public:
 		if (new_highlight != _smallmap_industry_highlight) {
 			_smallmap_industry_highlight = new_highlight;
 			_smallmap_industry_highlight_state = true;
+			_smallmap_tile_cache.Invalidate();
 			this->SetDirty();
 		}
 	}
@@ -10,6 +10,7 @@
 #ifndef SMALLMAP_GUI_H
 #define SMALLMAP_GUI_H
 
+#include "core/enum_type.hpp"
 #include "core/geometry_type.hpp"
 #include "station_type.h"
 #include "tile_type.h"
@@ -22,6 +23,8 @@ void BuildIndustriesLegend();
 void ShowSmallMap();
 void BuildLandLegend();
 void BuildOwnerLegend();
+void InvalidateSmallMapTile(TileIndex tile);
+void InvalidateSmallMap();
 
 /** Enum for how to include the heightmap pixels/colours in small map related functions */
 enum class IncludeHeightmap : uint8_t {
@@ -34,4 +37,51 @@ uint32_t GetSmallMapOwnerPixels(TileIndex tile, TileType t, IncludeHeightmap inc
 
 Point GetSmallMapStationMiddle(const Window *w, const Station *st);
 
+/** Types of legends in the #WID_SM_LEGEND widget. */
+enum SmallMapType : uint8_t {
+	SMT_CONTOUR,
+	SMT_VEHICLES,
+	SMT_INDUSTRY,
+	SMT_LINKSTATS,
+	SMT_ROUTES,
+	SMT_VEGETATION,
+	SMT_OWNER,
+};
+DECLARE_ENUM_AS_ADDABLE(SmallMapType)
+
+/**
+ * Cache of the colour of each tile in the smallmap mode that is currently displayed.
+ * Tiles are invalidated one by one via #InvalidateSmallMapTile whenever they are marked dirty
+ * for the viewports, so redrawing the smallmap only has to recompute the tiles that changed.
+ * Changes to many tiles at once that do not mark them dirty use #InvalidateSmallMap instead.
+ */
+struct SmallMapTileCache {
+	static constexpr uint8_t UNCACHED = UINT8_MAX; ///< Importance of a tile whose colour has not been determined yet.
+	static constexpr uint8_t IMPORTANCE_INDUSTRY = UINT8_MAX - 1; ///< Importance of a visible industry in the industry mode, which trumps everything else.
+
+	std::vector<uint32_t> colours; ///< Colour of each tile.
+	std::vector<uint8_t> importance; ///< Importance of each tile, or #UNCACHED when its colour needs to be determined.
+
+	SmallMapType map_type = SMT_CONTOUR; ///< Mode the colours were determined for.
+	uint8_t land_colour = 0; ///< Land colour scheme the colours were determined with.
+	bool show_heightmap = false; ///< Whether the heightmap was shown when the colours were determined.
+
+	/** Mark all tiles as needing their colour to be determined again. */
+	void Invalidate()
+	{
+		std::fill(this->importance.begin(), this->importance.end(), UNCACHED);
+	}
+
+	/** Release the memory of the cache. */
+	void Clear()
+	{
+		this->colours = {};
+		this->importance = {};
+	}
+
+	void Validate(SmallMapType map_type);
+};
+
+extern SmallMapTileCache _smallmap_tile_cache;
+
 #endif /* SMALLMAP_GUI_H */
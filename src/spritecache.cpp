@@ -14,11 +14,16 @@
 #include "strings_func.h"
 #include "zoom_func.h"
 #include "settings_type.h"
+#include "palette_func.h"
 #include "blitter/factory.hpp"
 #include "core/math_func.hpp"
 #include "video/video_driver.hpp"
 #include "spritecache.h"
 #include "spritecache_internal.h"
+#include "spritecache_disk.h"
+#include "thread.h"
+#include <condition_variable>
+#include <unordered_set>
 
 #include "table/sprites.h"
 #include "table/palette_convert.h"
@@ -31,14 +36,58 @@ uint _sprite_cache_size = 4;
 
 static std::vector<SpriteCache> _spritecache;
 static size_t _spritecache_bytes_used = 0;
-static uint32_t _sprite_lru_counter;
 static std::vector<std::unique_ptr<SpriteFile>> _sprite_files;
 
+static SpriteID _sprite_lru_oldest = SpriteCache::LRU_END; ///< Least recently used sprite with data in the cache.
+static SpriteID _sprite_lru_newest = SpriteCache::LRU_END; ///< Most recently used sprite with data in the cache.
+static SpriteCacheStats _sprite_cache_stats; ///< Statistics of the sprite cache; the number of sprites and bytes are filled in on request.
+
 static inline SpriteCache *GetSpriteCache(uint index)
 {
 	return &_spritecache[index];
 }
 
+/**
+ * Remove a sprite from the list of sprites with data, if it is in there.
+ * @param index The sprite to remove.
+ */
+static void UnlinkSpriteLRU(SpriteID index)
+{
+	SpriteCache *sc = GetSpriteCache(index);
+	if (sc->lru_older == SpriteCache::LRU_END && sc->lru_newer == SpriteCache::LRU_END && _sprite_lru_oldest != index) return;
+
+	if (sc->lru_older == SpriteCache::LRU_END) {
+		_sprite_lru_oldest = sc->lru_newer;
+	} else {
+		GetSpriteCache(sc->lru_older)->lru_newer = sc->lru_newer;
+	}
+	if (sc->lru_newer == SpriteCache::LRU_END) {
+		_sprite_lru_newest = sc->lru_older;
+	} else {
+		GetSpriteCache(sc->lru_newer)->lru_older = sc->lru_older;
+	}
+	sc->lru_older = sc->lru_newer = SpriteCache::LRU_END;
+	_sprite_cache_stats.sprites--;
+}
+
+/**
+ * Add a sprite as most recently used sprite to the list of sprites with data.
+ * @param index The sprite to add; it may not be in the list already.
+ */
+static void LinkSpriteLRU(SpriteID index)
+{
+	SpriteCache *sc = GetSpriteCache(index);
+	sc->lru_older = _sprite_lru_newest;
+	sc->lru_newer = SpriteCache::LRU_END;
+	if (_sprite_lru_newest == SpriteCache::LRU_END) {
+		_sprite_lru_oldest = index;
+	} else {
+		GetSpriteCache(_sprite_lru_newest)->lru_newer = index;
+	}
+	_sprite_lru_newest = index;
+	_sprite_cache_stats.sprites++;
+}
+
 SpriteCache *AllocateSpriteCache(uint index)
 {
 	if (index >= _spritecache.size()) {
@@ -398,8 +447,9 @@ static bool ResizeSprites(SpriteLoader::SpriteCollection &sprite, ZoomLevels spr
 	}
 
 	/* Replace sprites with higher resolution than the desired maximum source resolution with scaled up sprites, if not already done. */
-	if (first_avail < _settings_client.gui.sprite_zoom_min) {
-		for (ZoomLevel zoom = std::min(ZoomLevel::Normal, _settings_client.gui.sprite_zoom_min); zoom > ZoomLevel::Min; --zoom) {
+	ZoomLevel sprite_zoom_min = GetSpriteLoadSettings().sprite_zoom_min;
+	if (first_avail < sprite_zoom_min) {
+		for (ZoomLevel zoom = std::min(ZoomLevel::Normal, sprite_zoom_min); zoom > ZoomLevel::Min; --zoom) {
 			ResizeSpriteIn(sprite, zoom, zoom - 1);
 		}
 	}
@@ -445,28 +495,21 @@ static void *ReadRecolourSprite(SpriteFile &file, size_t file_pos, uint num, Spr
 }
 
 /**
- * Read a sprite from disk.
- * @param sc          Location of sprite.
- * @param id          Sprite number.
- * @param sprite_type Type of sprite.
- * @param allocator   Allocator function to use.
- * @param encoder     Sprite encoder to use.
- * @return Read sprite data.
+ * Load a sprite from a file and encode it.
+ * This does not touch the sprite cache, so it may be called from other threads than the main thread,
+ * as long as each thread uses its own view of the file.
+ * @param file          File to read the sprite from.
+ * @param file_pos      Position of the sprite in the file.
+ * @param sprite_type   Type of sprite.
+ * @param control_flags Control flags of the sprite.
+ * @param allocator     Allocator function to use.
+ * @param encoder       Sprite encoder to use.
+ * @param background    Whether the sprite is decoded on another thread than the main thread.
+ *                      Converting a sprite to the palette is left to the main thread, as that fills shared lookup tables.
+ * @return Read sprite data, or \c nullptr when the sprite could not be loaded.
  */
-static void *ReadSprite(const SpriteCache *sc, SpriteID id, SpriteType sprite_type, SpriteAllocator &allocator, SpriteEncoder *encoder)
+static void *DecodeSprite(SpriteFile &file, size_t file_pos, SpriteType sprite_type, SpriteCacheCtrlFlags control_flags, SpriteAllocator &allocator, SpriteEncoder *encoder, bool background = false)
 {
-	/* Use current blitter if no other sprite encoder is given. */
-	if (encoder == nullptr) encoder = BlitterFactory::GetCurrentBlitter();
-
-	SpriteFile &file = *sc->file;
-	size_t file_pos = sc->file_pos;
-
-	assert(sprite_type != SpriteType::Recolour);
-	assert(IsMapgenSpriteID(id) == (sprite_type == SpriteType::MapGen));
-	assert(sc->type == sprite_type);
-
-	Debug(sprite, 9, "Load sprite {}", id);
-
 	SpriteLoader::SpriteCollection sprite;
 	ZoomLevels sprite_avail;
 	ZoomLevels avail_8bpp;
@@ -475,22 +518,19 @@ static void *ReadSprite(const SpriteCache *sc, SpriteID id, SpriteType sprite_ty
 	SpriteLoaderGrf sprite_loader(file.GetContainerVersion());
 	if (sprite_type != SpriteType::MapGen && encoder->Is32BppSupported()) {
 		/* Try for 32bpp sprites first. */
-		sprite_avail = sprite_loader.LoadSprite(sprite, file, file_pos, sprite_type, true, sc->control_flags, avail_8bpp, avail_32bpp);
+		sprite_avail = sprite_loader.LoadSprite(sprite, file, file_pos, sprite_type, true, control_flags, avail_8bpp, avail_32bpp);
 	}
 	if (sprite_avail.None()) {
-		sprite_avail = sprite_loader.LoadSprite(sprite, file, file_pos, sprite_type, false, sc->control_flags, avail_8bpp, avail_32bpp);
+		sprite_avail = sprite_loader.LoadSprite(sprite, file, file_pos, sprite_type, false, control_flags, avail_8bpp, avail_32bpp);
 		if (sprite_type == SpriteType::Normal && avail_32bpp.Any() && !encoder->Is32BppSupported() && sprite_avail.None()) {
+			if (background) return nullptr;
 			/* No 8bpp available, try converting from 32bpp. */
 			SpriteLoaderMakeIndexed make_indexed(sprite_loader);
-			sprite_avail = make_indexed.LoadSprite(sprite, file, file_pos, sprite_type, true, sc->control_flags, sprite_avail, avail_32bpp);
+			sprite_avail = make_indexed.LoadSprite(sprite, file, file_pos, sprite_type, true, control_flags, sprite_avail, avail_32bpp);
 		}
 	}
 
-	if (sprite_avail.None()) {
-		if (sprite_type == SpriteType::MapGen) return nullptr;
-		if (id == SPR_IMG_QUERY) UserError("Okay... something went horribly wrong. I couldn't load the fallback sprite. What should I do?");
-		return (void*)GetRawSprite(SPR_IMG_QUERY, SpriteType::Normal, &allocator, encoder);
-	}
+	if (sprite_avail.None()) return nullptr;
 
 	if (sprite_type == SpriteType::MapGen) {
 		/* Ugly hack to work around the problem that the old landscape
@@ -521,10 +561,7 @@ static void *ReadSprite(const SpriteCache *sc, SpriteID id, SpriteType sprite_ty
 		return s;
 	}
 
-	if (!ResizeSprites(sprite, sprite_avail, encoder)) {
-		if (id == SPR_IMG_QUERY) UserError("Okay... something went horribly wrong. I couldn't resize the fallback sprite. What should I do?");
-		return (void*)GetRawSprite(SPR_IMG_QUERY, SpriteType::Normal, &allocator, encoder);
-	}
+	if (!ResizeSprites(sprite, sprite_avail, encoder)) return nullptr;
 
 	if (sprite_type == SpriteType::Font && _font_zoom != ZoomLevel::Min) {
 		/* Make ZoomLevel::Min the desired font zoom level. */
@@ -534,6 +571,33 @@ static void *ReadSprite(const SpriteCache *sc, SpriteID id, SpriteType sprite_ty
 	return encoder->Encode(sprite_type, sprite, allocator);
 }
 
+/**
+ * Read a sprite from disk.
+ * @param sc          Location of sprite.
+ * @param id          Sprite number.
+ * @param sprite_type Type of sprite.
+ * @param allocator   Allocator function to use.
+ * @param encoder     Sprite encoder to use.
+ * @return Read sprite data.
+ */
+static void *ReadSprite(const SpriteCache *sc, SpriteID id, SpriteType sprite_type, SpriteAllocator &allocator, SpriteEncoder *encoder)
+{
+	/* Use current blitter if no other sprite encoder is given. */
+	if (encoder == nullptr) encoder = BlitterFactory::GetCurrentBlitter();
+
+	assert(sprite_type != SpriteType::Recolour);
+	assert(IsMapgenSpriteID(id) == (sprite_type == SpriteType::MapGen));
+	assert(sc->type == sprite_type);
+
+	Debug(sprite, 9, "Load sprite {}", id);
+
+	void *s = DecodeSprite(*sc->file, sc->file_pos, sprite_type, sc->control_flags, allocator, encoder);
+	if (s != nullptr || sprite_type == SpriteType::MapGen) return s;
+
+	if (id == SPR_IMG_QUERY) UserError("Okay... something went horribly wrong. I couldn't load the fallback sprite. What should I do?");
+	return GetRawSprite(SPR_IMG_QUERY, SpriteType::Normal, &allocator, encoder);
+}
+
 struct GrfSpriteOffset {
 	size_t file_pos = 0;
 	SpriteCacheCtrlFlags control_flags{};
@@ -671,7 +735,6 @@ bool LoadNextSprite(SpriteID load_index, SpriteFile &file, uint file_sprite_id)
 	sc->file = &file;
 	sc->file_pos = file_pos;
 	sc->length = num;
-	sc->lru = 0;
 	sc->id = file_sprite_id;
 	sc->type = type;
 	sc->warned = false;
@@ -695,96 +758,273 @@ void DupSprite(SpriteID old_spr, SpriteID new_spr)
 	scnew->control_flags = scold->control_flags;
 }
 
+/** Copy of the settings and the palette to load sprites with on the prefetch thread. */
+struct SpritePrefetchSettings : SpriteLoadSettings {
+	Palette palette_copy; ///< The copy of the palette the settings refer to.
+
+	/**
+	 * Copy the settings and the palette.
+	 * @param settings The settings to copy.
+	 */
+	explicit SpritePrefetchSettings(const SpriteLoadSettings &settings) : SpriteLoadSettings(settings), palette_copy(*settings.palette)
+	{
+		this->palette = &this->palette_copy;
+	}
+
+	SpritePrefetchSettings(const SpritePrefetchSettings &) = delete;
+	SpritePrefetchSettings &operator=(const SpritePrefetchSettings &) = delete;
+};
+
+/** A sprite that is decoded in the background by the #SpritePrefetcher. */
+struct SpritePrefetchJob {
+	SpriteID sprite; ///< The sprite.
+	SpriteFile *file; ///< File the sprite is in.
+	size_t file_pos; ///< Position of the sprite in the file.
+	SpriteCacheCtrlFlags control_flags; ///< Control flags of the sprite.
+	std::shared_ptr<const SpritePrefetchSettings> settings; ///< The settings when the sprite was queued, shared by all sprites queued at once.
+	UniquePtrSpriteAllocator result{}; ///< The decoded sprite; empty when decoding failed.
+};
+
 /**
- * Delete entries from the sprite cache to remove the requested number of bytes.
- * Sprite data is removed in order of LRU values.
- * The total number of bytes removed may be larger than the number requested.
- * @param to_remove Requested number of bytes to remove.
+ * Decodes normal sprites on a background thread, and the worker threads, before they are drawn.
+ * The decoded sprites are added to the sprite cache on the main thread by #AddPrefetchedSprites.
  */
-static void DeleteEntriesFromSpriteCache(size_t to_remove)
-{
-	const size_t initial_in_use = _spritecache_bytes_used;
+class SpritePrefetcher {
+	std::mutex lock; ///< Lock for everything but #requested.
+	std::condition_variable work_available; ///< Signalled when jobs are queued or the thread has to exit.
+	std::condition_variable idle; ///< Signalled when the thread is done with a batch of jobs.
+	std::vector<SpritePrefetchJob> queued; ///< Jobs nobody is working on yet.
+	std::vector<SpritePrefetchJob> finished; ///< Jobs that are done, but not yet added to the sprite cache.
+	SpriteEncoder *encoder = nullptr; ///< The encoder of the queued jobs.
+	std::thread thread; ///< The prefetch thread, started when the first jobs are queued.
+	bool busy = false; ///< Whether the thread is working on a batch of jobs.
+	bool exit = false; ///< Whether the thread has to exit.
+
+	/** Main loop of the prefetch thread. */
+	void ThreadMain()
+	{
+		std::unique_lock<std::mutex> guard(this->lock);
+		for (;;) {
+			this->work_available.wait(guard, [this]() { return this->exit || !this->queued.empty(); });
+			if (this->exit) return;
+
+			std::vector<SpritePrefetchJob> jobs = std::move(this->queued);
+			this->queued.clear();
+			SpriteEncoder *encoder = this->encoder;
+			this->busy = true;
+			guard.unlock();
+
+			ParallelFor(jobs.size(), 16, [&jobs, encoder](size_t begin, size_t end) {
+				/* Problems with the sprite are reported when the main thread tries to load it again. */
+				bool report_errors = _report_sprite_errors;
+				_report_sprite_errors = false;
+				for (size_t i = begin; i < end; i++) {
+					SpritePrefetchJob &job = jobs[i];
+					SpriteFile file(*job.file, SpriteFile::View{});
+					_sprite_load_settings = job.settings.get();
+					if (DecodeSprite(file, job.file_pos, SpriteType::Normal, job.control_flags, job.result, encoder, true) == nullptr) job.result.data.reset();
+				}
+				_sprite_load_settings = nullptr;
+				_report_sprite_errors = report_errors;
+			});
+
+			guard.lock();
+			std::move(jobs.begin(), jobs.end(), std::back_inserter(this->finished));
+			this->busy = false;
+			this->idle.notify_all();
+		}
+	}
 
-	struct SpriteInfo {
-		uint32_t lru;
-		SpriteID id;
-		size_t size;
+public:
+	std::unordered_set<SpriteID> requested; ///< Sprites that are queued or finished; only used by the main thread.
 
-		bool operator<(const SpriteInfo &other) const
+	~SpritePrefetcher()
+	{
+		if (!this->thread.joinable()) return;
 		{
-			return this->lru < other.lru;
+			std::lock_guard<std::mutex> guard(this->lock);
+			this->exit = true;
 		}
-	};
+		this->work_available.notify_all();
+		this->thread.join();
+	}
 
-	std::vector<SpriteInfo> candidates; // max heap, ordered by LRU
-	size_t candidate_bytes = 0;         // total bytes that would be released when clearing all sprites in candidates
+	/**
+	 * Queue sprites to be decoded.
+	 * @param jobs The sprites to decode; they are moved away when queued.
+	 * @param encoder The encoder to use for the sprites.
+	 * @return Whether the sprites are queued.
+	 */
+	bool Queue(std::vector<SpritePrefetchJob> &jobs, SpriteEncoder *encoder)
+	{
+		if (!this->thread.joinable() && !StartNewThread(&this->thread, "ottd:sprites", [this]() { this->ThreadMain(); })) return false;
 
-	auto push = [&](SpriteInfo info) {
-		candidates.push_back(info);
-		std::push_heap(candidates.begin(), candidates.end());
-		candidate_bytes += info.size;
-	};
+		{
+			std::lock_guard<std::mutex> guard(this->lock);
+			/* Jobs for another encoder are of no use anymore. */
+			if (encoder != this->encoder) this->queued.clear();
+			this->encoder = encoder;
+			std::move(jobs.begin(), jobs.end(), std::back_inserter(this->queued));
+		}
+		this->work_available.notify_one();
+		return true;
+	}
 
-	auto pop = [&]() {
-		candidate_bytes -= candidates.front().size;
-		std::pop_heap(candidates.begin(), candidates.end());
-		candidates.pop_back();
-	};
+	/**
+	 * Take the jobs that are done.
+	 * @return The jobs.
+	 */
+	std::vector<SpritePrefetchJob> TakeFinished()
+	{
+		std::lock_guard<std::mutex> guard(this->lock);
+		return std::move(this->finished);
+	}
 
-	SpriteID i = 0;
-	for (; i != static_cast<SpriteID>(_spritecache.size()) && candidate_bytes < to_remove; i++) {
-		const SpriteCache *sc = GetSpriteCache(i);
-		if (sc->ptr != nullptr) {
-			push({ sc->lru, i, sc->length });
-			if (candidate_bytes >= to_remove) break;
-		}
+	/** Forget all queued and finished jobs, and wait for the jobs being worked on. */
+	void Cancel()
+	{
+		std::unique_lock<std::mutex> guard(this->lock);
+		this->queued.clear();
+		this->idle.wait(guard, [this]() { return !this->busy; });
+		this->finished.clear();
+		this->requested.clear();
 	}
-	/* candidates now contains enough bytes to meet to_remove.
-	 * only sprites with LRU values <= the maximum (i.e. the top of the heap) need to be considered */
-	for (; i != static_cast<SpriteID>(_spritecache.size()); i++) {
-		const SpriteCache *sc = GetSpriteCache(i);
-		if (sc->ptr != nullptr && sc->lru <= candidates.front().lru) {
-			push({ sc->lru, i, sc->length });
-			while (!candidates.empty() && candidate_bytes - candidates.front().size >= to_remove) {
-				pop();
-			}
-		}
+};
+
+static SpritePrefetcher _sprite_prefetcher; ///< The decoder of sprites that are likely needed soon.
+
+/** Maximum number of sprites that are queued or decoded, but not yet added to the sprite cache. */
+static constexpr size_t MAX_PREFETCH_SPRITES = 4096;
+
+/**
+ * Check whether decoding sprites in the background is of any use.
+ * @return True iff there is a screen to draw sprites on and more than one processor to decode them.
+ */
+bool CanPrefetchSprites()
+{
+	return BlitterFactory::GetCurrentBlitter()->GetScreenDepth() != 0 && std::thread::hardware_concurrency() > 1;
+}
+
+/**
+ * Decode sprites in the background, so they are in the sprite cache when they need to be drawn.
+ * Only normal sprites from memory mapped files are prefetched; other sprites are loaded when they are needed.
+ * @param sprites The sprites that are likely to be drawn soon.
+ */
+void PrefetchSprites(std::span<const SpriteID> sprites)
+{
+	if (!CanPrefetchSprites()) return;
+
+	std::vector<SpritePrefetchJob> jobs;
+	std::shared_ptr<const SpritePrefetchSettings> settings;
+	for (SpriteID sprite : sprites) {
+		if (_sprite_prefetcher.requested.size() + jobs.size() >= MAX_PREFETCH_SPRITES) break;
+		if (!SpriteExists(sprite)) continue;
+
+		const SpriteCache *sc = GetSpriteCache(sprite);
+		if (sc->ptr != nullptr || sc->type != SpriteType::Normal || !sc->file->IsMapped()) continue;
+		if (!_sprite_prefetcher.requested.insert(sprite).second) continue;
+
+		if (settings == nullptr) settings = std::make_shared<const SpritePrefetchSettings>(SpriteLoadSettings::Current());
+		jobs.push_back({sprite, sc->file, sc->file_pos, sc->control_flags, settings});
 	}
+	if (jobs.empty()) return;
 
-	for (const auto &it : candidates) {
-		GetSpriteCache(it.id)->ClearSpriteData();
+	Debug(sprite, 6, "Prefetching {} sprites", jobs.size());
+	if (_sprite_prefetcher.Queue(jobs, BlitterFactory::GetCurrentBlitter())) return;
+
+	/* Without a thread nothing will be decoded, so nothing is requested. */
+	for (const SpritePrefetchJob &job : jobs) _sprite_prefetcher.requested.erase(job.sprite);
+}
+
+/**
+ * Forget about the sprites that are being prefetched.
+ * This has to be called before sprite files are closed, the sprites are moved or the blitter changes.
+ */
+void CancelSpritePrefetch()
+{
+	_sprite_prefetcher.Cancel();
+}
+
+/**
+ * Add the sprites the prefetcher has decoded to the sprite cache.
+ * They are added as most recently used sprites, as they are about to be drawn.
+ * @param jobs The jobs the prefetcher finished.
+ */
+static void AddPrefetchedSprites(std::vector<SpritePrefetchJob> &jobs)
+{
+	for (SpritePrefetchJob &job : jobs) {
+		_sprite_prefetcher.requested.erase(job.sprite);
+		if (job.result.data == nullptr || !SpriteExists(job.sprite)) continue;
+
+		/* The sprite might have been loaded, or replaced, since it was queued. */
+		SpriteCache *sc = GetSpriteCache(job.sprite);
+		if (sc->ptr != nullptr || sc->type != SpriteType::Normal || sc->file != job.file || sc->file_pos != job.file_pos) continue;
+
+		StoreSpriteInDiskCache(*sc->file, sc->file_pos, SpriteType::Normal, {job.result.data.get(), job.result.size});
+		sc->ptr = std::move(job.result.data);
+		sc->length = static_cast<uint32_t>(job.result.size);
+		_spritecache_bytes_used += sc->length;
+		LinkSpriteLRU(job.sprite);
+		_sprite_cache_stats.prefetched++;
 	}
+}
+
+/**
+ * Delete entries from the sprite cache to remove the requested number of bytes.
+ * Sprite data is removed starting with the least recently used sprite.
+ * The total number of bytes removed may be larger than the number requested.
+ * @param to_remove Requested number of bytes to remove.
+ */
+static void DeleteEntriesFromSpriteCache(size_t to_remove)
+{
+	const size_t initial_in_use = _spritecache_bytes_used;
+
+	size_t deleted = 0;
+	size_t freed = 0;
+	while (freed < to_remove && _sprite_lru_oldest != SpriteCache::LRU_END) {
+		SpriteCache *sc = GetSpriteCache(_sprite_lru_oldest);
+		freed += sc->length;
+		sc->ClearSpriteData();
+		deleted++;
+	}
+	_sprite_cache_stats.evictions += deleted;
 
 	Debug(sprite, 3, "DeleteEntriesFromSpriteCache, deleted: {}, freed: {}, in use: {} --> {}, requested: {}",
-			candidates.size(), candidate_bytes, initial_in_use, _spritecache_bytes_used, to_remove);
+			deleted, freed, initial_in_use, _spritecache_bytes_used, to_remove);
 }
 
 void IncreaseSpriteLRU()
 {
+	std::vector<SpritePrefetchJob> prefetched = _sprite_prefetcher.TakeFinished();
+	size_t prefetched_size = 0;
+	for (const SpritePrefetchJob &job : prefetched) {
+		if (job.result.data != nullptr) prefetched_size += job.result.size;
+	}
+
+	/* Make room before adding the prefetched sprites, so they are not the ones that are removed. */
 	int bpp = BlitterFactory::GetCurrentBlitter()->GetScreenDepth();
 	uint target_size = (bpp > 0 ? _sprite_cache_size * bpp / 8 : 1) * 1024 * 1024;
-	if (_spritecache_bytes_used > target_size) {
-		DeleteEntriesFromSpriteCache(_spritecache_bytes_used - target_size + 512 * 1024);
+	if (_spritecache_bytes_used + prefetched_size > target_size) {
+		DeleteEntriesFromSpriteCache(_spritecache_bytes_used + prefetched_size - target_size + 512 * 1024);
 	}
 
-	if (_sprite_lru_counter >= 0xC0000000) {
-		Debug(sprite, 3, "Fixing lru {}, inuse={}", _sprite_lru_counter, _spritecache_bytes_used);
+	AddPrefetchedSprites(prefetched);
+}
 
-		for (SpriteCache &sc : _spritecache) {
-			if (sc.ptr != nullptr) {
-				if (sc.lru > 0x80000000) {
-					sc.lru -= 0x80000000;
-				} else {
-					sc.lru = 0;
-				}
-			}
-		}
-		_sprite_lru_counter -= 0x80000000;
-	}
+/**
+ * Get the statistics about the use of the sprite cache.
+ * @return The statistics.
+ */
+SpriteCacheStats GetSpriteCacheStats()
+{
+	SpriteCacheStats stats = _sprite_cache_stats;
+	stats.bytes = _spritecache_bytes_used;
+	return stats;
 }
 
 void SpriteCache::ClearSpriteData()
 {
+	UnlinkSpriteLRU(static_cast<SpriteID>(this - _spritecache.data()));
 	_spritecache_bytes_used -= this->length;
 	this->ptr.reset();
 }
@@ -871,20 +1111,29 @@ void *GetRawSprite(SpriteID sprite, SpriteType type, SpriteAllocator *allocator,
 	if (allocator == nullptr && encoder == nullptr) {
 		/* Load sprite into/from spritecache */
 
-		/* Update LRU */
-		sc->lru = ++_sprite_lru_counter;
-
-		/* Load the sprite, if it is not loaded, yet */
-		if (sc->ptr == nullptr) {
+		if (sc->ptr != nullptr) {
+			/* Mark the sprite as most recently used. */
+			_sprite_cache_stats.hits++;
+			if (sprite != _sprite_lru_newest) {
+				UnlinkSpriteLRU(sprite);
+				LinkSpriteLRU(sprite);
+			}
+		} else {
+			/* Load the sprite, as it is not loaded yet. */
+			_sprite_cache_stats.misses++;
 			UniquePtrSpriteAllocator cache_allocator;
 			if (sc->type == SpriteType::Recolour) {
 				ReadRecolourSprite(*sc->file, sc->file_pos, sc->length, cache_allocator);
-			} else {
+			} else if (sc->type != SpriteType::Normal) {
+				ReadSprite(sc, sprite, type, cache_allocator, nullptr);
+			} else if (!LoadSpriteFromDiskCache(*sc->file, sc->file_pos, type, cache_allocator)) {
 				ReadSprite(sc, sprite, type, cache_allocator, nullptr);
+				StoreSpriteInDiskCache(*sc->file, sc->file_pos, type, {cache_allocator.data.get(), cache_allocator.size});
 			}
 			sc->ptr = std::move(cache_allocator.data);
 			sc->length = static_cast<uint32_t>(cache_allocator.size);
 			_spritecache_bytes_used += sc->length;
+			LinkSpriteLRU(sprite);
 		}
 
 		return static_cast<void *>(sc->ptr.get());
@@ -900,8 +1149,12 @@ void GfxInitSpriteMem()
 	_spritecache.clear();
 	_spritecache.shrink_to_fit();
 
+	CancelSpritePrefetch();
+	CloseSpriteDiskCache();
 	_sprite_files.clear();
 	_spritecache_bytes_used = 0;
+	_sprite_lru_oldest = _sprite_lru_newest = SpriteCache::LRU_END;
+	_sprite_cache_stats.sprites = 0;
 }
 
 /**
@@ -910,6 +1163,8 @@ void GfxInitSpriteMem()
  */
 void GfxClearSpriteCache()
 {
+	CancelSpritePrefetch();
+
 	/* Clear sprite ptr for all cached items */
 	for (SpriteCache &sc : _spritecache) {
 		if (sc.ptr != nullptr) sc.ClearSpriteData();
@@ -930,4 +1185,18 @@ void GfxClearFontSpriteCache()
 	}
 }
 
-/* static */ SpriteCollMap<ReusableBuffer<SpriteLoader::CommonPixel>> SpriteLoader::Sprite::buffer;
+/* static */ thread_local SpriteCollMap<ReusableBuffer<SpriteLoader::CommonPixel>> SpriteLoader::Sprite::buffer;
+
+thread_local const SpriteLoadSettings *_sprite_load_settings = nullptr; ///< The copy of the settings to load sprites with on this thread, if any.
+
+/**
+ * Get the current settings and palette to load sprites with. This refers to the
+ * palette in use, so it may only be called from the main thread.
+ * @return The settings.
+ */
+/* static */ const SpriteLoadSettings &SpriteLoadSettings::Current()
+{
+	static SpriteLoadSettings current{};
+	current = {_settings_client.gui.sprite_zoom_min, _settings_client.gui.zoom_min, _settings_client.gui.zoom_max, &_cur_palette};
+	return current;
+}
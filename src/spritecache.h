@@ -16,6 +16,16 @@
 
 extern uint _sprite_cache_size;
 
+/** Statistics about the use of the sprite cache. */
+struct SpriteCacheStats {
+	uint64_t hits = 0; ///< Number of requests for sprites that were in the cache.
+	uint64_t misses = 0; ///< Number of requests for sprites that had to be loaded.
+	uint64_t evictions = 0; ///< Number of sprites removed from the cache to stay within its size.
+	uint64_t prefetched = 0; ///< Number of sprites decoded in the background and added to the cache.
+	size_t sprites = 0; ///< Number of sprites in the cache.
+	size_t bytes = 0; ///< Number of bytes used by the sprites in the cache.
+};
+
 /** SpriteAllocator that allocates memory via a unique_ptr array. */
 class UniquePtrSpriteAllocator : public SpriteAllocator {
 public:
@@ -51,6 +61,10 @@ void GfxInitSpriteMem();
 void GfxClearSpriteCache();
 void GfxClearFontSpriteCache();
 void IncreaseSpriteLRU();
+SpriteCacheStats GetSpriteCacheStats();
+bool CanPrefetchSprites();
+void PrefetchSprites(std::span<const SpriteID> sprites);
+void CancelSpritePrefetch();
 
 SpriteFile &OpenCachedSpriteFile(const std::string &filename, Subdirectory subdir, bool palette_remap);
 std::span<const std::unique_ptr<SpriteFile>> GetCachedSpriteFiles();
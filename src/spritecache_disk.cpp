@@ -0,0 +1,278 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/**
+ * @file spritecache_disk.cpp Keeping encoded sprites on disk between runs.
+ *
+ * For every sprite file there is a disk cache file in the personal directory, with the sprites
+ * of that sprite file as they were encoded by the blitter. The name of the disk cache file contains
+ * the MD5 sum of the sprite file, and its header everything else the encoded sprites depend on,
+ * so a changed sprite file or different settings simply result in using another disk cache file.
+ * Sprites are appended to the disk cache file when they are encoded for the first time. The disk
+ * cache file is read through RandomAccessFile, so it is memory mapped where possible.
+ */
+
+#include "stdafx.h"
+#include "spritecache_disk.h"
+
+#include "3rdparty/md5/md5.h"
+#include "blitter/factory.hpp"
+#include "core/alloc_type.hpp"
+#include "debug.h"
+#include "fileio_func.h"
+#include "random_access_file_type.h"
+#include "rev.h"
+#include "settings_type.h"
+#include "string_func.h"
+
+#include "safeguards.h"
+
+/** Whether encoded sprites are kept on disk between runs. */
+bool _sprite_disk_cache = false;
+
+static constexpr uint32_t SPRITE_DISK_CACHE_MAGIC = 0x4353504F; ///< Identification of a disk cache file; 'OPSC'.
+static constexpr uint32_t SPRITE_DISK_CACHE_VERSION = 1; ///< Version of the format of the disk cache files.
+
+/** Header in front of every sprite in a disk cache file. */
+struct SpriteDiskCacheRecord {
+	uint64_t file_pos; ///< Position of the sprite in the sprite file.
+	uint32_t size; ///< Number of bytes of the encoded sprite.
+	uint32_t checksum; ///< Checksum of the encoded sprite, to detect sprites that were not completely written.
+	uint8_t type; ///< SpriteType of the sprite.
+	uint8_t padding[7]; ///< Unused.
+};
+static_assert(sizeof(SpriteDiskCacheRecord) == 24);
+
+/** The disk cache of the sprites of one sprite file. */
+struct SpriteDiskCacheFile {
+	std::string filename; ///< Full path of the disk cache file.
+	std::unique_ptr<RandomAccessFile> reader; ///< The disk cache file as it was when it was opened, if it was valid.
+	std::optional<FileHandle> writer; ///< The disk cache file to append newly encoded sprites to.
+	std::unordered_map<uint64_t, size_t> sprites; ///< Position of the data of the sprites in #reader, or \c SIZE_MAX when it was written during this run.
+};
+
+static std::map<const SpriteFile *, SpriteDiskCacheFile> _sprite_disk_cache_files; ///< The disk caches of the sprite files that have been used.
+static std::string _sprite_disk_cache_settings; ///< The settings the disk caches in #_sprite_disk_cache_files are for.
+
+/**
+ * Calculate a checksum to detect damaged data in the disk cache.
+ * @param data The data.
+ * @return The checksum.
+ */
+static uint32_t CalcSpriteDiskCacheChecksum(std::span<const std::byte> data)
+{
+	/* 32 bits FNV-1a. */
+	uint32_t checksum = 2166136261U;
+	for (std::byte b : data) checksum = (checksum ^ std::to_integer<uint8_t>(b)) * 16777619U;
+	return checksum;
+}
+
+/**
+ * Get the key of a sprite in SpriteDiskCacheFile::sprites.
+ * @param file_pos Position of the sprite in the sprite file.
+ * @param type Type of the sprite.
+ * @return The key.
+ */
+static uint64_t GetSpriteDiskCacheKey(size_t file_pos, SpriteType type)
+{
+	return static_cast<uint64_t>(file_pos) << 8 | to_underlying(type);
+}
+
+/**
+ * Calculate the MD5 sum of the content of a sprite file.
+ * @param file The sprite file.
+ * @return The MD5 sum.
+ */
+static MD5Hash CalcSpriteFileMD5(SpriteFile &file)
+{
+	size_t old_pos = file.GetPos();
+	file.SeekTo(file.GetStartPos(), SEEK_SET);
+
+	Md5 checksum;
+	ReusableBuffer<uint8_t> buffer;
+	for (size_t remaining = file.GetEndPos() - file.GetStartPos(); remaining > 0;) {
+		std::span<const uint8_t> block = file.ReadSpan(std::min<size_t>(remaining, 1024 * 1024), buffer);
+		if (block.empty()) break;
+		checksum.Append(block.data(), block.size());
+		remaining -= block.size();
+	}
+
+	file.SeekTo(old_pos, SEEK_SET);
+
+	MD5Hash md5sum;
+	checksum.Finish(md5sum);
+	return md5sum;
+}
+
+/**
+ * Read the header and the positions of all sprites of a disk cache file.
+ * @param cache The disk cache with the file to read.
+ * @param header The header the file must have.
+ * @return True iff the disk cache file is valid and completely written.
+ */
+static bool ReadSpriteDiskCacheIndex(SpriteDiskCacheFile &cache, std::string_view header)
+{
+	RandomAccessFile &reader = *cache.reader;
+	if (reader.ReadDword() != SPRITE_DISK_CACHE_MAGIC || reader.ReadDword() != SPRITE_DISK_CACHE_VERSION) return false;
+	if (reader.ReadDword() != header.size()) return false;
+
+	ReusableBuffer<uint8_t> buffer;
+	std::span<const uint8_t> stored_header = reader.ReadSpan(header.size(), buffer);
+	if (std::string_view{reinterpret_cast<const char *>(stored_header.data()), stored_header.size()} != header) return false;
+
+	while (!reader.AtEndOfFile()) {
+		SpriteDiskCacheRecord record;
+		if (reader.GetEndPos() - reader.GetPos() < sizeof(record)) return false;
+		reader.ReadBlock(&record, sizeof(record));
+		if (reader.GetEndPos() - reader.GetPos() < record.size) return false;
+
+		/* A sprite can be in the file multiple times, when it was damaged earlier; the last one wins. */
+		cache.sprites[GetSpriteDiskCacheKey(record.file_pos, static_cast<SpriteType>(record.type))] = reader.GetPos();
+		reader.SkipBytes(record.size);
+	}
+	return true;
+}
+
+/**
+ * Write a 32 bits value in little endian format.
+ * @param f The file to write to.
+ * @param value The value to write.
+ * @return True iff writing succeeded.
+ */
+static bool WriteSpriteDiskCacheDword(FILE *f, uint32_t value)
+{
+	uint8_t bytes[] = {static_cast<uint8_t>(value), static_cast<uint8_t>(value >> 8), static_cast<uint8_t>(value >> 16), static_cast<uint8_t>(value >> 24)};
+	return fwrite(bytes, sizeof(bytes), 1, f) == 1;
+}
+
+/**
+ * Open the disk cache file of a sprite file, or create it when it does not exist or is invalid.
+ * @param cache The disk cache to open the file for.
+ * @param file The sprite file.
+ * @param settings The settings the encoded sprites depend on.
+ */
+static void OpenSpriteDiskCacheFile(SpriteDiskCacheFile &cache, SpriteFile &file, std::string_view settings)
+{
+	std::string md5sum = FormatArrayAsHex(CalcSpriteFileMD5(file));
+	std::string header = fmt::format("{}|{}|{}", settings, file.NeedsPaletteRemap() ? 1 : 0, md5sum);
+	std::string dir = _personal_dir + "sprite_cache" PATHSEP;
+	cache.filename = fmt::format("{}{}-{:08x}.dat", dir, md5sum, CalcSpriteDiskCacheChecksum(std::as_bytes(std::span{header})));
+
+	if (FileExists(cache.filename)) {
+		cache.reader = std::make_unique<RandomAccessFile>(cache.filename, Subdirectory::None);
+		if (ReadSpriteDiskCacheIndex(cache, header)) {
+			cache.writer = FileHandle::Open(cache.filename, "ab");
+			if (!cache.writer.has_value()) Debug(sprite, 1, "Cannot append to sprite disk cache {}", cache.filename);
+			Debug(sprite, 3, "Using {} sprites from sprite disk cache {}", cache.sprites.size(), cache.filename);
+			return;
+		}
+
+		Debug(sprite, 1, "Sprite disk cache {} is invalid or incomplete, recreating it", cache.filename);
+		cache.reader.reset();
+		cache.sprites.clear();
+	}
+
+	FioCreateDirectory(dir);
+	cache.writer = FileHandle::Open(cache.filename, "wb");
+	if (cache.writer.has_value() && WriteSpriteDiskCacheDword(*cache.writer, SPRITE_DISK_CACHE_MAGIC) && WriteSpriteDiskCacheDword(*cache.writer, SPRITE_DISK_CACHE_VERSION) &&
+			WriteSpriteDiskCacheDword(*cache.writer, static_cast<uint32_t>(header.size())) && fwrite(header.data(), 1, header.size(), *cache.writer) == header.size()) {
+		return;
+	}
+
+	Debug(sprite, 1, "Cannot create sprite disk cache {}", cache.filename);
+	cache.writer.reset();
+}
+
+/**
+ * Get the disk cache of a sprite file, if the disk cache is to be used.
+ * @param file The sprite file.
+ * @return The disk cache, or \c nullptr when sprites are not kept on disk.
+ */
+static SpriteDiskCacheFile *GetSpriteDiskCacheFile(SpriteFile &file)
+{
+	if (!_sprite_disk_cache) return nullptr;
+
+	/* Nothing is drawn without a screen depth, so there is no need to keep those sprites. */
+	Blitter *blitter = BlitterFactory::GetCurrentBlitter();
+	if (blitter == nullptr || blitter->GetScreenDepth() == 0) return nullptr;
+
+	std::string settings = fmt::format("{}|{}|{}", _openttd_revision, blitter->GetName(), to_underlying(_settings_client.gui.sprite_zoom_min));
+	if (settings != _sprite_disk_cache_settings) {
+		CloseSpriteDiskCache();
+		_sprite_disk_cache_settings = std::move(settings);
+	}
+
+	auto [it, inserted] = _sprite_disk_cache_files.try_emplace(&file);
+	if (inserted) OpenSpriteDiskCacheFile(it->second, file, _sprite_disk_cache_settings);
+	return &it->second;
+}
+
+/**
+ * Load an encoded sprite from the disk cache.
+ * @param file The sprite file of the sprite.
+ * @param file_pos Position of the sprite in the sprite file.
+ * @param type Type of the sprite.
+ * @param allocator The allocator for the memory of the sprite.
+ * @return True iff the sprite was in the disk cache and has been loaded into memory of \a allocator.
+ */
+bool LoadSpriteFromDiskCache(SpriteFile &file, size_t file_pos, SpriteType type, SpriteAllocator &allocator)
+{
+	SpriteDiskCacheFile *cache = GetSpriteDiskCacheFile(file);
+	if (cache == nullptr) return false;
+
+	auto it = cache->sprites.find(GetSpriteDiskCacheKey(file_pos, type));
+	if (it == cache->sprites.end() || it->second == SIZE_MAX) return false;
+
+	RandomAccessFile &reader = *cache->reader;
+	reader.SeekTo(it->second - sizeof(SpriteDiskCacheRecord), SEEK_SET);
+	SpriteDiskCacheRecord record;
+	reader.ReadBlock(&record, sizeof(record));
+
+	std::byte *data = allocator.Allocate<std::byte>(record.size);
+	reader.ReadBlock(data, record.size);
+	if (CalcSpriteDiskCacheChecksum({data, record.size}) != record.checksum) {
+		Debug(sprite, 1, "Sprite at position {} in sprite disk cache {} is damaged", it->second, cache->filename);
+		/* Allow the sprite to be written again. */
+		cache->sprites.erase(it);
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Store an encoded sprite in the disk cache, if it is not in there yet.
+ * @param file The sprite file of the sprite.
+ * @param file_pos Position of the sprite in the sprite file.
+ * @param type Type of the sprite.
+ * @param data The encoded sprite.
+ */
+void StoreSpriteInDiskCache(SpriteFile &file, size_t file_pos, SpriteType type, std::span<const std::byte> data)
+{
+	SpriteDiskCacheFile *cache = GetSpriteDiskCacheFile(file);
+	if (cache == nullptr || !cache->writer.has_value()) return;
+
+	if (!cache->sprites.emplace(GetSpriteDiskCacheKey(file_pos, type), SIZE_MAX).second) return;
+
+	SpriteDiskCacheRecord record{};
+	record.file_pos = file_pos;
+	record.size = static_cast<uint32_t>(data.size());
+	record.checksum = CalcSpriteDiskCacheChecksum(data);
+	record.type = to_underlying(type);
+	if (fwrite(&record, sizeof(record), 1, *cache->writer) != 1 || fwrite(data.data(), 1, data.size(), *cache->writer) != data.size()) {
+		Debug(sprite, 1, "Writing to sprite disk cache {} failed", cache->filename);
+		cache->writer.reset();
+	}
+}
+
+/**
+ * Close all disk cache files, e.g. because the sprite files are closed.
+ */
+void CloseSpriteDiskCache()
+{
+	_sprite_disk_cache_files.clear();
+	_sprite_disk_cache_settings.clear();
+}
@@ -0,0 +1,23 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/** @file spritecache_disk.h Functions to keep encoded sprites on disk between runs. */
+
+#ifndef SPRITECACHE_DISK_H
+#define SPRITECACHE_DISK_H
+
+#include "spritecache_type.h"
+#include "spriteloader/spriteloader.hpp"
+#include "spriteloader/sprite_file_type.hpp"
+
+extern bool _sprite_disk_cache;
+
+bool LoadSpriteFromDiskCache(SpriteFile &file, size_t file_pos, SpriteType type, SpriteAllocator &allocator);
+void StoreSpriteInDiskCache(SpriteFile &file, size_t file_pos, SpriteType type, std::span<const std::byte> data);
+void CloseSpriteDiskCache();
+
+#endif /* SPRITECACHE_DISK_H */
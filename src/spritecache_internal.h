@@ -20,12 +20,15 @@
 /* These declarations are internal to spritecache but need to be exposed for unit-tests. */
 
 struct SpriteCache {
+	static constexpr SpriteID LRU_END = UINT32_MAX; ///< Marker for the end of the LRU list.
+
 	std::unique_ptr<std::byte[]> ptr;
 	size_t file_pos = 0;
 	SpriteFile *file = nullptr; ///< The file the sprite in this entry can be found in.
 	uint32_t length; ///< Length of sprite data.
 	uint32_t id = 0;
-	uint32_t lru = 0;
+	SpriteID lru_older = LRU_END; ///< Sprite with data that has been used less recently than this one.
+	SpriteID lru_newer = LRU_END; ///< Sprite with data that has been used more recently than this one.
 	SpriteType type = SpriteType::Invalid; ///< In some cases a single sprite is misused by two NewGRFs. Once as real sprite and once as recolour sprite. If the recolour sprite gets into the cache it might be drawn as real sprite which causes enormous trouble.
 	bool warned = false; ///< True iff the user has been warned about incorrect use of this sprite
 	SpriteCacheCtrlFlags control_flags{}; ///< Control flags, see SpriteCacheCtrlFlags
@@ -10,7 +10,6 @@
 #include "../stdafx.h"
 #include "../gfx_func.h"
 #include "../debug.h"
-#include "../settings_type.h"
 #include "../strings_func.h"
 #include "../error.h"
 #include "../spritecache.h"
@@ -22,6 +21,9 @@
 
 extern const uint8_t _palmap_w2d[];
 
+/** Whether problems with sprites are reported on this thread. */
+thread_local bool _report_sprite_errors = true;
+
 /**
  * We found a corrupted sprite. This means that the sprite itself
  * contains invalid data or is too small for the given dimensions.
@@ -32,6 +34,8 @@ extern const uint8_t _palmap_w2d[];
  */
 static bool WarnCorruptSprite(const SpriteFile &file, size_t file_pos, int line)
 {
+	if (!_report_sprite_errors) return false;
+
 	static uint8_t warning_level = 0;
 	if (warning_level == 0) {
 		ShowErrorMessage(GetEncodedString(STR_NEWGRF_ERROR_CORRUPT_SPRITE, file.GetSimplifiedFilename()), {}, WL_ERROR);
@@ -179,7 +183,7 @@ bool DecodeSingleSprite(SpriteLoader::Sprite *sprite, SpriteFile &file, size_t f
 			return WarnCorruptSprite(file, file_pos, __LINE__);
 		}
 
-		if (dest_size > sprite_size) {
+		if (dest_size > sprite_size && _report_sprite_errors) {
 			static uint8_t warning_level = 0;
 			Debug(sprite, warning_level, "Ignoring {} unused extra bytes from the sprite from {} at position {}", dest_size - sprite_size, file.GetSimplifiedFilename(), file_pos);
 			warning_level = 6;
@@ -260,6 +264,8 @@ static ZoomLevels LoadSpriteV2(SpriteLoader::SpriteCollection &sprite, SpriteFil
 	/* Is the sprite not present/stripped in the GRF? */
 	if (file_pos == SIZE_MAX) return {};
 
+	ZoomLevel zoom_min = sprite_type == SpriteType::Font ? ZoomLevel::Min : GetSpriteLoadSettings().sprite_zoom_min;
+
 	/* Open the right file and go to the correct position */
 	file.SeekTo(file_pos, SEEK_SET);
 
@@ -290,7 +296,6 @@ static ZoomLevels LoadSpriteV2(SpriteLoader::SpriteCollection &sprite, SpriteFil
 				if (colour != SpriteComponent::Palette) avail_32bpp.Set(zoom_lvl);
 
 				is_wanted_zoom_lvl = true;
-				ZoomLevel zoom_min = sprite_type == SpriteType::Font ? ZoomLevel::Min : _settings_client.gui.sprite_zoom_min;
 				if (zoom_min >= ZoomLevel::In2x &&
 						control_flags.Test(load_32bpp ? SpriteCacheCtrlFlag::AllowZoomMin2x32bpp : SpriteCacheCtrlFlag::AllowZoomMin2xPal) && zoom_lvl < ZoomLevel::In2x) {
 					is_wanted_zoom_lvl = false;
@@ -12,6 +12,8 @@
 
 #include "spriteloader.hpp"
 
+extern thread_local bool _report_sprite_errors;
+
 /** Sprite loader for graphics coming from a (New)GRF. */
 class SpriteLoaderGrf : public SpriteLoader {
 	uint8_t container_ver;
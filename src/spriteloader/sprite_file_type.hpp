@@ -22,6 +22,12 @@ class SpriteFile : public RandomAccessFile {
 	size_t content_begin;   ///< The begin of the content of the sprite file, i.e. after the container metadata.
 public:
 	SpriteFile(const std::string &filename, Subdirectory subdir, bool palette_remap);
+	/**
+	 * Create a view on a memory mapped sprite file.
+	 * @param file The memory mapped file to view.
+	 * @param view Tag to select this constructor.
+	 */
+	SpriteFile(const SpriteFile &file, View view) : RandomAccessFile(file, view), palette_remap(file.palette_remap), container_version(file.container_version), content_begin(file.content_begin) {}
 	SpriteFile(const SpriteFile&) = delete;
 	void operator=(const SpriteFile&) = delete;
 
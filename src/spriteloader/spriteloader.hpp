@@ -75,7 +75,7 @@ public:
 		void AllocateData(ZoomLevel zoom, size_t size) { this->data = Sprite::buffer[zoom].ZeroAllocate(size); }
 	private:
 		/** Allocated memory to pass sprite data around */
-		static SpriteCollMap<ReusableBuffer<SpriteLoader::CommonPixel>> buffer;
+		static thread_local SpriteCollMap<ReusableBuffer<SpriteLoader::CommonPixel>> buffer;
 	};
 
 	/**
@@ -159,4 +159,30 @@ public:
 		return 0;
 	}
 };
+
+/**
+ * The settings and the palette that loading and encoding sprites depends on.
+ * Sprites decoded on another thread use a copy that is made when they are queued,
+ * as the main thread may change the settings and the palette in the meantime.
+ */
+struct SpriteLoadSettings {
+	ZoomLevel sprite_zoom_min; ///< Lowest zoom level of the sprites to load.
+	ZoomLevel zoom_min; ///< Lowest zoom level of the viewports.
+	ZoomLevel zoom_max; ///< Highest zoom level of the viewports.
+	const Palette *palette; ///< Palette to get the colours of palette indices from.
+
+	static const SpriteLoadSettings &Current();
+};
+
+extern thread_local const SpriteLoadSettings *_sprite_load_settings;
+
+/**
+ * Get the settings to load and encode sprites with on this thread.
+ * @return The copy of the settings this thread uses, or the current settings.
+ */
+inline const SpriteLoadSettings &GetSpriteLoadSettings()
+{
+	return _sprite_load_settings != nullptr ? *_sprite_load_settings : SpriteLoadSettings::Current();
+}
+
 #endif /* SPRITELOADER_HPP */
@@ -21,9 +21,14 @@
 #include "core/pool_func.hpp"
 #include "station_base.h"
 #include "station_kdtree.h"
+#include "station_func.h"
 #include "roadstop_base.h"
 #include "industry.h"
 #include "town.h"
+#include "object_map.h"
+#include "newgrf_house.h"
+#include "tile_cmd.h"
+#include "thread.h"
 #include "core/random_func.hpp"
 #include "linkgraph/linkgraph.h"
 #include "linkgraph/linkgraphschedule.h"
@@ -158,6 +163,7 @@ Station::~Station()
 
 	CargoPacket::InvalidateAllFrom(this->index);
 
+	_station_tick_scheduler.Remove(this);
 	_station_kdtree.Remove(this->index);
 	if (this->sign.kdtree_valid) _viewport_sign_kdtree.Remove(ViewportSignKdtreeItem::MakeStation(this->index));
 }
@@ -239,6 +245,7 @@ void Station::AddFacility(StationFacility new_facility_bit, TileIndex facil_xy)
 	this->facilities.Set(new_facility_bit);
 	this->owner = _current_company;
 	this->build_date = TimerGameCalendar::date;
+	_station_tick_scheduler.Add(this);
 	SetWindowClassesDirty(WC_VEHICLE_ORDERS);
 }
 
@@ -471,6 +478,20 @@ void Station::RecomputeCatchment(bool no_clear_nearby_lists)
 	this->industries_near.clear();
 	if (!no_clear_nearby_lists) this->RemoveFromAllNearbyLists();
 
+	std::vector<TileIndex> nearby_tiles;
+	this->ComputeCatchmentTiles();
+	this->FindNearbyTiles(nearby_tiles);
+	this->AddToAllNearbyLists(nearby_tiles);
+}
+
+/**
+ * Recompute the tiles covered by our catchment area, without updating any of the nearby lists.
+ * This only changes the station itself, so it may be called for several stations at once.
+ */
+void Station::ComputeCatchmentTiles()
+{
+	this->InvalidateAcceptanceCache();
+
 	if (this->rect.IsEmpty()) {
 		this->catchment_tiles.Reset();
 		return;
@@ -484,13 +505,6 @@ void Station::RecomputeCatchment(bool no_clear_nearby_lists)
 				this->catchment_tiles.SetTile(tile);
 			}
 		}
-		/* The industry's stations_near may have been computed before its neutral station was built so clear and re-add here. */
-		for (Station *st : this->industry->stations_near) {
-			st->RemoveIndustryToDeliver(this->industry);
-		}
-		this->industry->stations_near.clear();
-		this->industry->stations_near.insert(this);
-		this->industries_near.insert(IndustryListEntry{0, this->industry});
 		return;
 	}
 
@@ -508,20 +522,59 @@ void Station::RecomputeCatchment(bool no_clear_nearby_lists)
 		TileArea ta2 = TileArea(tile, 1, 1).Expand(r);
 		for (TileIndex tile2 : ta2) this->catchment_tiles.SetTile(tile2);
 	}
+}
+
+/**
+ * Find the house and industry tiles in our catchment area that make towns and industries near to us.
+ * This only reads the map, so it may be called for several stations at once.
+ * @param[out] nearby_tiles The found tiles, in the order they have to be added to the nearby lists.
+ */
+void Station::FindNearbyTiles(std::vector<TileIndex> &nearby_tiles) const
+{
+	if (this->rect.IsEmpty()) return;
+
+	/* Station is associated with an industry; that is handled in AddToAllNearbyLists. */
+	if (!_settings_game.station.serve_neutral_industries && this->industry != nullptr) return;
 
 	/* Search catchment tiles for towns and industries */
 	BitmapTileIterator it(this->catchment_tiles);
 	for (TileIndex tile = it; tile != INVALID_TILE; tile = ++it) {
+		if (IsTileType(tile, TileType::House)) nearby_tiles.push_back(tile);
+		if (IsTileType(tile, TileType::Industry)) {
+			/* Ignore industry if it has a neutral station. It already can't be this station. */
+			if (!_settings_game.station.serve_neutral_industries && Industry::GetByTile(tile)->neutral_station != nullptr) continue;
+
+			nearby_tiles.push_back(tile);
+		}
+	}
+}
+
+/**
+ * Add this station to the nearby lists of the towns and industries in our catchment area, and add
+ * the industries we can deliver to to our own list.
+ * @param nearby_tiles The tiles found by FindNearbyTiles.
+ */
+void Station::AddToAllNearbyLists(std::span<const TileIndex> nearby_tiles)
+{
+	if (this->rect.IsEmpty()) return;
+
+	if (!_settings_game.station.serve_neutral_industries && this->industry != nullptr) {
+		/* The industry's stations_near may have been computed before its neutral station was built so clear and re-add here. */
+		for (Station *st : this->industry->stations_near) {
+			st->RemoveIndustryToDeliver(this->industry);
+		}
+		this->industry->stations_near.clear();
+		this->industry->stations_near.insert(this);
+		this->industries_near.insert(IndustryListEntry{0, this->industry});
+		return;
+	}
+
+	for (TileIndex tile : nearby_tiles) {
 		if (IsTileType(tile, TileType::House)) {
 			Town *t = Town::GetByTile(tile);
 			t->stations_near.insert(this);
-		}
-		if (IsTileType(tile, TileType::Industry)) {
+		} else {
 			Industry *i = Industry::GetByTile(tile);
-
-			/* Ignore industry if it has a neutral station. It already can't be this station. */
-			if (!_settings_game.station.serve_neutral_industries && i->neutral_station != nullptr) continue;
-
 			i->stations_near.insert(this);
 
 			/* Add if we can deliver to this industry as well */
@@ -538,7 +591,140 @@ void Station::RecomputeCatchment(bool no_clear_nearby_lists)
 {
 	for (Town *t : Town::Iterate()) { t->stations_near.clear(); }
 	for (Industry *i : Industry::Iterate()) { i->stations_near.clear(); }
-	for (Station *st : Station::Iterate()) { st->RecomputeCatchment(true); }
+
+	std::vector<Station *> stations;
+	for (Station *st : Station::Iterate()) stations.push_back(st);
+
+	/* Finding the catchment and the nearby tiles does not change anything but the station itself, so
+	 * that is spread over multiple threads. The nearby lists are shared between stations, so they are
+	 * filled afterwards in station order, to get the same lists as when doing one station at a time. */
+	std::vector<std::vector<TileIndex>> nearby_tiles(stations.size());
+	ParallelFor(stations.size(), 64, [&stations, &nearby_tiles](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) {
+			stations[i]->ComputeCatchmentTiles();
+			stations[i]->FindNearbyTiles(nearby_tiles[i]);
+		}
+	});
+
+	for (size_t i = 0; i < stations.size(); i++) {
+		stations[i]->industries_near.clear();
+		stations[i]->AddToAllNearbyLists(nearby_tiles[i]);
+	}
+}
+
+/**
+ * Check whether the acceptance of a tile only depends on what is built on it, so it can be cached.
+ * @param tile The tile to check.
+ * @return True iff the tile is a house without acceptance callbacks.
+ */
+static bool HasStaticAcceptance(TileIndex tile)
+{
+	if (!IsTileType(tile, TileType::House)) return false;
+	return !HouseSpec::Get(GetHouseType(tile))->callback_mask.Any({HouseCallbackMask::AcceptCargo, HouseCallbackMask::CargoAcceptance});
+}
+
+/**
+ * Check whether the acceptance of a tile has to be determined every time it is needed.
+ * @param tile The tile to check.
+ * @return True iff the tile is an industry tile, the company headquarters or a house with acceptance callbacks.
+ */
+static bool HasDynamicAcceptance(TileIndex tile)
+{
+	switch (GetTileType(tile)) {
+		case TileType::House: return !HasStaticAcceptance(tile);
+		case TileType::Industry: return true;
+		case TileType::Object: return IsObjectType(tile, OBJECT_HQ);
+		default: return false;
+	}
+}
+
+/**
+ * Add the acceptance of a tile to an acceptance cache.
+ * @param cache The cache.
+ * @param tile The tile.
+ */
+static void AddTileToAcceptanceCache(StationAcceptanceCache &cache, TileIndex tile)
+{
+	if (HasStaticAcceptance(tile)) {
+		CargoTypes always_accepted{};
+		AddAcceptedCargo(tile, cache.acceptance, always_accepted);
+	} else if (HasDynamicAcceptance(tile)) {
+		cache.dynamic_tiles.insert(tile);
+	}
+}
+
+/**
+ * Sum the acceptance of the tiles in our catchment area, without touching our cache.
+ * @return The acceptance cache for the current catchment area.
+ */
+StationAcceptanceCache Station::ComputeAcceptanceCache() const
+{
+	StationAcceptanceCache cache{};
+	cache.valid = true;
+
+	if (this->rect.IsEmpty()) return cache;
+
+	BitmapTileIterator it(this->catchment_tiles);
+	for (TileIndex tile = it; tile != INVALID_TILE; tile = ++it) {
+		AddTileToAcceptanceCache(cache, tile);
+	}
+	return cache;
+}
+
+/**
+ * Get the acceptance of the tiles in our catchment area.
+ * @return Cargo array of accepted cargo types and bitmask of cargo accepted by houses and headquarters.
+ */
+std::pair<CargoArray, CargoTypes> Station::GetCatchmentAcceptance()
+{
+	if (!this->acceptance_cache.valid) this->acceptance_cache = this->ComputeAcceptanceCache();
+
+	CargoArray acceptance = this->acceptance_cache.acceptance;
+	CargoTypes always_accepted{};
+	/* Houses add to always accepted exactly the cargo types they accept. */
+	for (CargoType cargo = 0; cargo < NUM_CARGO; ++cargo) {
+		if (acceptance[cargo] != 0) SetBit(always_accepted, cargo);
+	}
+
+	for (TileIndex tile : this->acceptance_cache.dynamic_tiles) {
+		/* Industries may have disappeared without us being told, when we were not near them. */
+		if (HasDynamicAcceptance(tile)) AddAcceptedCargo(tile, acceptance, always_accepted);
+	}
+
+	return {acceptance, always_accepted};
+}
+
+/**
+ * Add the acceptance of a tile in our catchment area after something was built on it.
+ * @param tile The tile.
+ */
+void Station::AddAcceptanceOfTile(TileIndex tile)
+{
+	if (!this->acceptance_cache.valid) return;
+
+	AddTileToAcceptanceCache(this->acceptance_cache, tile);
+}
+
+/**
+ * Remove the acceptance of a tile in our catchment area before what is built on it gets removed.
+ * @param tile The tile.
+ */
+void Station::RemoveAcceptanceOfTile(TileIndex tile)
+{
+	StationAcceptanceCache &cache = this->acceptance_cache;
+	if (!cache.valid) return;
+
+	if (HasStaticAcceptance(tile)) {
+		CargoArray acceptance{};
+		CargoTypes always_accepted{};
+		AddAcceptedCargo(tile, acceptance, always_accepted);
+		for (CargoType cargo = 0; cargo < NUM_CARGO; ++cargo) {
+			assert(cache.acceptance[cargo] >= acceptance[cargo]);
+			cache.acceptance[cargo] -= acceptance[cargo];
+		}
+	} else {
+		cache.dynamic_tiles.erase(tile);
+	}
 }
 
 /************************************************************************/
@@ -523,6 +523,17 @@ struct IndustryCompare {
 typedef std::set<IndustryListEntry, IndustryCompare> IndustryList;
 struct RoadVehicle;
 
+/**
+ * Acceptance of the tiles in the catchment area of a station.
+ * Houses without acceptance callbacks always accept the same, so their acceptance is summed once and
+ * then kept up to date as they are built and removed. The other tiles are asked whenever needed.
+ */
+struct StationAcceptanceCache {
+	CargoArray acceptance{}; ///< Summed acceptance of the houses without acceptance callbacks.
+	FlatSet<TileIndex> dynamic_tiles{}; ///< Tiles whose acceptance can change without them being rebuilt.
+	bool valid = false; ///< Whether the cache matches the current catchment area.
+};
+
 /** Station data structure */
 struct Station final : SpecializedStation<Station, false> {
 public:
@@ -545,6 +556,8 @@ public:
 	IndustryType indtype = IT_INVALID; ///< Industry type to get the name from
 
 	BitmapTileArea catchment_tiles{}; ///< NOSAVE: Set of individual tiles covered by catchment area
+	StationAcceptanceCache acceptance_cache{}; ///< NOSAVE: Acceptance of the tiles in the catchment area
+	uint8_t rating_bucket = UINT8_MAX; ///< NOSAVE: Bucket of the station in the rating schedule, or UINT8_MAX when it is not scheduled, @see StationTickScheduler
 
 	StationHadVehicleOfType had_vehicle_of_type{};
 
@@ -584,6 +597,17 @@ public:
 	void RemoveIndustryToDeliver(Industry *ind);
 	void RemoveFromAllNearbyLists();
 
+	std::pair<CargoArray, CargoTypes> GetCatchmentAcceptance();
+	StationAcceptanceCache ComputeAcceptanceCache() const;
+	void AddAcceptanceOfTile(TileIndex tile);
+	void RemoveAcceptanceOfTile(TileIndex tile);
+
+	/** Make the acceptance of the catchment area be determined again the next time it is needed. */
+	inline void InvalidateAcceptanceCache()
+	{
+		this->acceptance_cache.valid = false;
+	}
+
 	inline bool TileIsInCatchment(TileIndex tile) const
 	{
 		return this->catchment_tiles.HasTile(tile);
@@ -607,6 +631,11 @@ public:
 	uint32_t GetNewGRFVariable(const ResolverObject &object, uint8_t variable, uint8_t parameter, bool &available) const override;
 
 	TileArea GetTileArea(StationType type) const override;
+
+private:
+	void ComputeCatchmentTiles();
+	void FindNearbyTiles(std::vector<TileIndex> &nearby_tiles) const;
+	void AddToAllNearbyLists(std::span<const TileIndex> nearby_tiles);
 };
 
 /** Iterator to iterate over all tiles belonging to an airport. */
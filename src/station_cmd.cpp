@@ -603,24 +603,6 @@ std::pair<CargoArray, CargoTypes> GetAcceptanceAroundTiles(TileIndex center_tile
 	return {acceptance, always_accepted};
 }
 
-/**
- * Get the acceptance of cargoes around the station in.
- * @param st Station to get acceptance of.
- * @return Cargo array of accepted cargo types and bitmask of cargo accepted by houses and headquarters.
- */
-static std::pair<CargoArray, CargoTypes> GetAcceptanceAroundStation(const Station *st)
-{
-	CargoArray acceptance{};
-	CargoTypes always_accepted{};
-
-	BitmapTileIterator it(st->catchment_tiles);
-	for (TileIndex tile = it; tile != INVALID_TILE; tile = ++it) {
-		AddAcceptedCargo(tile, acceptance, always_accepted);
-	}
-
-	return {acceptance, always_accepted};
-}
-
 /**
  * Update the acceptance for a station.
  * @param st Station to update
@@ -634,7 +616,7 @@ void UpdateStationAcceptance(Station *st, bool show_msg)
 	/* And retrieve the acceptance. */
 	CargoArray acceptance{};
 	if (!st->rect.IsEmpty()) {
-		std::tie(acceptance, st->always_accepted) = GetAcceptanceAroundStation(st);
+		std::tie(acceptance, st->always_accepted) = st->GetCatchmentAcceptance();
 	}
 
 	/* Adjust in case our station only accepts fewer kinds of goods */
@@ -742,6 +724,7 @@ static CommandCost BuildStationPart(Station **st, DoCommandFlags flags, bool reu
 static void DeleteStationIfEmpty(BaseStation *st)
 {
 	if (!st->IsInUse()) {
+		if (Station::IsExpected(st)) _station_tick_scheduler.Remove(Station::From(st));
 		st->delete_ctr = 0;
 		InvalidateWindowData(WC_STATION_LIST, st->owner, 0);
 	}
@@ -2335,7 +2318,7 @@ static CommandCost RemoveRoadStop(TileIndex tile, DoCommandFlags flags, int repl
 		/* Make sure no vehicle is going to the old roadstop. Narrow the search to any road vehicles with an order to
 		 * this station, then look for any currently heading to the tile. */
 		StationID station_id = st->index;
-		FindVehiclesWithOrder(
+		FindVehiclesWithOrder(station_id,
 			[](const Vehicle *v) { return v->type == VEH_ROAD; },
 			[station_id](const Order *order) { return order->IsType(OT_GOTO_STATION) && order->GetDestination() == station_id; },
 			[station_id, tile](Vehicle *v) {
@@ -2881,7 +2864,7 @@ CommandCost CmdOpenCloseAirport(DoCommandFlags flags, StationID station_id)
  */
 bool HasStationInUse(StationID station, bool include_company, CompanyID company)
 {
-	for (const OrderList *orderlist : OrderList::Iterate()) {
+	for (const OrderList *orderlist : OrderList::IterateWithDestination(station)) {
 		const Vehicle *v = orderlist->GetFirstSharedVehicle();
 		assert(v != nullptr);
 		if ((v->owner == company) != include_company) continue;
@@ -4207,7 +4190,7 @@ void DeleteStaleLinks(Station *from)
 					/* Have all vehicles refresh their next hops before deciding to
 					 * remove the node. */
 					std::vector<Vehicle *> vehicles;
-					for (const OrderList *l : OrderList::Iterate()) {
+					for (const OrderList *l : OrderList::IterateWithDestination(from->index)) {
 						bool found_from = false;
 						bool found_to = false;
 						for (const Order &order : l->GetOrders()) {
@@ -4351,38 +4334,120 @@ void IncreaseStats(Station *st, const Vehicle *front, StationID next_station_id,
 	}
 }
 
-/* called for every station each tick */
+/* called for every station whose rating is due */
 static void StationHandleSmallTick(BaseStation *st)
 {
 	if (st->facilities.Test(StationFacility::Waypoint) || !st->IsInUse()) return;
 
-	uint8_t b = st->delete_ctr + 1;
-	if (b >= Ticks::STATION_RATING_TICKS) b = 0;
-	st->delete_ctr = b;
+	UpdateStationRating(Station::From(st));
+}
+
+StationTickScheduler _station_tick_scheduler;
+
+/**
+ * Schedule the rating of a station that is in use.
+ * The rating is due when its delete counter, which is incremented every tick
+ * from its current value, wraps around.
+ * @param st The station.
+ */
+void StationTickScheduler::Add(Station *st)
+{
+	if (st->rating_bucket != UINT8_MAX) return;
+
+	uint8_t delete_ctr = std::min<uint8_t>(st->delete_ctr, Ticks::STATION_RATING_TICKS - 1);
+	st->rating_bucket = (this->rating_tick + Ticks::STATION_RATING_TICKS - delete_ctr) % Ticks::STATION_RATING_TICKS;
 
-	if (b == 0) UpdateStationRating(Station::From(st));
+	std::vector<StationID> &bucket = this->buckets[st->rating_bucket];
+	bucket.insert(std::ranges::lower_bound(bucket, st->index), st->index);
+}
+
+/**
+ * Stop scheduling the rating of a station, because it is no longer in use or deleted.
+ * @param st The station.
+ */
+void StationTickScheduler::Remove(Station *st)
+{
+	if (st->rating_bucket == UINT8_MAX) return;
+
+	std::vector<StationID> &bucket = this->buckets[st->rating_bucket];
+	auto it = std::ranges::lower_bound(bucket, st->index);
+	if (it != bucket.end() && *it == st->index) bucket.erase(it);
+	st->rating_bucket = UINT8_MAX;
+}
+
+/** Rebuild the schedule from the delete counters of all stations, e.g. after loading. */
+void StationTickScheduler::Rebuild()
+{
+	for (auto &bucket : this->buckets) bucket.clear();
+	this->rating_tick = 0;
+
+	for (Station *st : Station::Iterate()) {
+		st->rating_bucket = UINT8_MAX;
+		if (st->IsInUse()) this->Add(st);
+	}
+}
+
+/** Bring the delete counters of the scheduled stations up to date, e.g. before saving. */
+void StationTickScheduler::SyncDeleteCounters()
+{
+	for (Station *st : Station::Iterate()) {
+		if (st->rating_bucket == UINT8_MAX) continue;
+		st->delete_ctr = (this->rating_tick + Ticks::STATION_RATING_TICKS - st->rating_bucket) % Ticks::STATION_RATING_TICKS;
+	}
+}
+
+/**
+ * Advance the schedule by one tick and get the stations that are due.
+ * @param counter The tick counter of the tick.
+ * @param[out] due The due stations with their actions, in increasing index order.
+ */
+void StationTickScheduler::Tick(TimerGameTick::TickCounter counter, std::vector<StationTickDue> &due)
+{
+	this->rating_tick = (this->rating_tick + 1) % Ticks::STATION_RATING_TICKS;
+
+	due.clear();
+	for (StationID index : this->buckets[this->rating_tick]) due.emplace_back(index, StationTickAction::Rating);
+	/* Clean up the link graph about once a week. */
+	StationTickSchedule(counter, Ticks::STATION_LINKGRAPH_TICKS).ForEachDue(Station::GetPoolSize(), [&due](size_t index) {
+		due.emplace_back(static_cast<StationID>(index), StationTickAction::LinkGraph);
+	});
+	/* Spread out big-tick and station animation over STATION_ACCEPTANCE_TICKS ticks. */
+	StationTickSchedule(counter, Ticks::STATION_ACCEPTANCE_TICKS).ForEachDue(Station::GetPoolSize(), [&due](size_t index) {
+		due.emplace_back(static_cast<StationID>(index), StationTickAction::Acceptance);
+	});
+
+	/* Merge the actions of the same station, so each station is visited once. */
+	std::ranges::sort(due, {}, &StationTickDue::first);
+	auto last = due.begin();
+	for (auto it = due.begin(); it != due.end(); ++it) {
+		if (last != due.begin() && std::prev(last)->first == it->first) {
+			std::prev(last)->second.Set(it->second);
+		} else {
+			*last++ = *it;
+		}
+	}
+	due.erase(last, due.end());
 }
 
 void OnTick_Station()
 {
 	if (_game_mode == GM_EDITOR) return;
 
-	for (BaseStation *st : BaseStation::Iterate()) {
-		StationHandleSmallTick(st);
+	static std::vector<StationTickDue> due;
+	_station_tick_scheduler.Tick(TimerGameTick::counter, due);
 
-		/* Clean up the link graph about once a week. */
-		if (Station::IsExpected(st) && (TimerGameTick::counter + st->index) % Ticks::STATION_LINKGRAPH_TICKS == 0) {
-			DeleteStaleLinks(Station::From(st));
-		};
+	for (const auto &[index, actions] : due) {
+		BaseStation *st = BaseStation::GetIfValid(index);
+		if (st == nullptr) continue;
 
-		/* Spread out big-tick over STATION_ACCEPTANCE_TICKS ticks. */
-		if ((TimerGameTick::counter + st->index) % Ticks::STATION_ACCEPTANCE_TICKS == 0) {
+		if (actions.Test(StationTickAction::Rating)) StationHandleSmallTick(st);
+
+		if (actions.Test(StationTickAction::LinkGraph) && Station::IsExpected(st)) DeleteStaleLinks(Station::From(st));
+
+		if (actions.Test(StationTickAction::Acceptance)) {
 			/* Stop processing this station if it was deleted */
 			if (!StationHandleBigTick(st)) continue;
-		}
 
-		/* Spread out station animation over STATION_ACCEPTANCE_TICKS ticks. */
-		if ((TimerGameTick::counter + st->index) % Ticks::STATION_ACCEPTANCE_TICKS == 0) {
 			TriggerStationAnimation(st, st->xy, StationAnimationTrigger::AcceptanceTick);
 			TriggerRoadStopAnimation(st, st->xy, StationAnimationTrigger::AcceptanceTick);
 			if (Station::IsExpected(st)) TriggerAirportAnimation(Station::From(st), AirportAnimationTrigger::AcceptanceTick);
@@ -4758,6 +4823,7 @@ void BuildOilRig(TileIndex tile)
 	st->ship_station.Add(tile);
 	st->facilities = {StationFacility::Airport, StationFacility::Dock};
 	st->build_date = TimerGameCalendar::date;
+	_station_tick_scheduler.Add(st);
 	UpdateStationDockingTiles(st);
 
 	st->rect.BeforeAddTile(tile, StationRect::ADD_FORCE);
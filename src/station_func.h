@@ -19,6 +19,7 @@
 #include "road.h"
 #include "linkgraph/linkgraph_type.h"
 #include "industry_type.h"
+#include "timer/timer_game_tick.h"
 
 void ModifyStationRatingAround(TileIndex tile, Owner owner, int amount, uint radius);
 
@@ -64,4 +65,70 @@ inline Money StationMaintenanceCost(uint32_t num)
 
 Money AirportMaintenanceCost(Owner owner);
 
+/**
+ * Schedule of the stations that are due for a periodic action in a tick.
+ * Stations are spread over the period by their index: a station is due when
+ * <tt>(counter + index) % period == 0</tt>. The due stations are thus exactly the
+ * indices <tt>first, first + period, first + 2 * period, ...</tt>, so instead of
+ * visiting every station only those indices are visited.
+ */
+class StationTickSchedule {
+	size_t first; ///< The first index that is due.
+	size_t period; ///< Number of ticks between two actions for the same station.
+
+public:
+	/**
+	 * Create the schedule for a tick.
+	 * @param counter The tick counter of the tick.
+	 * @param period Number of ticks between two actions for the same station.
+	 */
+	constexpr StationTickSchedule(TimerGameTick::TickCounter counter, size_t period) : first((period - counter % period) % period), period(period) {}
+
+	/**
+	 * Call a function for the indices that are due in this tick.
+	 * @param end One past the highest index to consider.
+	 * @param func The function to call with each due index, in increasing order.
+	 */
+	template <class TFn>
+	constexpr void ForEachDue(size_t end, TFn &&func) const
+	{
+		for (size_t index = this->first; index < end; index += this->period) func(index);
+	}
+};
+
+/** Periodic actions of the station tick. */
+enum class StationTickAction : uint8_t {
+	Rating, ///< Update the station rating.
+	LinkGraph, ///< Delete the stale links of the station.
+	Acceptance, ///< Big tick and acceptance animation of the station.
+};
+using StationTickActions = EnumBitSet<StationTickAction, uint8_t>;
+
+/** A station with the actions that are due for it in a tick. */
+using StationTickDue = std::pair<StationID, StationTickActions>;
+
+/**
+ * Schedule of all periodic actions of the station tick.
+ *
+ * The link graph clean up and the big tick are spread by the station index, see
+ * #StationTickSchedule. The rating of a station in use is instead due whenever its
+ * #BaseStation::delete_ctr wraps around #Ticks::STATION_RATING_TICKS. Rather than
+ * incrementing that counter for every station each tick, the stations are kept in
+ * a bucket per phase of the counter; #BaseStation::delete_ctr of the stations in
+ * use is only brought up to date by #SyncDeleteCounters.
+ */
+class StationTickScheduler {
+	std::array<std::vector<StationID>, Ticks::STATION_RATING_TICKS> buckets{}; ///< Sorted stations in use per phase of their rating counter.
+	uint8_t rating_tick = 0; ///< Current phase of the rating schedule.
+
+public:
+	void Add(Station *st);
+	void Remove(Station *st);
+	void Rebuild();
+	void SyncDeleteCounters();
+	void Tick(TimerGameTick::TickCounter counter, std::vector<StationTickDue> &due);
+};
+
+extern StationTickScheduler _station_tick_scheduler;
+
 #endif /* STATION_FUNC_H */
@@ -0,0 +1,246 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/** @file blitter.cpp Tests for the SIMD blitters. */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../blitter/factory.hpp"
+#include "../gfx_func.h"
+#include "../spritecache.h"
+
+#include <chrono>
+
+#include "../safeguards.h"
+
+static constexpr int SCREEN_WIDTH = 320; ///< Width of the screen the sprites are drawn to.
+static constexpr int SCREEN_HEIGHT = 160; ///< Height of the screen the sprites are drawn to.
+
+/** A sprite of the replayed stream, with where and how to draw it. */
+struct StreamSprite {
+	std::vector<SpriteLoader::CommonPixel> pixels; ///< The pixels of the sprite.
+	uint16_t width; ///< Width of the sprite.
+	uint16_t height; ///< Height of the sprite.
+	int left; ///< Where to draw the sprite on the screen.
+	int top; ///< Where to draw the sprite on the screen.
+	int skip_left; ///< Number of columns of the sprite clipped on the left.
+	int skip_top; ///< Number of rows of the sprite clipped at the top.
+	int draw_width; ///< Number of columns of the sprite to draw.
+	int draw_height; ///< Number of rows of the sprite to draw.
+};
+
+/**
+ * Create a fixed stream of sprites with a mix of transparent, translucent, remapped and animated pixels.
+ * Like in a game, only some of the sprites have palette animated pixels.
+ * @param count The number of sprites.
+ * @return The sprites.
+ */
+static std::vector<StreamSprite> MakeSpriteStream(int count)
+{
+	std::vector<StreamSprite> stream;
+	uint32_t seed = 42;
+	auto next = [&seed]() {
+		seed = seed * 1103515245 + 12345;
+		return seed >> 8;
+	};
+
+	for (int i = 0; i < count; i++) {
+		StreamSprite &s = stream.emplace_back();
+		s.width = 1 + next() % 64;
+		s.height = 1 + next() % 48;
+		bool animated = i % 4 == 0;
+		for (int p = 0; p < s.width * s.height; p++) {
+			SpriteLoader::CommonPixel &px = s.pixels.emplace_back();
+			uint32_t r = next();
+			switch (r % 8) {
+				case 0: case 1: px.a = 0; break;
+				case 2: px.a = 1 + (r >> 3) % 254; break;
+				default: px.a = 255; break;
+			}
+			if (px.a == 0) continue;
+			px.r = r >> 4;
+			px.g = r >> 9;
+			px.b = r >> 14;
+			switch ((r >> 20) % 4) {
+				case 0: px.m = 1 + (r >> 3) % (PALETTE_ANIM_START - 1); break;
+				case 1: px.m = animated ? PALETTE_ANIM_START + (r >> 3) % (256 - PALETTE_ANIM_START) : 0; break;
+				default: px.m = 0; break;
+			}
+		}
+
+		s.skip_left = (next() % 4 == 0) ? next() % s.width : 0;
+		s.skip_top = (next() % 4 == 0) ? next() % s.height : 0;
+		s.draw_width = s.width - s.skip_left - ((next() % 4 == 0) ? next() % (s.width - s.skip_left) : 0);
+		s.draw_height = s.height - s.skip_top - ((next() % 4 == 0) ? next() % (s.height - s.skip_top) : 0);
+		s.left = next() % (SCREEN_WIDTH - s.draw_width + 1);
+		s.top = next() % (SCREEN_HEIGHT - s.draw_height + 1);
+	}
+	return stream;
+}
+
+/** The screen, its animation buffer and the encoded sprite stream for one blitter. */
+struct BlitterRun {
+	std::unique_ptr<Blitter> blitter; ///< The blitter under test.
+	std::vector<uint32_t> video; ///< The video buffer.
+	std::vector<UniquePtrSpriteAllocator> allocators; ///< The memory of the encoded sprites.
+	std::vector<const Sprite *> sprites; ///< The encoded sprites of the stream.
+
+	/**
+	 * Create the blitter and encode the sprite stream for it.
+	 * @param factory The factory of the blitter.
+	 * @param stream The sprite stream.
+	 */
+	BlitterRun(BlitterFactory *factory, const std::vector<StreamSprite> &stream) : blitter(factory->CreateInstance()), video(SCREEN_WIDTH * SCREEN_HEIGHT), allocators(stream.size())
+	{
+		this->Activate();
+
+		uint32_t seed = 1;
+		for (uint32_t &px : this->video) {
+			seed = seed * 1103515245 + 12345;
+			px = seed | 0xFF000000;
+		}
+
+		/* Give the animation buffer of the animated blitters some content to keep or clear. */
+		if (this->blitter->BufferSize(1, 1) > sizeof(uint32_t)) {
+			std::vector<uint8_t> buffer(this->blitter->BufferSize(SCREEN_WIDTH, SCREEN_HEIGHT));
+			for (uint8_t &b : buffer) {
+				seed = seed * 1103515245 + 12345;
+				b = seed >> 16;
+			}
+			this->blitter->CopyFromBuffer(_screen.dst_ptr, buffer.data(), SCREEN_WIDTH, SCREEN_HEIGHT);
+		}
+
+		for (size_t i = 0; i < stream.size(); i++) {
+			SpriteLoader::SpriteCollection collection;
+			SpriteLoader::Sprite &sprite = collection[ZoomLevel::Min];
+			sprite.width = stream[i].width;
+			sprite.height = stream[i].height;
+			sprite.x_offs = 0;
+			sprite.y_offs = 0;
+			sprite.colours = {SpriteComponent::RGB, SpriteComponent::Alpha, SpriteComponent::Palette};
+			sprite.AllocateData(ZoomLevel::Min, stream[i].pixels.size());
+			std::ranges::copy(stream[i].pixels, sprite.data);
+			this->sprites.push_back(this->blitter->Encode(SpriteType::Font, collection, this->allocators[i]));
+		}
+	}
+
+	/** Point the screen at the video buffer of this run. */
+	void Activate()
+	{
+		_screen.dst_ptr = this->video.data();
+		_screen.width = SCREEN_WIDTH;
+		_screen.height = SCREEN_HEIGHT;
+		_screen.pitch = SCREEN_WIDTH;
+		this->blitter->PostResize();
+	}
+
+	/**
+	 * Draw the sprite stream.
+	 * @param stream The sprite stream.
+	 * @param mode The blitter mode, or \c std::nullopt to cycle through all modes.
+	 * @param remap The remap table for the remapping modes.
+	 * @return The number of drawn pixels.
+	 */
+	uint64_t Draw(const std::vector<StreamSprite> &stream, std::optional<BlitterMode> mode, const uint8_t *remap)
+	{
+		this->Activate();
+
+		static const BlitterMode modes[] = {BlitterMode::Normal, BlitterMode::ColourRemap, BlitterMode::Transparent, BlitterMode::TransparentRemap, BlitterMode::CrashRemap, BlitterMode::BlackRemap};
+		uint64_t pixels = 0;
+		for (size_t i = 0; i < stream.size(); i++) {
+			const StreamSprite &s = stream[i];
+			Blitter::BlitterParams bp;
+			bp.sprite = this->sprites[i]->data;
+			bp.remap = remap;
+			bp.skip_left = s.skip_left;
+			bp.skip_top = s.skip_top;
+			bp.width = s.draw_width;
+			bp.height = s.draw_height;
+			bp.sprite_width = s.width;
+			bp.sprite_height = s.height;
+			bp.left = s.left;
+			bp.top = s.top;
+			bp.dst = _screen.dst_ptr;
+			bp.pitch = _screen.pitch;
+			this->blitter->Draw(&bp, mode.value_or(modes[i % std::size(modes)]), ZoomLevel::Min);
+			pixels += s.draw_width * s.draw_height;
+		}
+		return pixels;
+	}
+
+	/**
+	 * Get the content of the screen, including the animation buffer when the blitter has one.
+	 * @return The screen content.
+	 */
+	std::vector<uint8_t> GetScreen()
+	{
+		this->Activate();
+		std::vector<uint8_t> buffer(this->blitter->BufferSize(SCREEN_WIDTH, SCREEN_HEIGHT));
+		this->blitter->CopyToBuffer(_screen.dst_ptr, buffer.data(), SCREEN_WIDTH, SCREEN_HEIGHT);
+		return buffer;
+	}
+};
+
+/**
+ * Get a remap table with every colour mapped to another one.
+ * @return The remap table.
+ */
+static std::array<uint8_t, 256> MakeRemap()
+{
+	std::array<uint8_t, 256> remap;
+	for (uint i = 0; i < remap.size(); i++) remap[i] = (i * 37 + 11) % 256;
+	return remap;
+}
+
+#ifdef WITH_SSE
+TEST_CASE("Blitter_32bppAVX2_Anim - same result as the SSE4 blitter")
+{
+	BlitterFactory *avx2 = BlitterFactory::GetBlitterFactory("32bpp-avx2-anim");
+	BlitterFactory *sse4 = BlitterFactory::GetBlitterFactory("32bpp-sse4-anim");
+	if (avx2 == nullptr || sse4 == nullptr) return;
+
+	const std::vector<StreamSprite> stream = MakeSpriteStream(600);
+	const std::array<uint8_t, 256> remap = MakeRemap();
+
+	BlitterRun expected(sse4, stream);
+	BlitterRun actual(avx2, stream);
+	for (std::optional<BlitterMode> mode : {std::optional<BlitterMode>{}, std::optional<BlitterMode>{BlitterMode::Normal}}) {
+		expected.Draw(stream, mode, remap.data());
+		actual.Draw(stream, mode, remap.data());
+		CHECK(actual.GetScreen() == expected.GetScreen());
+	}
+
+	/* Without animation, as when drawing a giant screenshot, the non-animated blitters are used. */
+	_screen_disable_anim = true;
+	expected.Draw(stream, std::nullopt, remap.data());
+	actual.Draw(stream, std::nullopt, remap.data());
+	_screen_disable_anim = false;
+	CHECK(actual.video == expected.video);
+}
+#endif /* WITH_SSE */
+
+TEST_CASE("Blitter - draw speed of a fixed sprite stream", "[.benchmark]")
+{
+	const std::vector<StreamSprite> stream = MakeSpriteStream(4000);
+	const std::array<uint8_t, 256> remap = MakeRemap();
+
+	for (std::string_view name : {"32bpp-optimized", "32bpp-anim", "32bpp-sse2", "32bpp-sse4", "32bpp-avx2", "32bpp-sse2-anim", "32bpp-sse4-anim", "32bpp-avx2-anim"}) {
+		BlitterFactory *factory = BlitterFactory::GetBlitterFactory(name);
+		if (factory == nullptr) continue;
+
+		BlitterRun run(factory, stream);
+		run.Draw(stream, BlitterMode::Normal, remap.data());
+
+		uint64_t pixels = 0;
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < 50; i++) pixels += run.Draw(stream, BlitterMode::Normal, remap.data());
+		std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+		WARN(fmt::format("{}: {:.1f} MPix/s", name, pixels / duration.count() / 1e6));
+	}
+}
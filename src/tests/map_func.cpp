@@ -0,0 +1,57 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/** @file map_func.cpp Test the whole map scanning functionality from map_func. */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../map_func.h"
+#include "../tile_map.h"
+
+#include "../safeguards.h"
+
+/**
+ * Fill the map with a deterministic pattern of tile types and heights.
+ * Heights vary by at most one between neighbours, with the occasional spike.
+ */
+static void FillTestMap()
+{
+	uint32_t seed = 12345;
+	for (const auto tile : Map::Iterate()) {
+		seed = seed * 1103515245 + 12345;
+		Tile(tile).type() = static_cast<uint8_t>(((seed >> 16) % to_underlying(TileType::End)) << 4 | (seed & 0x0F));
+		uint h = (TileX(tile) / 3 + TileY(tile) / 5) % 16;
+		if ((seed >> 8) % 37 == 0) h += 2;
+		SetTileHeight(tile, h);
+	}
+}
+
+TEST_CASE("Map::GetMaxHeightInArea")
+{
+	Map::Allocate(64, 128);
+	FillTestMap();
+
+	for (uint size = 1; size < 40; size += 7) {
+		for (uint y = 0; y + size <= Map::SizeY(); y += 11) {
+			for (uint x = 0; x + size <= Map::SizeX(); x += 5) {
+				uint expected = 0;
+				for (uint dy = 0; dy < size; dy++) {
+					for (uint dx = 0; dx < size; dx++) {
+						expected = std::max(expected, TileHeight(TileXY(x + dx, y + dy)));
+					}
+				}
+				CHECK(Map::GetMaxHeightInArea(x, y, size, size) == expected);
+			}
+		}
+	}
+
+	uint highest = 0;
+	for (const auto tile : Map::Iterate()) highest = std::max(highest, TileHeight(tile));
+	CHECK(Map::GetMaxHeightInArea(0, 0, Map::SizeX(), Map::SizeY()) == highest);
+}
@@ -0,0 +1,95 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/** @file random_access_file.cpp Test reading files that change while they are open. */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../fileio_func.h"
+#include "../random_access_file_type.h"
+
+#include <filesystem>
+
+#include "../safeguards.h"
+
+/**
+ * Write a file where every byte is the low byte of its position.
+ * @param filename The name of the file.
+ * @param size The size of the file.
+ */
+static void WriteTestFile(const std::string &filename, size_t size)
+{
+	std::vector<uint8_t> data(size);
+	for (size_t i = 0; i < size; i++) data[i] = static_cast<uint8_t>(i);
+
+	auto f = FileHandle::Open(filename, "wb");
+	REQUIRE(f.has_value());
+	REQUIRE(fwrite(data.data(), 1, data.size(), *f) == data.size());
+}
+
+TEST_CASE("RandomAccessFile - file that becomes shorter while it is open")
+{
+	std::string filename = (std::filesystem::temp_directory_path() / "openttd_test_random_access_file.bin").string();
+	_valid_searchpaths.push_back(Searchpath::WorkingDir);
+
+	WriteTestFile(filename, 1 << 16);
+	{
+		RandomAccessFile file(filename, Subdirectory::None);
+		file.SeekTo(1000, SEEK_SET);
+		CHECK(file.ReadByte() == static_cast<uint8_t>(1000));
+
+		bool mapped = file.IsMapped();
+#if defined(UNIX)
+		/* Only 64 bit builds map the files. */
+		if constexpr (sizeof(void *) >= 8) CHECK(mapped);
+#endif
+		std::optional<RandomAccessFile> view;
+		if (mapped) view.emplace(file, RandomAccessFile::View{});
+
+		/* Rebuild the file, like a NewGRF developer would while the game runs. */
+		WriteTestFile(filename, 100);
+
+		/* Reading what is left of the file still works, and reading beyond it does not crash. */
+		file.SeekTo(50, SEEK_SET);
+		CHECK(file.ReadByte() == 50);
+		CHECK_FALSE(file.IsMapped());
+		file.SeekTo(40000, SEEK_SET);
+		CHECK(file.ReadByte() == 0);
+
+		/* A view cannot read the file itself, so it reads nothing. */
+		if (view.has_value()) {
+			view->SeekTo(40000, SEEK_SET);
+			CHECK(view->ReadByte() == 0);
+			CHECK(view->AtEndOfFile());
+		}
+	}
+
+	_valid_searchpaths.pop_back();
+	std::filesystem::remove(filename);
+}
+
+TEST_CASE("RandomAccessFile - unchanged file")
+{
+	std::string filename = (std::filesystem::temp_directory_path() / "openttd_test_random_access_file.bin").string();
+	_valid_searchpaths.push_back(Searchpath::WorkingDir);
+
+	WriteTestFile(filename, 1 << 16);
+	{
+		RandomAccessFile file(filename, Subdirectory::None);
+		bool mapped = file.IsMapped();
+		for (size_t pos : {0, 5000, 65535, 300}) {
+			file.SeekTo(pos, SEEK_SET);
+			CHECK(file.ReadByte() == static_cast<uint8_t>(pos));
+		}
+		CHECK(file.IsMapped() == mapped);
+	}
+
+	_valid_searchpaths.pop_back();
+	std::filesystem::remove(filename);
+}
@@ -0,0 +1,49 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/** @file saveload.cpp Test the hash of the game state. */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../saveload/saveload.h"
+#include "../gamelog.h"
+#include "../map_func.h"
+#include "../openttd.h"
+#include "../tile_map.h"
+
+#include "../safeguards.h"
+
+TEST_CASE("CalculateGameStateHash - same game state, same hash")
+{
+	Map::Allocate(64, 64);
+
+	std::optional<uint64_t> hash = CalculateGameStateHash();
+	REQUIRE(hash.has_value());
+	CHECK(CalculateGameStateHash() == hash);
+
+	/* Loading the game with another build adds to the gamelog, which is not part of the game state. */
+	_gamelog.StartAction(GLAT_LOAD);
+	_gamelog.Revision();
+	_gamelog.StopAction();
+	CHECK(CalculateGameStateHash() == hash);
+
+	/* Every new game gets a random ID, which is not part of the game state either. */
+	_game_session_stats.savegame_id = "0123456789abcdef";
+	CHECK(CalculateGameStateHash() == hash);
+	CHECK(_game_session_stats.savegame_id == "0123456789abcdef");
+	_game_session_stats.savegame_id.clear();
+
+	SetTileHeight(TileXY(10, 10), 1);
+	CHECK(CalculateGameStateHash() != hash);
+
+	SetTileHeight(TileXY(10, 10), 0);
+	CHECK(CalculateGameStateHash() == hash);
+
+	_gamelog.Reset();
+}
@@ -0,0 +1,45 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/** @file smallmap_gui.cpp Test the cache of the smallmap tile colours. */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../smallmap_gui.h"
+#include "../company_base.h"
+#include "../company_func.h"
+#include "../rail_map.h"
+
+#include "../safeguards.h"
+
+TEST_CASE("SmallMapTileCache - merging a company invalidates all tiles")
+{
+	Map::Allocate(64, 64);
+	_local_company = COMPANY_SPECTATOR;
+
+	REQUIRE(Company::CanAllocateItem(2));
+	Company *old_company = Company::Create();
+	Company *new_company = Company::Create();
+
+	const TileIndex owned_tile = TileXY(10, 10);
+	MakeRailNormal(owned_tile, old_company->index, TRACK_BIT_X, RAILTYPE_RAIL);
+	old_company->infrastructure.rail[RAILTYPE_RAIL] = 1;
+
+	/* Pretend the smallmap has determined the colour of every tile. */
+	_smallmap_tile_cache.Validate(SMT_OWNER);
+	std::ranges::fill(_smallmap_tile_cache.importance, 0);
+
+	ChangeOwnershipOfCompanyItems(old_company->index, new_company->index);
+
+	CHECK(GetTileOwner(owned_tile) == new_company->index);
+	CHECK(std::ranges::all_of(_smallmap_tile_cache.importance, [](uint8_t importance) { return importance == SmallMapTileCache::UNCACHED; }));
+
+	_smallmap_tile_cache.Clear();
+	_company_pool.CleanPool();
+}
@@ -0,0 +1,207 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/** @file station_acceptance.cpp Test the cached acceptance of stations. */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../station_base.h"
+#include "../station_map.h"
+#include "../cargotype.h"
+#include "../clear_map.h"
+#include "../house.h"
+#include "../industry.h"
+#include "../industry_map.h"
+#include "../newgrf_house.h"
+#include "../object_base.h"
+#include "../object_map.h"
+#include "../settings_type.h"
+#include "../town.h"
+
+#include "../safeguards.h"
+
+/** Industry tile used for the test industry. */
+static const IndustryGfx TEST_GFX = 0;
+/** Cargo accepted by the test industry tile. */
+static const CargoType TEST_CARGO = 0;
+
+/** Create an empty map, and make the test industry tile accept the test cargo. */
+static void SetupTestMap()
+{
+	Map::Allocate(64, 64);
+	ResetIndustries();
+	_settings_game.station.modified_catchment = true;
+	_settings_game.station.serve_neutral_industries = false;
+
+	/* Independent of the cargoes of any climate. */
+	IndustryTileSpec &itspec = _industry_tile_specs[TEST_GFX];
+	itspec.accepts_cargo.fill(INVALID_CARGO);
+	itspec.acceptance.fill(0);
+	itspec.accepts_cargo[0] = TEST_CARGO;
+	itspec.acceptance[0] = 8;
+}
+
+/** Remove the stations and industries of the test, and restore the industry tiles. */
+static void CleanupTestMap()
+{
+	_station_pool.CleanPool();
+	_industry_pool.CleanPool();
+	ResetIndustries();
+}
+
+/**
+ * Build a rail station of one tile.
+ * @param tile The tile of the station.
+ * @return The station.
+ */
+static Station *BuildTestStation(TileIndex tile)
+{
+	REQUIRE(Station::CanAllocateItem());
+	Station *st = Station::Create(tile);
+	MakeRailStation(tile, OWNER_NONE, st->index, AXIS_X, 0, RAILTYPE_RAIL);
+	st->train_station = TileArea(tile, 1, 1);
+	st->rect.BeforeAddTile(tile, StationRect::ADD_FORCE);
+	st->RecomputeCatchment();
+	return st;
+}
+
+/**
+ * Compare the cached acceptance of a station with the acceptance after rebuilding the cache.
+ * @param st The station.
+ * @param accepted Whether the test cargo should be accepted.
+ */
+static void CheckCachedAcceptance(Station *st, bool accepted = true)
+{
+	auto [cached, cached_always] = st->GetCatchmentAcceptance();
+
+	/* Computing the acceptance again leaves the cache alone. */
+	StationAcceptanceCache fresh = st->ComputeAcceptanceCache();
+	CHECK(st->acceptance_cache.valid);
+	CHECK(fresh.acceptance == st->acceptance_cache.acceptance);
+	CHECK(fresh.dynamic_tiles == st->acceptance_cache.dynamic_tiles);
+
+	st->InvalidateAcceptanceCache();
+	auto [recomputed, recomputed_always] = st->GetCatchmentAcceptance();
+
+	CHECK((recomputed[TEST_CARGO] > 0) == accepted);
+	CHECK(cached == recomputed);
+	CHECK(cached_always == recomputed_always);
+}
+
+TEST_CASE("Station acceptance cache - industry with a neutral station built in the catchment")
+{
+	SetupTestMap();
+
+	Station *st = BuildTestStation(TileXY(20, 20));
+	/* Fill the cache while there is nothing to accept. */
+	st->GetCatchmentAcceptance();
+
+	/* Build an industry with its own station, like an oil rig, next to the station. */
+	REQUIRE(Industry::CanAllocateItem());
+	Industry *ind = Industry::Create(TileXY(22, 20));
+	ind->location = TileArea(TileXY(22, 20), 2, 2);
+	for (TileIndex tile : ind->location) MakeIndustry(tile, ind->index, TEST_GFX, 0, WaterClass::Invalid);
+	REQUIRE(Station::CanAllocateItem());
+	Station *neutral = Station::Create(TileXY(23, 21));
+	neutral->industry = ind;
+	ind->neutral_station = neutral;
+	PopulateStationsNearby(ind);
+
+	CHECK(ind->stations_near.size() == 1);
+	CheckCachedAcceptance(st);
+
+	CleanupTestMap();
+}
+
+TEST_CASE("Station acceptance cache - industry built in the catchment")
+{
+	SetupTestMap();
+
+	Station *st = BuildTestStation(TileXY(20, 20));
+	st->GetCatchmentAcceptance();
+
+	REQUIRE(Industry::CanAllocateItem());
+	Industry *ind = Industry::Create(TileXY(22, 20));
+	ind->location = TileArea(TileXY(22, 20), 2, 2);
+	for (TileIndex tile : ind->location) MakeIndustry(tile, ind->index, TEST_GFX, 0, WaterClass::Invalid);
+	PopulateStationsNearby(ind);
+
+	CHECK(ind->stations_near.contains(st));
+	CheckCachedAcceptance(st);
+
+	CleanupTestMap();
+}
+
+TEST_CASE("Station acceptance cache - house built and removed in the catchment")
+{
+	SetupTestMap();
+	ResetHouses();
+
+	/* A house without callbacks that accepts the test cargo. */
+	HouseSpec *hs = HouseSpec::Get(0);
+	std::fill(std::begin(hs->accepts_cargo), std::end(hs->accepts_cargo), INVALID_CARGO);
+	std::fill(std::begin(hs->cargo_acceptance), std::end(hs->cargo_acceptance), 0);
+	hs->accepts_cargo[0] = TEST_CARGO;
+	hs->cargo_acceptance[0] = 8;
+	hs->callback_mask = {};
+
+	Station *st = BuildTestStation(TileXY(20, 20));
+	st->GetCatchmentAcceptance();
+
+	REQUIRE(Town::CanAllocateItem());
+	Town *t = Town::Create(TileXY(30, 30));
+	TileIndex tile = TileXY(21, 21);
+	MakeHouseTile(tile, t->index, 0, 0, 0, 0, false);
+	st->AddAcceptanceOfTile(tile);
+	CHECK(st->acceptance_cache.acceptance[TEST_CARGO] == 8);
+	CheckCachedAcceptance(st);
+
+	st->RemoveAcceptanceOfTile(tile);
+	MakeClear(tile, ClearGround::Grass, 3);
+	CHECK(st->acceptance_cache.acceptance[TEST_CARGO] == 0);
+	CheckCachedAcceptance(st, false);
+
+	_town_pool.CleanPool();
+	HouseSpec::Specs().clear();
+	CleanupTestMap();
+}
+
+TEST_CASE("Station acceptance cache - company headquarters built and removed in the catchment")
+{
+	SetupTestMap();
+	SetupCargoForClimate(LandscapeType::Temperate);
+	BuildCargoLabelMap();
+	REQUIRE(GetCargoTypeByLabel(CT_PASSENGERS) == TEST_CARGO);
+
+	Station *st = BuildTestStation(TileXY(20, 20));
+	st->GetCatchmentAcceptance();
+
+	REQUIRE(Object::CanAllocateItem());
+	Object *o = Object::Create();
+	o->type = OBJECT_HQ;
+	o->location = TileArea(TileXY(21, 21), 2, 2);
+	for (TileIndex tile : o->location) {
+		MakeObject(tile, CompanyID::Begin(), o->index, WaterClass::Invalid, 0);
+		st->AddAcceptanceOfTile(tile);
+	}
+	/* The acceptance of the headquarters depends on its size, so it is not summed in the cache. */
+	CHECK(st->acceptance_cache.acceptance[TEST_CARGO] == 0);
+	CHECK(st->acceptance_cache.dynamic_tiles.size() == 4);
+	CheckCachedAcceptance(st);
+
+	for (TileIndex tile : o->location) {
+		st->RemoveAcceptanceOfTile(tile);
+		MakeClear(tile, ClearGround::Grass, 3);
+	}
+	CHECK(st->acceptance_cache.dynamic_tiles.empty());
+	CheckCachedAcceptance(st, false);
+
+	_object_pool.CleanPool();
+	CleanupTestMap();
+}
@@ -0,0 +1,262 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/** @file station_func.cpp Test the scheduling of the periodic station actions. */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "mock_environment.h"
+
+#include "../station_func.h"
+#include "../station_base.h"
+#include "../waypoint_base.h"
+#include "../map_func.h"
+
+#include "../safeguards.h"
+
+TEST_CASE("StationTickSchedule - same stations as the modulo test")
+{
+	for (size_t end : {size_t{0}, size_t{1}, size_t{100}, size_t{3000}}) {
+		for (size_t period : {size_t{1}, size_t{7}, size_t{Ticks::STATION_RATING_TICKS}, size_t{Ticks::STATION_ACCEPTANCE_TICKS}, size_t{Ticks::STATION_LINKGRAPH_TICKS}}) {
+			for (TimerGameTick::TickCounter counter : {0ULL, 1ULL, 249ULL, 250ULL, 503ULL, 1000000007ULL, 0xFFFFFFFFULL}) {
+				size_t mismatches = 0;
+				for (TimerGameTick::TickCounter tick = counter; tick < counter + 2 * period; tick++) {
+					std::vector<size_t> expected;
+					for (size_t index = 0; index < end; index++) {
+						if ((tick + index) % period == 0) expected.push_back(index);
+					}
+
+					std::vector<size_t> due;
+					StationTickSchedule(tick, period).ForEachDue(end, [&due](size_t index) { due.push_back(index); });
+					if (due != expected) mismatches++;
+				}
+				CHECK(mismatches == 0);
+			}
+		}
+	}
+}
+
+TEST_CASE("StationTickSchedule - every station is due once per period")
+{
+	const size_t end = 1000;
+	std::vector<int> due_count(end, 0);
+
+	for (TimerGameTick::TickCounter tick = 12345; tick < 12345 + Ticks::STATION_RATING_TICKS; tick++) {
+		StationTickSchedule(tick, Ticks::STATION_RATING_TICKS).ForEachDue(end, [&due_count](size_t index) { due_count[index]++; });
+	}
+
+	for (int count : due_count) CHECK(count == 1);
+}
+
+/** Actions of the station tick, as observed by the test. */
+enum class TestTickAction : uint8_t {
+	Rating,
+	LinkGraph,
+	BigTick,
+	Animation,
+};
+
+/** An action for a station in a tick. */
+using TestTickCall = std::tuple<TimerGameTick::TickCounter, uint16_t, TestTickAction>;
+
+/**
+ * Big tick without side effects other than deleting the stations that are no longer in use.
+ * @param st The station.
+ * @return true if the station is in use.
+ */
+static bool TestBigTick(BaseStation *st)
+{
+	if (!st->IsInUse()) {
+		if (++st->delete_ctr >= 8) delete st;
+		return false;
+	}
+	return true;
+}
+
+/**
+ * The station tick before the scheduler, visiting every station.
+ * @param counter The tick counter.
+ * @param[out] calls The performed actions.
+ */
+static void OldStationTick(TimerGameTick::TickCounter counter, std::vector<TestTickCall> &calls)
+{
+	for (BaseStation *st : BaseStation::Iterate()) {
+		if (!st->facilities.Test(StationFacility::Waypoint) && st->IsInUse()) {
+			uint8_t b = st->delete_ctr + 1;
+			if (b >= Ticks::STATION_RATING_TICKS) b = 0;
+			st->delete_ctr = b;
+			if (b == 0) calls.emplace_back(counter, st->index.base(), TestTickAction::Rating);
+		}
+
+		if (Station::IsExpected(st) && (counter + st->index) % Ticks::STATION_LINKGRAPH_TICKS == 0) {
+			calls.emplace_back(counter, st->index.base(), TestTickAction::LinkGraph);
+		}
+
+		if ((counter + st->index) % Ticks::STATION_ACCEPTANCE_TICKS == 0) {
+			calls.emplace_back(counter, st->index.base(), TestTickAction::BigTick);
+			if (!TestBigTick(st)) continue;
+			calls.emplace_back(counter, st->index.base(), TestTickAction::Animation);
+		}
+	}
+}
+
+/**
+ * The station tick with the scheduler, as done by OnTick_Station.
+ * @param counter The tick counter.
+ * @param[out] calls The performed actions.
+ */
+static void NewStationTick(TimerGameTick::TickCounter counter, std::vector<TestTickCall> &calls)
+{
+	static std::vector<StationTickDue> due;
+	_station_tick_scheduler.Tick(counter, due);
+
+	for (const auto &[index, actions] : due) {
+		BaseStation *st = BaseStation::GetIfValid(index);
+		if (st == nullptr) continue;
+
+		if (actions.Test(StationTickAction::Rating) && !st->facilities.Test(StationFacility::Waypoint) && st->IsInUse()) {
+			calls.emplace_back(counter, st->index.base(), TestTickAction::Rating);
+		}
+
+		if (actions.Test(StationTickAction::LinkGraph) && Station::IsExpected(st)) {
+			calls.emplace_back(counter, st->index.base(), TestTickAction::LinkGraph);
+		}
+
+		if (actions.Test(StationTickAction::Acceptance)) {
+			calls.emplace_back(counter, st->index.base(), TestTickAction::BigTick);
+			if (!TestBigTick(st)) continue;
+			calls.emplace_back(counter, st->index.base(), TestTickAction::Animation);
+		}
+	}
+}
+
+/** Create a pool with stations in and out of use, waypoints and holes. */
+static void SetupTickStations()
+{
+	/* Deleting a station marks its sign dirty, which needs the fonts. */
+	MockEnvironment::Instance();
+	Map::Allocate(64, 64);
+
+	for (uint i = 0; i < 40; i++) {
+		TileIndex tile = TileXY(1 + i, 1 + i);
+		if (i % 9 == 4) {
+			REQUIRE(Waypoint::CanAllocateItem());
+			Waypoint *wp = Waypoint::Create(tile);
+			wp->facilities = {StationFacility::Waypoint, StationFacility::Train};
+			continue;
+		}
+
+		REQUIRE(Station::CanAllocateItem());
+		Station *st = Station::Create(tile);
+		st->owner = CompanyID::Begin();
+		if (i % 5 != 3) st->facilities = {StationFacility::Train};
+		st->delete_ctr = (i * 37) % 8;
+	}
+	/* Counters beyond the rating period, as could be found in old savegames. */
+	Station::Get(StationID{10})->delete_ctr = 184;
+	Station::Get(StationID{11})->delete_ctr = 200;
+	/* Deleted during the test, after which its index can be reused. */
+	Station::Get(StationID{18})->delete_ctr = 7;
+	RebuildStationKdtree();
+
+	delete Station::Get(StationID{7});
+	delete Station::Get(StationID{21});
+}
+
+/** Remove the stations of the test. */
+static void CleanupTickStations()
+{
+	_station_pool.CleanPool();
+	RebuildStationKdtree();
+	_station_tick_scheduler.Rebuild();
+}
+
+/**
+ * Stop or resume using stations, the way removing and building station parts does.
+ * @param tick The number of ticks since the start of the test.
+ */
+static void ChangeTickStations(int tick)
+{
+	auto stop = [](StationID index) {
+		Station *st = Station::Get(index);
+		st->facilities = {};
+		_station_tick_scheduler.Remove(st);
+		st->delete_ctr = 0;
+	};
+	auto resume = [](StationID index) {
+		Station *st = Station::Get(index);
+		st->facilities.Set(StationFacility::Train);
+		_station_tick_scheduler.Add(st);
+	};
+
+	switch (tick) {
+		case 50: stop(StationID{2}); break;
+		case 120: resume(StationID{2}); break;
+		case 200: resume(StationID{3}); break;
+		case 300: {
+			REQUIRE(Station::CanAllocateItem());
+			Station *st = Station::Create(TileXY(50, 50));
+			st->facilities.Set(StationFacility::Dock);
+			_station_tick_scheduler.Add(st);
+			break;
+		}
+		case 400: stop(StationID{10}); break;
+		case 450: resume(StationID{10}); break;
+		default: break;
+	}
+}
+
+/**
+ * Run the station tick for the test stations.
+ * @param tick_func The station tick to run.
+ * @param[out] calls The performed actions.
+ */
+static void RunTickStations(void (*tick_func)(TimerGameTick::TickCounter, std::vector<TestTickCall> &), std::vector<TestTickCall> &calls)
+{
+	for (int tick = 0; tick < 600; tick++) {
+		ChangeTickStations(tick);
+		tick_func(1000 + tick, calls);
+	}
+}
+
+/**
+ * Get the delete counters of the test stations.
+ * @return The delete counters by station index.
+ */
+static std::vector<std::pair<uint16_t, uint8_t>> GetTickStationDeleteCounters()
+{
+	std::vector<std::pair<uint16_t, uint8_t>> delete_ctrs;
+	for (const BaseStation *st : BaseStation::Iterate()) delete_ctrs.emplace_back(st->index.base(), st->delete_ctr);
+	return delete_ctrs;
+}
+
+TEST_CASE("StationTickScheduler - same actions as visiting every station")
+{
+	std::vector<TestTickCall> old_calls;
+	SetupTickStations();
+	RunTickStations(OldStationTick, old_calls);
+	auto old_delete_ctrs = GetTickStationDeleteCounters();
+	CleanupTickStations();
+
+	std::vector<TestTickCall> new_calls;
+	SetupTickStations();
+	_station_tick_scheduler.Rebuild();
+	RunTickStations(NewStationTick, new_calls);
+	/* The delete counters are brought up to date when saving. */
+	_station_tick_scheduler.SyncDeleteCounters();
+	auto new_delete_ctrs = GetTickStationDeleteCounters();
+	CleanupTickStations();
+
+	/* All actions happen, including deleting stations and reusing their index. */
+	for (TestTickAction action : {TestTickAction::Rating, TestTickAction::LinkGraph, TestTickAction::BigTick, TestTickAction::Animation}) {
+		CHECK(std::ranges::count(old_calls, action, [](const TestTickCall &call) { return std::get<2>(call); }) > 0);
+	}
+	CHECK(old_calls == new_calls);
+	CHECK(old_delete_ctrs == new_delete_ctrs);
+}
@@ -0,0 +1,74 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/** @file test_network_poller.cpp Tests for watching many sockets at once. */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../network/core/poller.h"
+
+#include "../safeguards.h"
+
+#if defined(UNIX)
+
+TEST_CASE("SocketPoller - only ready sockets are reported")
+{
+	int pair[2];
+	REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, pair) == 0);
+
+	SocketPoller poller;
+	poller.Watch(pair[0], SocketEvent::Read);
+	CHECK(poller.Poll().empty());
+
+	REQUIRE(write(pair[1], "x", 1) == 1);
+	std::span<const ReadySocket> ready = poller.Poll();
+	REQUIRE(ready.size() == 1);
+	CHECK(ready[0].sock == pair[0]);
+	CHECK(ready[0].handler == nullptr);
+	CHECK(ready[0].events == SocketEvents{SocketEvent::Read});
+
+	poller.Watch(pair[1], SocketEvent::Write);
+	CHECK(poller.Poll().size() == 2);
+
+	/* Unwatching while handling the result hides the socket from the result. */
+	ready = poller.Poll();
+	poller.Unwatch(pair[0]);
+	for (const ReadySocket &r : ready) CHECK(r.events.None() == (r.sock == pair[0]));
+
+	ready = poller.Poll();
+	REQUIRE(ready.size() == 1);
+	CHECK(ready[0].sock == pair[1]);
+
+	poller.Unwatch(pair[1]);
+	CHECK(poller.Poll().empty());
+
+	close(pair[0]);
+	close(pair[1]);
+}
+
+TEST_CASE("SocketPoller - checking a single socket")
+{
+	int pair[2];
+	REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, pair) == 0);
+
+	CHECK(SocketPoller::Check(pair[0], {SocketEvent::Read, SocketEvent::Write}) == SocketEvents{SocketEvent::Write});
+
+	REQUIRE(write(pair[1], "x", 1) == 1);
+	CHECK(SocketPoller::Check(pair[0], {SocketEvent::Read, SocketEvent::Write}) == SocketEvents{SocketEvent::Read, SocketEvent::Write});
+
+	/* A hang-up is reported as readable, so the reader notices it. */
+	close(pair[1]);
+	char c;
+	REQUIRE(read(pair[0], &c, 1) == 1);
+	CHECK(SocketPoller::Check(pair[0], SocketEvent::Read).Test(SocketEvent::Read));
+
+	close(pair[0]);
+}
+
+#endif /* UNIX */
@@ -0,0 +1,146 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/** @file test_network_tcp.cpp Tests for sending and receiving packets over TCP sockets. */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../network/core/tcp.h"
+#include "../network/core/io_thread.h"
+
+#include "../safeguards.h"
+
+#if defined(UNIX)
+
+TEST_CASE("NetworkTCPSocketHandler - packets survive batched sending and receiving")
+{
+	int pair[2];
+	REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, pair) == 0);
+	SetNonBlocking(pair[0]);
+	SetNonBlocking(pair[1]);
+
+	NetworkTCPSocketHandler sender(pair[0]);
+	NetworkTCPSocketHandler receiver(pair[1]);
+
+	/* Packets of all kinds of sizes, more than fit in one gathered send, and more than the OS buffers at once. */
+	static constexpr uint32_t PACKETS = 2000;
+	for (uint32_t i = 0; i < PACKETS; i++) {
+		auto p = std::make_unique<Packet>(&sender, static_cast<PacketType>(i % 200), TCP_MTU);
+		p->Send_uint32(i);
+		for (uint32_t j = 0; j < (i * 37) % 3000; j++) p->Send_uint8(static_cast<uint8_t>(i + j));
+		sender.SendPacket(std::move(p));
+	}
+
+	uint32_t received = 0;
+	while (received < PACKETS) {
+		sender.writable = true;
+		SendPacketsState state = sender.SendPackets();
+		REQUIRE(state != SPS_CLOSED);
+
+		uint32_t before = received;
+		for (std::unique_ptr<Packet> p = receiver.ReceivePacket(); p != nullptr; p = receiver.ReceivePacket()) {
+			CHECK(p->GetPacketType() == received % 200);
+			p->Recv_uint8();
+			CHECK(p->Recv_uint32() == received);
+			uint32_t length = (received * 37) % 3000;
+			for (uint32_t j = 0; j < length; j++) {
+				if (p->Recv_uint8() != static_cast<uint8_t>(received + j)) FAIL("Packet " << received << " is corrupted at byte " << j);
+			}
+			received++;
+		}
+		REQUIRE((received != before || state != SPS_ALL_SENT));
+	}
+	CHECK(!sender.HasSendQueue());
+	CHECK(!receiver.HasReceivedData());
+}
+
+TEST_CASE("NetworkTCPSocketHandler - shared packets reach every socket")
+{
+	auto shared = std::make_shared<Packet>(nullptr, static_cast<PacketType>(42), TCP_MTU);
+	shared->Send_uint32(0x12345678);
+	shared->Send_string("shared");
+	shared->PrepareToSend();
+
+	for (int i = 0; i < 3; i++) {
+		int pair[2];
+		REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, pair) == 0);
+		SetNonBlocking(pair[0]);
+		SetNonBlocking(pair[1]);
+
+		NetworkTCPSocketHandler sender(pair[0]);
+		NetworkTCPSocketHandler receiver(pair[1]);
+
+		sender.SendPacket(std::shared_ptr<const Packet>(shared));
+		sender.writable = true;
+		REQUIRE(sender.SendPackets() == SPS_ALL_SENT);
+
+		std::unique_ptr<Packet> p = receiver.ReceivePacket();
+		REQUIRE(p != nullptr);
+		CHECK(p->GetPacketType() == 42);
+		p->Recv_uint8();
+		CHECK(p->Recv_uint32() == 0x12345678);
+		CHECK(p->Recv_string(TCP_MTU) == "shared");
+	}
+
+	/* The shared packet is not consumed by sending it. */
+	CHECK(shared->RemainingBytesToTransfer() == shared->Size());
+}
+
+TEST_CASE("NetworkIOThread - packets are sent and received by the thread")
+{
+	int pair[2];
+	REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, pair) == 0);
+	SetNonBlocking(pair[0]);
+	SetNonBlocking(pair[1]);
+
+	NetworkTCPSocketHandler sender(pair[0]);
+	NetworkTCPSocketHandler receiver(pair[1]);
+
+	NetworkIOThread io_thread;
+	REQUIRE(io_thread.Start());
+	io_thread.Adopt(sender);
+	io_thread.Adopt(receiver);
+	CHECK(sender.HasIOThread());
+
+	static constexpr uint32_t PACKETS = 500;
+	for (uint32_t i = 0; i < PACKETS; i++) {
+		auto p = std::make_unique<Packet>(&sender, static_cast<PacketType>(i % 200), TCP_MTU);
+		p->Send_uint32(i);
+		for (uint32_t j = 0; j < (i * 37) % 3000; j++) p->Send_uint8(static_cast<uint8_t>(i + j));
+		sender.SendPacket(std::move(p));
+	}
+	sender.SendPackets();
+
+	uint32_t received = 0;
+	for (int tries = 0; received < PACKETS && tries < 5000; tries++) {
+		io_thread.HandleReceived([&received, &receiver](NetworkTCPSocketHandler *handler) {
+			REQUIRE(handler == &receiver);
+			for (std::unique_ptr<Packet> p = handler->ReceivePacket(); p != nullptr; p = handler->ReceivePacket()) {
+				CHECK(p->GetPacketType() == received % 200);
+				p->Recv_uint8();
+				CHECK(p->Recv_uint32() == received);
+				uint32_t length = (received * 37) % 3000;
+				for (uint32_t j = 0; j < length; j++) {
+					if (p->Recv_uint8() != static_cast<uint8_t>(received + j)) FAIL("Packet " << received << " is corrupted at byte " << j);
+				}
+				received++;
+			}
+		});
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	CHECK(received == PACKETS);
+
+	/* Closing takes the connections back from the thread. */
+	sender.CloseSocket();
+	CHECK(!sender.HasIOThread());
+	io_thread.Stop();
+	CHECK(!receiver.HasIOThread());
+}
+
+#endif /* UNIX */
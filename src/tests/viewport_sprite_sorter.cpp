@@ -0,0 +1,113 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/** @file viewport_sprite_sorter.cpp Tests for the viewport sprite sorters. */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../viewport_sprite_sorter.h"
+
+#include "../safeguards.h"
+
+/**
+ * Create a grid of tile-like sprites with some objects on top, in roughly the order the viewport would add them.
+ * @param size The number of tiles along each axis.
+ * @return The sprites.
+ */
+static std::vector<ParentSpriteToDraw> MakeSprites(int size)
+{
+	std::vector<ParentSpriteToDraw> sprites;
+	uint32_t seed = 42;
+	for (int y = 0; y < size; y++) {
+		for (int x = 0; x < size; x++) {
+			seed = seed * 1103515245 + 12345;
+			int z = (seed >> 16) % 3 * 8;
+
+			ParentSpriteToDraw &ground = sprites.emplace_back();
+			ground.xmin = x * 16;
+			ground.ymin = y * 16;
+			ground.zmin = z;
+			ground.xmax = x * 16 + 15;
+			ground.ymax = y * 16 + 15;
+			ground.zmax = z + 1;
+
+			if ((seed >> 8) % 3 != 0) continue;
+
+			/* Something standing on the tile, possibly sticking out of it. */
+			ParentSpriteToDraw &object = sprites.emplace_back();
+			int offset = (seed >> 4) % 12;
+			object.xmin = x * 16 + offset;
+			object.ymin = y * 16 + offset / 2;
+			object.zmin = z + 1;
+			object.xmax = object.xmin + 3 + (seed >> 12) % 20;
+			object.ymax = object.ymin + 3 + (seed >> 20) % 6;
+			object.zmax = object.zmin + 8 + (seed >> 24) % 30;
+		}
+	}
+	return sprites;
+}
+
+/**
+ * Sort the sprites and return the resulting order as indices into the sprites.
+ * @param sprites The sprites to sort; they are modified by the sorter.
+ * @param sorter The sorter to use.
+ * @return The indices of the sprites in draw order.
+ */
+static std::vector<size_t> Sort(std::vector<ParentSpriteToDraw> &sprites, VpSpriteSorter sorter)
+{
+	ParentSpriteToSortVector psdv;
+	for (auto &psd : sprites) psdv.push_back(&psd);
+	sorter(&psdv);
+
+	std::vector<size_t> result;
+	for (const ParentSpriteToDraw *psd : psdv) result.push_back(psd - sprites.data());
+	return result;
+}
+
+TEST_CASE("ViewportSortParentSpritesBatched - sprites entirely behind others are drawn first")
+{
+	std::vector<ParentSpriteToDraw> sprites = MakeSprites(24);
+	std::vector<size_t> order = Sort(sprites, &ViewportSortParentSpritesBatched);
+	REQUIRE(order.size() == sprites.size());
+
+	std::vector<size_t> draw_position(sprites.size(), SIZE_MAX);
+	for (size_t i = 0; i < order.size(); i++) draw_position[order[i]] = i;
+	REQUIRE(std::ranges::find(draw_position, SIZE_MAX) == draw_position.end());
+
+	for (size_t a = 0; a < sprites.size(); a++) {
+		for (size_t b = 0; b < sprites.size(); b++) {
+			const ParentSpriteToDraw &p = sprites[a];
+			const ParentSpriteToDraw &s = sprites[b];
+			if (p.xmax < s.xmin && p.ymax < s.ymin && p.zmax < s.zmin) CHECK(draw_position[a] < draw_position[b]);
+		}
+	}
+}
+
+TEST_CASE("ViewportSortParentSpritesBatched - same order as the reference sorter")
+{
+	/* Also sorts smaller sets after larger ones, so the buffers of the sorter are reused. */
+	for (int size : {1, 2, 7, 32, 3, 20}) {
+		std::vector<ParentSpriteToDraw> batched = MakeSprites(size);
+		std::vector<ParentSpriteToDraw> reference = batched;
+		CHECK(Sort(batched, &ViewportSortParentSpritesBatched) == Sort(reference, &ViewportSortParentSprites));
+	}
+}
+
+#ifdef WITH_SSE
+TEST_CASE("ViewportSortParentSpritesBatched - same order as the SSE4.1 sorter")
+{
+	if (!ViewportSortParentSpritesSSE41Checker()) return;
+
+	for (int size : {1, 2, 7, 32}) {
+		std::vector<ParentSpriteToDraw> batched = MakeSprites(size);
+		std::vector<ParentSpriteToDraw> sse = batched;
+		CHECK(Sort(batched, &ViewportSortParentSpritesBatched) == Sort(sse, &ViewportSortParentSpritesSSE41));
+	}
+}
+#endif /* WITH_SSE */
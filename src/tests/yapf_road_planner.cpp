@@ -0,0 +1,193 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/** @file yapf_road_planner.cpp Test the road planner for scripts. */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../pathfinder/yapf/yapf_road_planner.h"
+#include "../clear_map.h"
+#include "../map_func.h"
+#include "../road.h"
+#include "../road_map.h"
+#include "../tunnel_map.h"
+#include "../water_map.h"
+
+#include <thread>
+
+#include "../safeguards.h"
+
+/**
+ * Plan a road between two tiles.
+ * @param source The tile to start at.
+ * @param goal The tile to end at.
+ * @param costs The costs of the parts of the road.
+ * @return The tiles of the road, empty when none was found.
+ */
+static std::vector<TileIndex> PlanRoad(TileIndex source, TileIndex goal, const RoadPlannerCosts &costs = {})
+{
+	std::array<TileIndex, 1> sources{source};
+	std::array<TileIndex, 1> goals{goal};
+	RoadPlan plan(costs, sources, goals);
+	plan.Search();
+	return {plan.GetPath().begin(), plan.GetPath().end()};
+}
+
+/**
+ * Build a road over all tiles of a line.
+ * @param from The first tile.
+ * @param to The last tile, in a straight line from the first tile.
+ */
+static void BuildRoad(TileIndex from, TileIndex to)
+{
+	for (TileIndex tile : TileArea(from, to)) {
+		MakeRoadNormal(tile, ROAD_ALL, ROADTYPE_ROAD, INVALID_ROADTYPE, TownID::Invalid(), OWNER_NONE, OWNER_NONE);
+	}
+}
+
+/**
+ * Check that consecutive tiles of a road are adjacent.
+ * @param path The road.
+ * @return The number of consecutive tiles that are not adjacent.
+ */
+static int CountJumps(const std::vector<TileIndex> &path)
+{
+	int jumps = 0;
+	for (size_t i = 1; i < path.size(); i++) {
+		if (DistanceManhattan(path[i - 1], path[i]) != 1) jumps++;
+	}
+	return jumps;
+}
+
+TEST_CASE("RoadPlan - straight road over empty land")
+{
+	Map::Allocate(64, 64);
+
+	std::vector<TileIndex> path = PlanRoad(TileXY(5, 10), TileXY(15, 10));
+	REQUIRE(path.size() == 11);
+	CHECK(path.front() == TileXY(5, 10));
+	CHECK(path.back() == TileXY(15, 10));
+	for (TileIndex tile : path) CHECK(TileY(tile) == 10);
+	CHECK(CountJumps(path) == 0);
+}
+
+TEST_CASE("RoadPlan - existing road against new road")
+{
+	Map::Allocate(64, 64);
+	ResetRoadTypes();
+
+	/* A detour over existing road around the straight line. */
+	BuildRoad(TileXY(5, 10), TileXY(5, 14));
+	BuildRoad(TileXY(5, 14), TileXY(15, 14));
+	BuildRoad(TileXY(15, 10), TileXY(15, 14));
+
+	RoadPlannerCosts costs;
+	costs.new_road = 0;
+	std::vector<TileIndex> path = PlanRoad(TileXY(5, 10), TileXY(15, 10), costs);
+	CHECK(path.size() == 11);
+	CHECK(std::ranges::find(path, TileXY(10, 14)) == path.end());
+
+	costs.new_road = 1000;
+	path = PlanRoad(TileXY(5, 10), TileXY(15, 10), costs);
+	CHECK(path.size() == 19);
+	CHECK(std::ranges::find(path, TileXY(10, 14)) != path.end());
+	CHECK(CountJumps(path) == 0);
+}
+
+TEST_CASE("RoadPlan - through a tunnel")
+{
+	Map::Allocate(64, 64);
+	ResetRoadTypes();
+
+	/* A sea across the map, with a tunnel below it. */
+	for (uint y = 1; y < Map::MaxY(); y++) {
+		for (uint x = 11; x <= 13; x++) MakeSea(TileXY(x, y));
+	}
+	MakeRoadTunnel(TileXY(10, 20), OWNER_NONE, DIAGDIR_SW, ROADTYPE_ROAD, INVALID_ROADTYPE);
+	MakeRoadTunnel(TileXY(14, 20), OWNER_NONE, DIAGDIR_NE, ROADTYPE_ROAD, INVALID_ROADTYPE);
+
+	std::vector<TileIndex> path = PlanRoad(TileXY(5, 10), TileXY(20, 10));
+	REQUIRE(!path.empty());
+	CHECK(CountJumps(path) == 1);
+	auto it = std::ranges::find(path, TileXY(10, 20));
+	REQUIRE(it != path.end());
+	REQUIRE(std::next(it) != path.end());
+	CHECK(*std::next(it) == TileXY(14, 20));
+
+	/* Between its two ends, the tunnel itself is the shortest road. */
+	path = PlanRoad(TileXY(10, 20), TileXY(14, 20));
+	CHECK(path == std::vector<TileIndex>{TileXY(10, 20), TileXY(14, 20)});
+}
+
+TEST_CASE("RoadPlan - no road to a goal surrounded by sea")
+{
+	Map::Allocate(64, 64);
+
+	for (TileIndex tile : TileArea(TileXY(18, 8), TileXY(22, 12))) MakeSea(tile);
+	MakeClear(TileXY(20, 10), ClearGround::Grass, 3);
+
+	CHECK(PlanRoad(TileXY(5, 10), TileXY(20, 10)).empty());
+}
+
+TEST_CASE("RoadPlan - maximum number of nodes")
+{
+	Map::Allocate(64, 64);
+
+	RoadPlannerCosts costs;
+	costs.max_nodes = 10;
+	CHECK(PlanRoad(TileXY(5, 10), TileXY(45, 10), costs).empty());
+
+	costs.max_nodes = 100000;
+	CHECK(PlanRoad(TileXY(5, 10), TileXY(45, 10), costs).size() == 41);
+}
+
+TEST_CASE("RoadPlan - abort and restart")
+{
+	Map::Allocate(256, 256);
+
+	std::array<TileIndex, 1> sources{TileXY(10, 10)};
+	std::array<TileIndex, 1> goals{TileXY(200, 10)};
+
+	/* An aborted search does not find a road, ... */
+	RoadPlan aborted({}, sources, goals);
+	aborted.Abort();
+	aborted.Search();
+	CHECK(aborted.GetPath().empty());
+
+	/* ... also when it is aborted while it runs, ... */
+	RoadPlan running({}, sources, goals);
+	std::thread thread([&running]() { running.Search(); });
+	running.Abort();
+	thread.join();
+
+	/* ... but a new search with the same tiles does. */
+	RoadPlan restarted({}, sources, goals);
+	restarted.Search();
+	CHECK(restarted.GetPath().size() == 191);
+}
+
+TEST_CASE("RoadPlan - limited search area")
+{
+	Map::Allocate(512, 512);
+
+	/* The room around the tiles is made smaller to stay within the maximum area, ... */
+	std::array<TileIndex, 2> sources{TileXY(10, 10), TileXY(10, 110)};
+	std::array<TileIndex, 1> goals{TileXY(310, 110)};
+	uint area = RoadPlan::GetSearchAreaSize(sources, goals);
+	CHECK(area <= RoadPlan::MAX_SEARCH_AREA);
+	CHECK(area > 301 * 101);
+
+	RoadPlan plan({}, sources, goals);
+	plan.Search();
+	CHECK(plan.GetPath().size() == 301);
+
+	/* ... but the tiles themselves can be too far apart. */
+	goals[0] = TileXY(310, 310);
+	CHECK(RoadPlan::GetSearchAreaSize(sources, goals) > RoadPlan::MAX_SEARCH_AREA);
+}
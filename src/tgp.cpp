@@ -145,6 +145,7 @@
 #include "genworld.h"
 #include "core/random_func.hpp"
 #include "landscape_type.h"
+#include "thread.h"
 
 #include "safeguards.h"
 
@@ -356,13 +357,60 @@ static inline void FreeHeightMap()
 
 /**
  * Generates new random height in given amplitude (generated numbers will range from - amplitude to + amplitude)
+ * @param randomizer The random number generator of the row the height is for.
  * @param r_max Limit of result
  * @return generated height
  */
-static inline Height RandomHeight(Amplitude r_max)
+static inline Height RandomHeight(Randomizer &randomizer, Amplitude r_max)
 {
 	/* Spread height into range -r_max..+r_max */
-	return A2H(RandomRange(2 * r_max + 1) - r_max);
+	return A2H(randomizer.Next(2 * r_max + 1) - r_max);
+}
+
+/**
+ * Get a random number generator for one row of the height map.
+ * Every row gets its own generator, so the rows can be filled in any order, and on any
+ * number of threads, while a given seed still results in the same height map.
+ * @param seed The seed of the whole pass over the height map.
+ * @param row The row of the pass.
+ * @return The random number generator for the row.
+ */
+static Randomizer GetRowRandomizer(uint32_t seed, uint32_t row)
+{
+	/* Mix the row into the seed, as the first number drawn is close to the seed itself. */
+	uint32_t row_seed = seed ^ (row * 0x9E3779B9U);
+	row_seed ^= row_seed >> 16;
+	row_seed *= 0x85EBCA6BU;
+	row_seed ^= row_seed >> 13;
+	row_seed *= 0xC2B2AE35U;
+	row_seed ^= row_seed >> 16;
+
+	Randomizer randomizer;
+	randomizer.SetSeed(row_seed);
+	return randomizer;
+}
+
+/** Minimum number of rows of the height map to give each thread when working on the rows in parallel. */
+static const size_t MIN_PARALLEL_ROWS = 64;
+/** Minimum number of columns of the height map to give each thread when working on the columns in parallel. */
+static const size_t MIN_PARALLEL_COLUMNS = 64;
+
+/**
+ * Call a function for every \a step th row of the height map, spread over multiple threads.
+ * @param first The first row.
+ * @param last The last row to consider; it is included when it is a multiple of \a step away from \a first.
+ * @param step The distance between the rows.
+ * @param func The function to call with the number of the row within the pass and the y coordinate of the row.
+ */
+template <class TFn>
+static void ForEachHeightMapRow(int first, int last, int step, TFn &&func)
+{
+	if (last < first) return;
+
+	size_t rows = (last - first) / step + 1;
+	ParallelFor(rows, MIN_PARALLEL_ROWS, [first, step, &func](size_t begin, size_t end) {
+		for (size_t row = begin; row < end; row++) func(static_cast<uint32_t>(row), first + static_cast<int>(row) * step);
+	});
 }
 
 /**
@@ -389,45 +437,50 @@ static void HeightMapGenerate()
 
 		const int step = 1 << (MAX_TGP_FREQUENCIES - frequency - 1);
 
+		/* All rows draw from their own generator, seeded from a single draw of the game's one. */
+		const uint32_t seed = Random();
+
 		if (first) {
 			/* This is first round, we need to establish base heights with step = size_min */
-			for (int y = 0; y <= _height_map.size_y; y += step) {
+			ForEachHeightMapRow(0, _height_map.size_y, step, [step, amplitude, seed](uint32_t row, int y) {
+				Randomizer randomizer = GetRowRandomizer(seed, row);
 				for (int x = 0; x <= _height_map.size_x; x += step) {
-					Height height = (amplitude > 0) ? RandomHeight(amplitude) : 0;
+					Height height = (amplitude > 0) ? RandomHeight(randomizer, amplitude) : 0;
 					_height_map.height(x, y) = height;
 				}
-			}
+			});
 			first = false;
 			continue;
 		}
 
 		/* It is regular iteration round.
 		 * Interpolate height values at odd x, even y tiles */
-		for (int y = 0; y <= _height_map.size_y; y += 2 * step) {
+		ForEachHeightMapRow(0, _height_map.size_y, 2 * step, [step](uint32_t, int y) {
 			for (int x = 0; x <= _height_map.size_x - 2 * step; x += 2 * step) {
 				Height h00 = _height_map.height(x + 0 * step, y);
 				Height h02 = _height_map.height(x + 2 * step, y);
 				Height h01 = (h00 + h02) / 2;
 				_height_map.height(x + 1 * step, y) = h01;
 			}
-		}
+		});
 
-		/* Interpolate height values at odd y tiles */
-		for (int y = 0; y <= _height_map.size_y - 2 * step; y += 2 * step) {
+		/* Interpolate height values at odd y tiles; these only read the even rows. */
+		ForEachHeightMapRow(0, _height_map.size_y - 2 * step, 2 * step, [step](uint32_t, int y) {
 			for (int x = 0; x <= _height_map.size_x; x += step) {
 				Height h00 = _height_map.height(x, y + 0 * step);
 				Height h20 = _height_map.height(x, y + 2 * step);
 				Height h10 = (h00 + h20) / 2;
 				_height_map.height(x, y + 1 * step) = h10;
 			}
-		}
+		});
 
 		/* Add noise for next higher frequency (smaller steps) */
-		for (int y = 0; y <= _height_map.size_y; y += step) {
+		ForEachHeightMapRow(0, _height_map.size_y, step, [step, amplitude, seed](uint32_t row, int y) {
+			Randomizer randomizer = GetRowRandomizer(seed, row);
 			for (int x = 0; x <= _height_map.size_x; x += step) {
-				_height_map.height(x, y) += RandomHeight(amplitude);
+				_height_map.height(x, y) += RandomHeight(randomizer, amplitude);
 			}
-		}
+		});
 	}
 }
 
@@ -533,37 +586,41 @@ static double SineTransformPlateaus(double &fheight)
  */
 static void HeightMapSineTransform(Height h_min, Height h_max)
 {
-	for (Height &h : _height_map.h) {
-		double fheight;
-
-		if (h < h_min) continue;
-
-		/* Transform height into 0..1 space */
-		fheight = (double)(h - h_min) / (double)(h_max - h_min);
-
-		switch (_settings_game.game_creation.average_height) {
-			case GenworldAverageHeight::Auto:
-				/* Apply sine transform depending on landscape type */
-				switch (_settings_game.game_creation.landscape) {
-					case LandscapeType::Temperate: fheight = SineTransformNormal(fheight); break;
-					case LandscapeType::Tropic: fheight = SineTransformLowlands(fheight); break;
-					case LandscapeType::Arctic: fheight = SineTransformPlateaus(fheight); break;
-					case LandscapeType::Toyland: fheight = SineTransformNormal(fheight); break;
-					default: NOT_REACHED();
-				}
-				break;
+	/* Every height is transformed on its own, so the rows can be done in parallel. */
+	ForEachHeightMapRow(0, _height_map.size_y, 1, [h_min, h_max](uint32_t, int y) {
+		for (int x = 0; x < _height_map.dim_x; x++) {
+			Height &h = _height_map.height(x, y);
+			double fheight;
+
+			if (h < h_min) continue;
+
+			/* Transform height into 0..1 space */
+			fheight = (double)(h - h_min) / (double)(h_max - h_min);
+
+			switch (_settings_game.game_creation.average_height) {
+				case GenworldAverageHeight::Auto:
+					/* Apply sine transform depending on landscape type */
+					switch (_settings_game.game_creation.landscape) {
+						case LandscapeType::Temperate: fheight = SineTransformNormal(fheight); break;
+						case LandscapeType::Tropic: fheight = SineTransformLowlands(fheight); break;
+						case LandscapeType::Arctic: fheight = SineTransformPlateaus(fheight); break;
+						case LandscapeType::Toyland: fheight = SineTransformNormal(fheight); break;
+						default: NOT_REACHED();
+					}
+					break;
 
-			case GenworldAverageHeight::Lowlands: fheight = SineTransformLowlands(fheight); break;
-			case GenworldAverageHeight::Normal: fheight = SineTransformNormal(fheight); break;
-			case GenworldAverageHeight::Plateaus: fheight = SineTransformPlateaus(fheight); break;
-			default: NOT_REACHED();
-		}
+				case GenworldAverageHeight::Lowlands: fheight = SineTransformLowlands(fheight); break;
+				case GenworldAverageHeight::Normal: fheight = SineTransformNormal(fheight); break;
+				case GenworldAverageHeight::Plateaus: fheight = SineTransformPlateaus(fheight); break;
+				default: NOT_REACHED();
+			}
 
-		/* Transform it back into h_min..h_max space */
-		h = static_cast<Height>(fheight * (h_max - h_min) + h_min);
-		if (h < 0) h = I2H(0);
-		if (h >= h_max) h = h_max - 1;
-	}
+			/* Transform it back into h_min..h_max space */
+			h = static_cast<Height>(fheight * (h_max - h_min) + h_min);
+			if (h < 0) h = I2H(0);
+			if (h >= h_max) h = h_max - 1;
+		}
+	});
 }
 
 /**
@@ -601,8 +658,6 @@ static void HeightMapCurves(uint level)
 
 	const std::span<const ControlPoint> curve_maps[] = { curve_map_1, curve_map_2, curve_map_3, curve_map_4 };
 
-	std::array<Height, std::size(curve_maps)> ht{};
-
 	/* Set up a grid to choose curve maps based on location; attempt to get a somewhat square grid */
 	float factor = sqrt((float)_height_map.size_x / (float)_height_map.size_y);
 	uint sx = Clamp((int)(((1 << level) * factor) + 0.5), 1, 128);
@@ -613,90 +668,94 @@ static void HeightMapCurves(uint level)
 		c[i] = RandomRange(static_cast<uint32_t>(std::size(curve_maps)));
 	}
 
-	/* Apply curves */
-	for (int x = 0; x < _height_map.size_x; x++) {
-
-		/* Get our X grid positions and bi-linear ratio */
-		float fx = (float)(sx * x) / _height_map.size_x + 1.0f;
-		uint x1 = (uint)fx;
-		uint x2 = x1;
-		float xr = 2.0f * (fx - x1) - 1.0f;
-		xr = sin(xr * M_PI_2);
-		xr = sin(xr * M_PI_2);
-		xr = 0.5f * (xr + 1.0f);
-		float xri = 1.0f - xr;
-
-		if (x1 > 0) {
-			x1--;
-			if (x2 >= sx) x2--;
-		}
-
-		for (int y = 0; y < _height_map.size_y; y++) {
-
-			/* Get our Y grid position and bi-linear ratio */
-			float fy = (float)(sy * y) / _height_map.size_y + 1.0f;
-			uint y1 = (uint)fy;
-			uint y2 = y1;
-			float yr = 2.0f * (fy - y1) - 1.0f;
-			yr = sin(yr * M_PI_2);
-			yr = sin(yr * M_PI_2);
-			yr = 0.5f * (yr + 1.0f);
-			float yri = 1.0f - yr;
-
-			if (y1 > 0) {
-				y1--;
-				if (y2 >= sy) y2--;
+	/* Apply curves; every column only depends on the grid, so they can be done in parallel. */
+	ParallelFor(_height_map.size_x, MIN_PARALLEL_COLUMNS, [&](size_t first_x, size_t last_x) {
+		std::array<Height, std::size(curve_maps)> ht{};
+
+		for (int x = static_cast<int>(first_x); x < static_cast<int>(last_x); x++) {
+
+			/* Get our X grid positions and bi-linear ratio */
+			float fx = (float)(sx * x) / _height_map.size_x + 1.0f;
+			uint x1 = (uint)fx;
+			uint x2 = x1;
+			float xr = 2.0f * (fx - x1) - 1.0f;
+			xr = sin(xr * M_PI_2);
+			xr = sin(xr * M_PI_2);
+			xr = 0.5f * (xr + 1.0f);
+			float xri = 1.0f - xr;
+
+			if (x1 > 0) {
+				x1--;
+				if (x2 >= sx) x2--;
 			}
 
-			uint corner_a = c[x1 + sx * y1];
-			uint corner_b = c[x1 + sx * y2];
-			uint corner_c = c[x2 + sx * y1];
-			uint corner_d = c[x2 + sx * y2];
+			for (int y = 0; y < _height_map.size_y; y++) {
+
+				/* Get our Y grid position and bi-linear ratio */
+				float fy = (float)(sy * y) / _height_map.size_y + 1.0f;
+				uint y1 = (uint)fy;
+				uint y2 = y1;
+				float yr = 2.0f * (fy - y1) - 1.0f;
+				yr = sin(yr * M_PI_2);
+				yr = sin(yr * M_PI_2);
+				yr = 0.5f * (yr + 1.0f);
+				float yri = 1.0f - yr;
+
+				if (y1 > 0) {
+					y1--;
+					if (y2 >= sy) y2--;
+				}
+
+				uint corner_a = c[x1 + sx * y1];
+				uint corner_b = c[x1 + sx * y2];
+				uint corner_c = c[x2 + sx * y1];
+				uint corner_d = c[x2 + sx * y2];
 
-			/* Bitmask of which curve maps are chosen, so that we do not bother
-			 * calculating a curve which won't be used. */
-			uint corner_bits = 0;
-			corner_bits |= 1 << corner_a;
-			corner_bits |= 1 << corner_b;
-			corner_bits |= 1 << corner_c;
-			corner_bits |= 1 << corner_d;
+				/* Bitmask of which curve maps are chosen, so that we do not bother
+				 * calculating a curve which won't be used. */
+				uint corner_bits = 0;
+				corner_bits |= 1 << corner_a;
+				corner_bits |= 1 << corner_b;
+				corner_bits |= 1 << corner_c;
+				corner_bits |= 1 << corner_d;
 
-			Height *h = &_height_map.height(x, y);
+				Height *h = &_height_map.height(x, y);
 
-			/* Do not touch sea level */
-			if (*h < I2H(1)) continue;
+				/* Do not touch sea level */
+				if (*h < I2H(1)) continue;
 
-			/* Only scale above sea level */
-			*h -= I2H(1);
+				/* Only scale above sea level */
+				*h -= I2H(1);
 
-			/* Apply all curve maps that are used on this tile. */
-			for (size_t t = 0; t < std::size(curve_maps); t++) {
-				if (!HasBit(corner_bits, static_cast<uint8_t>(t))) continue;
+				/* Apply all curve maps that are used on this tile. */
+				for (size_t t = 0; t < std::size(curve_maps); t++) {
+					if (!HasBit(corner_bits, static_cast<uint8_t>(t))) continue;
 
-				[[maybe_unused]] bool found = false;
-				auto &cm = curve_maps[t];
-				for (size_t i = 0; i < cm.size() - 1; i++) {
-					const ControlPoint &p1 = cm[i];
-					const ControlPoint &p2 = cm[i + 1];
+					[[maybe_unused]] bool found = false;
+					auto &cm = curve_maps[t];
+					for (size_t i = 0; i < cm.size() - 1; i++) {
+						const ControlPoint &p1 = cm[i];
+						const ControlPoint &p2 = cm[i + 1];
 
-					if (*h >= p1.x && *h < p2.x) {
-						ht[t] = p1.y + (*h - p1.x) * (p2.y - p1.y) / (p2.x - p1.x);
+						if (*h >= p1.x && *h < p2.x) {
+							ht[t] = p1.y + (*h - p1.x) * (p2.y - p1.y) / (p2.x - p1.x);
 #ifdef WITH_ASSERT
-						found = true;
+							found = true;
 #endif
-						break;
+							break;
+						}
 					}
+					assert(found);
 				}
-				assert(found);
-			}
 
-			/* Apply interpolation of curve map results. */
-			*h = (Height)((ht[corner_a] * yri + ht[corner_b] * yr) * xri + (ht[corner_c] * yri + ht[corner_d] * yr) * xr);
+				/* Apply interpolation of curve map results. */
+				*h = (Height)((ht[corner_a] * yri + ht[corner_b] * yr) * xri + (ht[corner_c] * yri + ht[corner_d] * yr) * xr);
 
-			/* Re-add sea level */
-			*h += I2H(1);
+				/* Re-add sea level */
+				*h += I2H(1);
+			}
 		}
-	}
+	});
 }
 
 /**
@@ -1076,11 +1135,11 @@ void GenerateTerrainPerlin()
 	int max_height = H2I(TGPGetMaxHeight());
 
 	/* Transfer height map into OTTD map */
-	for (int y = 0; y < _height_map.size_y; y++) {
+	ForEachHeightMapRow(0, _height_map.size_y - 1, 1, [max_height](uint32_t, int y) {
 		for (int x = 0; x < _height_map.size_x; x++) {
 			TgenSetTileHeight(TileXY(x, y), Clamp(H2I(_height_map.height(x, y)), 0, max_height));
 		}
-	}
+	});
 
 	FreeHeightMap();
 	GenerateWorldSetAbortCallback(nullptr);
@@ -0,0 +1,127 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/** @file thread.cpp Worker threads for spreading work with ParallelFor. */
+
+#include "stdafx.h"
+#include "thread.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+
+#include "safeguards.h"
+
+/** A set of chunks of work of one RunParallelChunks call. */
+struct ParallelBatch {
+	const std::function<void(size_t)> &func; ///< Function to call for each chunk.
+	const size_t chunks; ///< Number of chunks.
+	std::atomic<size_t> next_chunk = 0; ///< The next chunk that nobody is working on yet.
+	std::atomic<size_t> finished_chunks = 0; ///< Number of chunks that are done.
+
+	std::mutex lock; ///< Lock for waiting on #finished.
+	std::condition_variable finished; ///< Signalled when all chunks are done.
+
+	ParallelBatch(const std::function<void(size_t)> &func, size_t chunks) : func(func), chunks(chunks) {}
+
+	/**
+	 * Work on chunks of this batch until there are no more chunks to start.
+	 */
+	void Work()
+	{
+		for (size_t chunk = this->next_chunk++; chunk < this->chunks; chunk = this->next_chunk++) {
+			this->func(chunk);
+			if (++this->finished_chunks == this->chunks) {
+				std::lock_guard<std::mutex> guard(this->lock);
+				this->finished.notify_all();
+			}
+		}
+	}
+};
+
+/** The threads that work on the batches of RunParallelChunks. */
+class WorkerPool {
+	std::mutex lock; ///< Lock for #batches and #exit.
+	std::condition_variable work_available; ///< Signalled when a batch is added or the workers have to exit.
+	std::deque<std::shared_ptr<ParallelBatch>> batches; ///< Batches that may still have chunks nobody works on yet.
+	std::vector<std::thread> workers; ///< The worker threads.
+	bool exit = false; ///< Whether the workers have to exit.
+
+	/** Main loop of a worker thread. */
+	void WorkerMain()
+	{
+		std::unique_lock<std::mutex> guard(this->lock);
+		for (;;) {
+			this->work_available.wait(guard, [this]() { return this->exit || !this->batches.empty(); });
+			if (this->exit) return;
+
+			std::shared_ptr<ParallelBatch> batch = this->batches.front();
+			guard.unlock();
+			batch->Work();
+			guard.lock();
+
+			/* Every chunk has been started, so nobody has to pick up this batch anymore. */
+			if (!this->batches.empty() && this->batches.front() == batch) this->batches.pop_front();
+		}
+	}
+
+public:
+	/** Start a worker for each processor besides the one of the calling thread. */
+	WorkerPool()
+	{
+		uint count = std::max(1U, std::thread::hardware_concurrency()) - 1;
+		for (uint i = 0; i < count; i++) {
+			std::thread &worker = this->workers.emplace_back();
+			if (!StartNewThread(&worker, "ottd:worker", [this]() { this->WorkerMain(); })) {
+				this->workers.pop_back();
+				break;
+			}
+		}
+	}
+
+	~WorkerPool()
+	{
+		{
+			std::lock_guard<std::mutex> guard(this->lock);
+			this->exit = true;
+		}
+		this->work_available.notify_all();
+		for (std::thread &worker : this->workers) worker.join();
+	}
+
+	/**
+	 * Work on all chunks of a batch, together with the workers.
+	 * @param batch The batch.
+	 */
+	void Run(const std::shared_ptr<ParallelBatch> &batch)
+	{
+		if (!this->workers.empty()) {
+			{
+				std::lock_guard<std::mutex> guard(this->lock);
+				this->batches.push_back(batch);
+			}
+			this->work_available.notify_all();
+		}
+
+		batch->Work();
+
+		std::unique_lock<std::mutex> guard(batch->lock);
+		batch->finished.wait(guard, [&batch]() { return batch->finished_chunks == batch->chunks; });
+	}
+};
+
+/**
+ * Call a function for a number of chunks of work, spread over the worker threads and the calling thread.
+ * The worker threads are started the first time this is called.
+ * @param chunks The number of chunks.
+ * @param func The function to call with the number of each chunk.
+ */
+void RunParallelChunks(size_t chunks, const std::function<void(size_t)> &func)
+{
+	static WorkerPool pool;
+	pool.Run(std::make_shared<ParallelBatch>(func, chunks));
+}
@@ -16,6 +16,7 @@
 #include <system_error>
 #include <thread>
 #include <mutex>
+#include <functional>
 
 /**
  * Sleep on the current thread for a defined time.
@@ -85,4 +86,31 @@ inline bool StartNewThread(std::thread *thr, std::string_view name, TFn&& _Fx, T
 	return false;
 }
 
+void RunParallelChunks(size_t chunks, const std::function<void(size_t)> &func);
+
+/**
+ * Call a function on contiguous chunks of a range of indices, spreading the chunks over the worker threads.
+ * The calling thread works on chunks as well and returns once all chunks are done. When no worker
+ * thread could be started, all chunks are handled by the calling thread.
+ * @tparam TFn Type of the function to call.
+ * @param count Number of indices in the range.
+ * @param min_chunk Minimum number of indices per chunk, so small ranges do not pay for handing out work.
+ * @param func Function to call with the first and one-past-last index of each chunk.
+ */
+template <class TFn>
+inline void ParallelFor(size_t count, size_t min_chunk, TFn &&func)
+{
+	size_t chunks = std::min<size_t>(std::max(1U, std::thread::hardware_concurrency()), count / std::max<size_t>(1, min_chunk));
+	if (chunks <= 1) {
+		func(size_t{0}, count);
+		return;
+	}
+
+	size_t chunk_size = (count + chunks - 1) / chunks;
+	RunParallelChunks((count + chunk_size - 1) / chunk_size, [count, chunk_size, &func](size_t chunk) {
+		size_t begin = chunk * chunk_size;
+		func(begin, std::min(begin + chunk_size, count));
+	});
+}
+
 #endif /* THREAD_H */
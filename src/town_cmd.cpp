@@ -2549,9 +2549,10 @@ static void MakeTownHouse(TileIndex tile, Town *t, uint8_t counter, uint8_t stag
 	if (size.Any(BUILDING_2_TILES_X))   ClearMakeHouseTile(tile + TileDiffXY(1, 0), t, counter, stage, ++type, random_bits, is_protected);
 	if (size.Any(BUILDING_HAS_4_TILES)) ClearMakeHouseTile(tile + TileDiffXY(1, 1), t, counter, stage, ++type, random_bits, is_protected);
 
-	ForAllStationsAroundTiles(TileArea(tile, size.Any(BUILDING_2_TILES_X) ? 2 : 1, size.Any(BUILDING_2_TILES_Y) ? 2 : 1), [t](Station *st, TileIndex) {
+	ForAllStationsAroundTiles(TileArea(tile, size.Any(BUILDING_2_TILES_X) ? 2 : 1, size.Any(BUILDING_2_TILES_Y) ? 2 : 1), [t](Station *st, TileIndex house_tile) {
 		t->stations_near.insert(st);
-		return true;
+		st->AddAcceptanceOfTile(house_tile);
+		return false;
 	});
 }
 
@@ -3110,6 +3111,11 @@ void ClearTownHouse(Town *t, TileIndex tile)
 		t->flags.Reset(TownFlag::HasStadium);
 	}
 
+	ForAllStationsAroundTiles(TileArea(tile, hs->building_flags.Any(BUILDING_2_TILES_X) ? 2 : 1, hs->building_flags.Any(BUILDING_2_TILES_Y) ? 2 : 1), [](Station *st, TileIndex house_tile) {
+		st->RemoveAcceptanceOfTile(house_tile);
+		return false;
+	});
+
 	/* Do the actual clearing of tiles */
 	DoClearTownHouseHelper(tile, t, house);
 	if (hs->building_flags.Any(BUILDING_2_TILES_Y))   DoClearTownHouseHelper(tile + TileDiffXY(0, 1), t, ++house);
@@ -60,6 +60,7 @@
 #include "timer/timer_game_calendar.h"
 #include "timer/timer_game_economy.h"
 #include "timer/timer_game_tick.h"
+#include "thread.h"
 
 #include "table/strings.h"
 
@@ -115,6 +116,9 @@ static const uint GEN_HASHY_MASK = ((1 << GEN_HASHY_BITS) - 1) << GEN_HASHX_BITS
 VehiclePool _vehicle_pool("Vehicle");
 INSTANTIATE_POOL_METHODS(Vehicle)
 
+/** NOSAVE: Indices of the vehicles of each type, in pool order, for iterating the vehicles of one type. */
+std::array<std::vector<VehicleID>, VEH_END> _vehicles_of_type;
+
 
 /**
  * Determine shared bounds of all sprites.
@@ -379,6 +383,10 @@ void VehicleLengthChanged(const Vehicle *u)
 Vehicle::Vehicle(VehicleID index, VehicleType type) : VehiclePool::PoolItem<&_vehicle_pool>(index)
 {
 	this->type               = type;
+	if (type < VEH_END) {
+		std::vector<VehicleID> &ids = _vehicles_of_type[type];
+		ids.insert(std::ranges::upper_bound(ids, index), index);
+	}
 	this->coord.left         = INVALID_COORD;
 	this->sprite_cache.old_coord.left = INVALID_COORD;
 	this->group_id           = DEFAULT_GROUP;
@@ -695,6 +703,9 @@ void ResetVehicleColourMap()
 using AutoreplaceMap = std::map<VehicleID, bool>;
 static AutoreplaceMap _vehicles_to_autoreplace;
 
+/** Vehicles whose cargo has to be aged at the end of this tick, in pool order. */
+static std::vector<VehicleID> _vehicles_to_age_cargo;
+
 void InitializeVehicles()
 {
 	_vehicles_to_autoreplace.clear();
@@ -892,6 +903,24 @@ void Vehicle::PreDestructor()
 
 Vehicle::~Vehicle()
 {
+	if (this->type < VEH_END) {
+		std::vector<VehicleID> &ids = _vehicles_of_type[this->type];
+		if (CleaningPool()) {
+			/* All vehicles are going, so do not bother removing them one by one. */
+			ids.clear();
+		} else {
+			auto it = std::ranges::lower_bound(ids, this->index);
+			assert(it != ids.end() && *it == this->index);
+			ids.erase(it);
+		}
+	}
+
+	/* The vehicle may be removed during the vehicle ticks by another vehicle, after its cargo aging period ended. */
+	if (!_vehicles_to_age_cargo.empty()) {
+		auto it = std::ranges::lower_bound(_vehicles_to_age_cargo, this->index);
+		if (it != _vehicles_to_age_cargo.end() && *it == this->index) _vehicles_to_age_cargo.erase(it);
+	}
+
 	if (CleaningPool()) {
 		this->cargo.OnCleanPool();
 		return;
@@ -981,6 +1010,20 @@ static void RunEconomyVehicleDayProc()
 	}
 }
 
+/**
+ * Age the cargo of the vehicles whose cargo aging period ended during this tick.
+ * Aging only touches the cargo packets and counters of the vehicle itself, and nothing
+ * during the vehicle ticks depends on the age of the cargo, so this is done for all
+ * vehicles at once, on multiple threads, after the vehicles moved.
+ */
+static void AgeVehicleCargo()
+{
+	ParallelFor(_vehicles_to_age_cargo.size(), 128, [](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) Vehicle::Get(_vehicles_to_age_cargo[i])->cargo.AgeCargo();
+	});
+	_vehicles_to_age_cargo.clear();
+}
+
 void CallVehicleTicks()
 {
 	_vehicles_to_autoreplace.clear();
@@ -1019,7 +1062,7 @@ void CallVehicleTicks()
 				if (v->vcache.cached_cargo_age_period != 0) {
 					v->cargo_age_counter = std::min(v->cargo_age_counter, v->vcache.cached_cargo_age_period);
 					if (--v->cargo_age_counter == 0) {
-						v->cargo.AgeCargo();
+						_vehicles_to_age_cargo.push_back(v->index);
 						v->cargo_age_counter = v->vcache.cached_cargo_age_period;
 					}
 				}
@@ -1069,6 +1112,8 @@ void CallVehicleTicks()
 		}
 	}
 
+	AgeVehicleCargo();
+
 	Backup<CompanyID> cur_company(_current_company);
 	for (auto &it : _vehicles_to_autoreplace) {
 		Vehicle *v = Vehicle::Get(it.first);
@@ -1050,6 +1050,74 @@ public:
 	uint32_t GetDisplayMinPowerToWeight() const;
 };
 
+extern std::array<std::vector<VehicleID>, VEH_END> _vehicles_of_type;
+
+/**
+ * Iterator over all vehicles of one type, in pool order.
+ * Like the pool's own iterator it continues at the first vehicle after the current one,
+ * so vehicles may be added and removed while iterating.
+ * @tparam T Type of the vehicles.
+ */
+template <class T>
+struct VehicleOfTypeIterator {
+	typedef T value_type;
+	typedef T *pointer;
+	typedef T &reference;
+	typedef size_t difference_type;
+	typedef std::forward_iterator_tag iterator_category;
+
+	explicit VehicleOfTypeIterator(size_t from)
+	{
+		const std::vector<VehicleID> &ids = _vehicles_of_type[T::EXPECTED_TYPE];
+		this->pos = std::ranges::lower_bound(ids, from, std::less{}, &VehicleID::base) - ids.begin();
+		this->ValidatePosition();
+	}
+
+	bool operator==(const VehicleOfTypeIterator &other) const { return this->index == other.index; }
+	T * operator*() const { return T::Get(this->index); }
+
+	VehicleOfTypeIterator & operator++()
+	{
+		const std::vector<VehicleID> &ids = _vehicles_of_type[T::EXPECTED_TYPE];
+		if (this->pos < ids.size() && ids[this->pos] == this->index) {
+			this->pos++;
+		} else {
+			/* Vehicles were added or removed, so find our place again. */
+			this->pos = std::ranges::upper_bound(ids, this->index, std::less{}, &VehicleID::base) - ids.begin();
+		}
+		this->ValidatePosition();
+		return *this;
+	}
+
+	/** End of the iteration. */
+	static VehicleOfTypeIterator End() { return VehicleOfTypeIterator(); }
+
+private:
+	size_t pos = 0; ///< Position of the current vehicle in #_vehicles_of_type.
+	size_t index = Vehicle::Pool::MAX_SIZE; ///< Pool index of the current vehicle.
+
+	VehicleOfTypeIterator() = default;
+
+	void ValidatePosition()
+	{
+		const std::vector<VehicleID> &ids = _vehicles_of_type[T::EXPECTED_TYPE];
+		this->index = this->pos < ids.size() ? ids[this->pos].base() : Vehicle::Pool::MAX_SIZE;
+	}
+};
+
+/**
+ * Iterable ensemble of all vehicles of one type.
+ * @tparam T Type of the vehicles.
+ */
+template <class T>
+struct VehicleOfTypeIterateWrapper {
+	size_t from;
+	VehicleOfTypeIterateWrapper(size_t from = 0) : from(from) {}
+	VehicleOfTypeIterator<T> begin() { return VehicleOfTypeIterator<T>(this->from); }
+	VehicleOfTypeIterator<T> end() { return VehicleOfTypeIterator<T>::End(); }
+	bool empty() { return this->begin() == this->end(); }
+};
+
 /**
  * Class defining several overloaded accessors so we don't
  * have to cast vehicle types that often
@@ -1279,7 +1347,13 @@ struct SpecializedVehicle : public Vehicle {
 	 * @param from index of the first vehicle to consider
 	 * @return an iterable ensemble of all valid vehicles of type T
 	 */
-	static Pool::IterateWrapper<T> Iterate(size_t from = 0) { return Pool::IterateWrapper<T>(from); }
+	static VehicleOfTypeIterateWrapper<T> Iterate(size_t from = 0) { return VehicleOfTypeIterateWrapper<T>(from); }
+
+	/**
+	 * Get the number of vehicles of type T.
+	 * @return The number of vehicles.
+	 */
+	static size_t GetNumItems() { return _vehicles_of_type[Type].size(); }
 };
 
 /** Sentinel for an invalid coordinate. */
@@ -1586,7 +1586,7 @@ static inline void ChangeVehicleWindow(WindowClass window_class, VehicleID from_
 	Window *w = FindWindowById(window_class, from_index);
 	if (w != nullptr) {
 		/* Update window_number */
-		w->window_number = to_index;
+		w->ChangeWindowNumber(to_index);
 		if (w->viewport != nullptr) w->viewport->follow_vehicle = to_index;
 
 		/* Update vehicle drag data */
@@ -2265,7 +2265,7 @@ public:
 		if (!gui_scope && HasBit(data, 31) && this->vli.type == VL_SHARED_ORDERS) {
 			/* Needs to be done in command-scope, so everything stays valid */
 			this->vli.SetIndex(GB(data, 0, 20));
-			this->window_number = this->vli.ToWindowNumber();
+			this->ChangeWindowNumber(this->vli.ToWindowNumber());
 			this->vehgroups.ForceRebuild();
 			return;
 		}
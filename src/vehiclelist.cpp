@@ -13,6 +13,7 @@
 #include "vehiclelist.h"
 #include "vehiclelist_func.h"
 #include "group.h"
+#include "company_base.h"
 
 #include "safeguards.h"
 
@@ -73,7 +74,7 @@ bool GenerateVehicleSortList(VehicleList *list, const VehicleListIdentifier &vli
 
 	switch (vli.type) {
 		case VL_STATION_LIST:
-			FindVehiclesWithOrder(
+			FindVehiclesWithOrder(vli.ToStationID(),
 				[&vli](const Vehicle *v) { return v->type == vli.vtype; },
 				[&vli](const Order *order) { return (order->IsType(OT_GOTO_STATION) || order->IsType(OT_GOTO_WAYPOINT) || order->IsType(OT_IMPLICIT)) && order->GetDestination() == vli.ToStationID(); },
 				[&list](const Vehicle *v) { list->push_back(v); }
@@ -92,27 +93,22 @@ bool GenerateVehicleSortList(VehicleList *list, const VehicleListIdentifier &vli
 		}
 
 		case VL_GROUP_LIST:
-			if (vli.ToGroupID() != ALL_GROUP) {
-				for (const Vehicle *v : Vehicle::Iterate()) {
-					if (v->type == vli.vtype && v->IsPrimaryVehicle() &&
-							v->owner == vli.company && GroupIsInGroup(v->group_id, vli.ToGroupID())) {
-						list->push_back(v);
-					}
-				}
-				break;
-			}
-			[[fallthrough]];
+		case VL_STANDARD: {
+			if (!Company::IsValidID(vli.company) || !IsCompanyBuildableVehicleType(vli.vtype)) break;
+
+			GroupID group = vli.type == VL_GROUP_LIST ? vli.ToGroupID() : ALL_GROUP;
+			const Group *g = Group::GetIfValid(group);
+			if (g != nullptr && (g->owner != vli.company || g->vehicle_type != vli.vtype)) break;
+			if (g == nullptr && !IsDefaultGroupID(group) && !IsAllGroupID(group)) break;
 
-		case VL_STANDARD:
-			for (const Vehicle *v : Vehicle::Iterate()) {
-				if (v->type == vli.vtype && v->owner == vli.company && v->IsPrimaryVehicle()) {
-					list->push_back(v);
-				}
+			for (VehicleID vehicle : GetGroupVehicles(vli.company, group, vli.vtype)) {
+				list->push_back(Vehicle::Get(vehicle));
 			}
 			break;
+		}
 
 		case VL_DEPOT_LIST:
-			FindVehiclesWithOrder(
+			FindVehiclesWithOrder(vli.ToDestinationID(),
 				[&vli](const Vehicle *v) { return v->type == vli.vtype; },
 				[&vli](const Order *order) { return order->IsType(OT_GOTO_DEPOT) && !order->GetDepotActionType().Test(OrderDepotActionFlag::NearestDepot) && order->GetDestination() == vli.ToDestinationID(); },
 				[&list](const Vehicle *v) { list->push_back(v); }
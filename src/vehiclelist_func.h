@@ -14,16 +14,18 @@
 #include "vehicle_base.h"
 
 /**
- * Find vehicles matching an order.
+ * Find vehicles matching an order to a destination.
  * This can be used, e.g. to find all vehicles that stop at a particular station.
+ * Only the order lists with an order to the destination are visited.
+ * @param destination The destination of the orders to look for.
  * @param veh_pred Vehicle selection predicate. This is called only for the first vehicle using the order list.
  * @param ord_pred Order selection predicate.
  * @param veh_func Called for each vehicle that matches both vehicle and order predicates.
  **/
 template <class VehiclePredicate, class OrderPredicate, class VehicleFunc>
-void FindVehiclesWithOrder(VehiclePredicate veh_pred, OrderPredicate ord_pred, VehicleFunc veh_func)
+void FindVehiclesWithOrder(DestinationID destination, VehiclePredicate veh_pred, OrderPredicate ord_pred, VehicleFunc veh_func)
 {
-	for (const OrderList *orderlist : OrderList::Iterate()) {
+	for (const OrderList *orderlist : OrderList::IterateWithDestination(destination)) {
 
 		/* We assume all vehicles sharing an order list match the condition. */
 		Vehicle *v = orderlist->GetFirstSharedVehicle();
@@ -12,6 +12,10 @@
 #include "../blitter/factory.hpp"
 #include "../saveload/saveload.h"
 #include "../window_func.h"
+#include "../framerate_type.h"
+#include "../fileio_func.h"
+#include "../error_func.h"
+#include "../core/random_func.hpp"
 #include "null_v.h"
 
 #include "../safeguards.h"
@@ -31,6 +35,13 @@ std::optional<std::string_view> VideoDriver_Null::Start(const StringList &parm)
 	this->UpdateAutoResolution();
 
 	this->ticks = GetDriverParamInt(parm, "ticks", 1000);
+	this->warmup_ticks = GetDriverParamInt(parm, "warmup", 0);
+	if (GetDriverParam(parm, "seed").has_value()) this->seed = GetDriverParamInt(parm, "seed", 0);
+	this->benchmark_file = GetDriverParam(parm, "benchmark").value_or("");
+	this->expected_state_hash = GetDriverParam(parm, "statehash").value_or("");
+	/* A game given on the command line is only loaded during the first tick. Loading it must
+	 * neither be measured nor overwrite the seed, so a benchmark always warms up for a tick. */
+	if (!this->benchmark_file.empty()) this->warmup_ticks = std::max(this->warmup_ticks, 1U);
 	_screen.width  = _screen.pitch = _cur_resolution.width;
 	_screen.height = _cur_resolution.height;
 	_screen.dst_ptr = nullptr;
@@ -46,15 +57,73 @@ void VideoDriver_Null::Stop() { }
 
 void VideoDriver_Null::MakeDirty(int, int, int, int) {}
 
-void VideoDriver_Null::MainLoop()
+/**
+ * Run a number of ticks without waiting in between.
+ * @param ticks The number of ticks to run.
+ */
+static void RunTicks(uint ticks)
 {
-	uint i;
-
-	for (i = 0; i < this->ticks; i++) {
+	for (uint i = 0; i < ticks; i++) {
 		::GameLoop();
 		::InputLoop();
 		::UpdateWindows();
 	}
+}
+
+/**
+ * Write the performance statistics of the measured ticks and the final game state hash as JSON.
+ * When an expected game state hash was given and it does not match, this is a fatal error.
+ */
+void VideoDriver_Null::WriteBenchmarkResults()
+{
+	std::array<PerformanceStatistics, PFE_MAX> stats = StopPerformanceRecording();
+	std::optional<uint64_t> hash = CalculateGameStateHash();
+	std::string state_hash = hash.has_value() ? fmt::format("{:016x}", *hash) : "";
+
+	auto f = FioFOpenFile(this->benchmark_file, "wt", Subdirectory::None);
+	if (!f.has_value()) UserError("Failed to open '{}' for writing the benchmark results.", this->benchmark_file);
+
+	fmt::print(*f, "{{\n");
+	fmt::print(*f, "\t\"warmup_ticks\": {},\n", this->warmup_ticks);
+	fmt::print(*f, "\t\"ticks\": {},\n", this->ticks);
+	if (this->seed.has_value()) fmt::print(*f, "\t\"seed\": {},\n", *this->seed);
+	fmt::print(*f, "\t\"elements\": {{");
+	std::string_view separator = "\n";
+	for (PerformanceElement e = PFE_FIRST; e < PFE_MAX; e++) {
+		const PerformanceStatistics &s = stats[e];
+		if (s.count == 0) continue;
+		fmt::print(*f, "{}\t\t\"{}\": {{ \"count\": {}, \"mean_ms\": {:.4f}, \"p50_ms\": {:.4f}, \"p99_ms\": {:.4f}, \"max_ms\": {:.4f} }}",
+			separator, GetPerformanceElementKey(e), s.count, s.mean, s.p50, s.p99, s.max);
+		separator = ",\n";
+	}
+	fmt::print(*f, "\n\t}},\n");
+	fmt::print(*f, "\t\"state_hash\": \"{}\"", state_hash);
+	if (!this->expected_state_hash.empty()) {
+		fmt::print(*f, ",\n\t\"state_hash_matches\": {}", state_hash == this->expected_state_hash);
+	}
+	fmt::print(*f, "\n}}\n");
+	f.reset();
+
+	if (!this->expected_state_hash.empty() && state_hash != this->expected_state_hash) {
+		UserError("Benchmark ended with game state hash '{}', but '{}' was expected.", state_hash, this->expected_state_hash);
+	}
+}
+
+void VideoDriver_Null::MainLoop()
+{
+	RunTicks(this->warmup_ticks);
+
+	if (!this->benchmark_file.empty()) {
+		if (this->seed.has_value()) {
+			_random.SetSeed(*this->seed);
+			_interactive_random.SetSeed(*this->seed);
+		}
+		StartPerformanceRecording();
+	}
+
+	RunTicks(this->ticks);
+
+	if (!this->benchmark_file.empty()) this->WriteBenchmarkResults();
 
 	/* If requested, make a save just before exit. The normal exit-flow is
 	 * not triggered from this driver, so we have to do this manually. */
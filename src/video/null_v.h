@@ -16,6 +16,12 @@
 class VideoDriver_Null : public VideoDriver {
 private:
 	uint ticks = 0; ///< Amount of ticks to run.
+	uint warmup_ticks = 0; ///< Amount of ticks to run before the measured ticks.
+	std::optional<uint32_t> seed; ///< Seed for the random number generators at the start of the measured ticks.
+	std::string benchmark_file; ///< File to write the benchmark results to, or empty when not benchmarking.
+	std::string expected_state_hash; ///< Game state hash the benchmark must end with, or empty when not checked.
+
+	void WriteBenchmarkResults();
 
 public:
 	std::optional<std::string_view> Start(const StringList &param) override;
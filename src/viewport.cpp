@@ -90,6 +90,8 @@
 #include "network/network_func.h"
 #include "framerate_type.h"
 #include "viewport_cmd.h"
+#include "smallmap_gui.h"
+#include "spritecache.h"
 
 #include <forward_list>
 #include <stack>
@@ -184,6 +186,8 @@ struct ViewportDrawer {
 	FoundationPart foundation_part;                  ///< Currently active foundation for ground sprite drawing.
 	int last_foundation_child[FOUNDATION_PART_END];  ///< Tail of ChildSprite list of the foundations. (index into child_screen_sprites_to_draw)
 	Point foundation_offset[FOUNDATION_PART_END];    ///< Pixel offset for ground sprites on the foundations.
+
+	std::vector<SpriteID> *prefetch_sprites = nullptr; ///< When not \c nullptr, only collect the sprites that would be drawn into this.
 };
 
 static bool MarkViewportDirty(const Viewport &vp, int left, int top, int right, int bottom);
@@ -622,6 +626,11 @@ void OffsetGroundSprite(int x, int y)
  */
 static void AddCombinedSprite(SpriteID image, PaletteID pal, int x, int y, int z, const SubSprite *sub)
 {
+	if (_vd.prefetch_sprites != nullptr) {
+		_vd.prefetch_sprites->push_back(image & SPRITE_MASK);
+		return;
+	}
+
 	Point pt = RemapCoords(x, y, z);
 	const Sprite *spr = GetSprite(image & SPRITE_MASK, SpriteType::Normal);
 
@@ -682,8 +691,8 @@ void AddSortableSpriteToDraw(SpriteID image, PaletteID pal, int x, int y, int z,
 	Point pt = RemapCoords(x + bounds.offset.x, y + bounds.offset.y, z + bounds.offset.z);
 	int tmp_left, tmp_top, tmp_x = pt.x, tmp_y = pt.y;
 
-	/* Compute screen extents of sprite */
-	if (image == SPR_EMPTY_BOUNDING_BOX) {
+	/* Compute screen extents of sprite; when collecting sprites to prefetch the sprite itself is not loaded yet. */
+	if (image == SPR_EMPTY_BOUNDING_BOX || _vd.prefetch_sprites != nullptr) {
 		left = tmp_left = RemapCoords(x + bounds.extent.x, y, z).x;
 		right           = RemapCoords(x, y + bounds.extent.y, z).x + 1;
 		top  = tmp_top  = RemapCoords(x, y, z + bounds.extent.z).y;
@@ -1592,7 +1601,7 @@ static void ViewportDrawTileSprites(const TileSpriteToDrawVector *tstdv)
  * Sort parent sprites pointer array replicating the way original sorter did it.
  * @param psdv The sprites to sort.
  */
-static void ViewportSortParentSprites(ParentSpriteToSortVector *psdv)
+void ViewportSortParentSprites(ParentSpriteToSortVector *psdv)
 {
 	if (psdv->size() < 2) return;
 
@@ -1874,6 +1883,51 @@ void ViewportDoDraw(const Viewport &vp, int left, int top, int right, int bottom
 	_vd.child_screen_sprites_to_draw.clear();
 }
 
+/**
+ * Collect the sprites of the landscape that would be drawn in an area of a viewport.
+ * Vehicles, signs and text effects are not collected; they move anyway.
+ * @param zoom The zoom level to collect the sprites for.
+ * @param left Left edge of the area, in virtual coordinates.
+ * @param top Top edge of the area, in virtual coordinates.
+ * @param right Right edge of the area, in virtual coordinates.
+ * @param bottom Bottom edge of the area, in virtual coordinates.
+ * @param[out] sprites The collected sprites, which may contain duplicates.
+ */
+static void ViewportCollectSprites(ZoomLevel zoom, int left, int top, int right, int bottom, std::vector<SpriteID> &sprites)
+{
+	/* Only collect when no viewport is being drawn. */
+	if (!_vd.tile_sprites_to_draw.empty() || !_vd.parent_sprites_to_draw.empty()) return;
+
+	_vd.dpi.zoom = zoom;
+	int mask = ScaleByZoom(-1, zoom);
+
+	_vd.combine_sprites = SPRITE_COMBINE_NONE;
+
+	_vd.dpi.width = (right - left) & mask;
+	_vd.dpi.height = (bottom - top) & mask;
+	_vd.dpi.left = left & mask;
+	_vd.dpi.top = top & mask;
+	_vd.dpi.pitch = 0;
+	_vd.dpi.dst_ptr = nullptr;
+	_vd.last_child = LAST_CHILD_NONE;
+
+	AutoRestoreBackup dpi_backup(_cur_dpi, &_vd.dpi);
+	AutoRestoreBackup prefetch_backup(_vd.prefetch_sprites, &sprites);
+
+	ViewportAddLandscape();
+
+	for (const TileSpriteToDraw &ts : _vd.tile_sprites_to_draw) sprites.push_back(ts.image & SPRITE_MASK);
+	for (const ParentSpriteToDraw &ps : _vd.parent_sprites_to_draw) {
+		if (ps.image != SPR_EMPTY_BOUNDING_BOX) sprites.push_back(ps.image & SPRITE_MASK);
+	}
+	for (const ChildScreenSpriteToDraw &cs : _vd.child_screen_sprites_to_draw) sprites.push_back(cs.image & SPRITE_MASK);
+
+	_vd.string_sprites_to_draw.clear();
+	_vd.tile_sprites_to_draw.clear();
+	_vd.parent_sprites_to_draw.clear();
+	_vd.child_screen_sprites_to_draw.clear();
+}
+
 static inline void ViewportDraw(const Viewport &vp, int left, int top, int right, int bottom)
 {
 	if (right <= vp.left || bottom <= vp.top) return;
@@ -1979,6 +2033,46 @@ static void ClampSmoothScroll(uint32_t delta_ms, int64_t delta_hi, int64_t delta
 	}
 }
 
+/**
+ * Prefetch the sprites a viewport is likely to show soon, judging by how it moves and zooms.
+ * @param vp The viewport.
+ */
+static void PrefetchViewportSprites(ViewportData &vp)
+{
+	if (!CanPrefetchSprites()) return;
+
+	std::vector<SpriteID> sprites;
+	if (vp.zoom != vp.prefetch_zoom) {
+		/* Zooming out shows the surroundings of the view; the sprites are the same for all zoom levels. */
+		if (vp.zoom < _settings_client.gui.zoom_max) {
+			ZoomLevel zoom = vp.zoom;
+			++zoom;
+			int half_width = vp.virtual_width / 2;
+			int half_height = vp.virtual_height / 2;
+			ViewportCollectSprites(zoom, vp.virtual_left - half_width, vp.virtual_top - half_height,
+					vp.virtual_left + vp.virtual_width + half_width, vp.virtual_top + vp.virtual_height + half_height, sprites);
+		}
+	} else {
+		int delta_x = vp.virtual_left - vp.prefetch_left;
+		int delta_y = vp.virtual_top - vp.prefetch_top;
+		bool moved_x = abs(delta_x) >= vp.virtual_width / 4;
+		bool moved_y = abs(delta_y) >= vp.virtual_height / 4;
+		if (!moved_x && !moved_y) return;
+
+		/* Look half a view ahead in the direction the view moves. */
+		int ahead_x = moved_x ? (delta_x > 0 ? vp.virtual_width : -vp.virtual_width) / 2 : 0;
+		int ahead_y = moved_y ? (delta_y > 0 ? vp.virtual_height : -vp.virtual_height) / 2 : 0;
+		ViewportCollectSprites(vp.zoom, vp.virtual_left + ahead_x, vp.virtual_top + ahead_y,
+				vp.virtual_left + vp.virtual_width + ahead_x, vp.virtual_top + vp.virtual_height + ahead_y, sprites);
+	}
+
+	vp.prefetch_left = vp.virtual_left;
+	vp.prefetch_top = vp.virtual_top;
+	vp.prefetch_zoom = vp.zoom;
+
+	PrefetchSprites(sprites);
+}
+
 /**
  * Update the viewport position being displayed.
  * @param w %Window owning the viewport.
@@ -2039,6 +2133,8 @@ void UpdateViewportPosition(Window *w, uint32_t delta_ms)
 		SetViewportPosition(w, vp.scrollpos_x, vp.scrollpos_y);
 		if (update_overlay) RebuildViewportOverlay(w);
 	}
+
+	PrefetchViewportSprites(vp);
 }
 
 /**
@@ -2126,6 +2222,8 @@ void ConstrainAllViewportsZoom()
  */
 void MarkTileDirtyByTile(TileIndex tile, int bridge_level_offset, int tile_height_override)
 {
+	InvalidateSmallMapTile(tile);
+
 	Point pt = RemapCoords(TileX(tile) * TILE_SIZE, TileY(tile) * TILE_SIZE, tile_height_override * TILE_HEIGHT);
 	MarkAllViewportsDirty(
 			pt.x - MAX_TILE_EXTENT_LEFT,
@@ -3610,6 +3708,7 @@ struct ViewportSSCSS {
 
 /** List of sorters ordered from best to worst. */
 static const ViewportSSCSS _vp_sprite_sorters[] = {
+	{ []() { return true; /* Always available */ }, &ViewportSortParentSpritesBatched },
 #ifdef WITH_SSE
 	{ &ViewportSortParentSpritesSSE41Checker, &ViewportSortParentSpritesSSE41 },
 #endif
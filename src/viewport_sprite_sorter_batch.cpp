@@ -0,0 +1,333 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/** @file viewport_sprite_sorter_batch.cpp Sprite sorter that buckets sprites spatially and compares bounding boxes in batches. */
+
+#include "stdafx.h"
+#include "viewport_sprite_sorter.h"
+#include <stack>
+
+#include "safeguards.h"
+
+/**
+ * Bounding boxes of the sprites that have not been sorted yet, bucketed by
+ * the minimal X and Y coordinates into a grid of cells.
+ *
+ * A sprite can only precede another sprite when its minimal X and Y
+ * coordinates are not beyond the maximal ones of the other sprite, so only
+ * the cells to the north of a sprite have to be searched. As sprites are
+ * mostly processed from back to front, most of those cells are empty by then.
+ *
+ * The boxes in a cell are stored as a structure of arrays, so the comparisons
+ * over a cell have no branches or pointer chasing and the compiler can
+ * vectorise them for the target platform.
+ */
+struct SpriteSortGrid {
+	int32_t x0; ///< Lowest minimal X coordinate of all sprites.
+	int32_t y0; ///< Lowest minimal Y coordinate of all sprites.
+	uint8_t shift; ///< Number of bits of the coordinates within a cell.
+	uint32_t columns; ///< Number of cells along the X axis.
+	uint32_t rows; ///< Number of cells along the Y axis.
+
+	std::vector<uint32_t> cell_start; ///< First slot of each cell.
+	std::vector<uint32_t> cell_count; ///< Number of sprites still in each cell.
+	std::vector<uint32_t> row_count; ///< Number of sprites still in each row of cells.
+	std::vector<uint32_t> row_first; ///< No sprites are left in the cells of a row before this column.
+	uint32_t first_row; ///< No sprites are left in the rows before this one.
+
+	/* Per slot data. */
+	std::vector<int32_t> xmin; ///< Minimal world X coordinate.
+	std::vector<int32_t> ymin; ///< Minimal world Y coordinate.
+	std::vector<int32_t> zmin; ///< Minimal world Z coordinate.
+	std::vector<int32_t> xmax; ///< Maximal world X coordinate.
+	std::vector<int32_t> ymax; ///< Maximal world Y coordinate.
+	std::vector<int32_t> zmax; ///< Maximal world Z coordinate.
+	std::vector<int32_t> sum; ///< Sum of all coordinates, i.e. twice the sum of the centre of mass.
+	std::vector<uint32_t> index; ///< Index of the sprite in the vector that is being sorted.
+	std::vector<uint8_t> precedes; ///< Scratch space for the comparison results of a cell.
+
+	/* Per sprite data. */
+	std::vector<uint32_t> slot; ///< For each sprite in the vector that is being sorted its slot.
+	std::vector<uint32_t> cell; ///< For each sprite in the vector that is being sorted its cell.
+
+	/**
+	 * Get the column of cells for a minimal X coordinate.
+	 * @param x The coordinate.
+	 * @return The column.
+	 */
+	inline uint32_t Column(int32_t x) const
+	{
+		return static_cast<uint32_t>((static_cast<int64_t>(x) - this->x0) >> this->shift);
+	}
+
+	/**
+	 * Get the row of cells for a minimal Y coordinate.
+	 * @param y The coordinate.
+	 * @return The row.
+	 */
+	inline uint32_t Row(int32_t y) const
+	{
+		return static_cast<uint32_t>((static_cast<int64_t>(y) - this->y0) >> this->shift);
+	}
+
+	/**
+	 * Fill the grid with the given sprites.
+	 * @param psdv The sprites to sort.
+	 */
+	void Fill(const ParentSpriteToSortVector &psdv)
+	{
+		uint32_t n = static_cast<uint32_t>(psdv.size());
+
+		this->x0 = INT32_MAX;
+		this->y0 = INT32_MAX;
+		int32_t x1 = INT32_MIN;
+		int32_t y1 = INT32_MIN;
+		for (const ParentSpriteToDraw *p : psdv) {
+			this->x0 = std::min(this->x0, p->xmin);
+			this->y0 = std::min(this->y0, p->ymin);
+			x1 = std::max(x1, p->xmin);
+			y1 = std::max(y1, p->ymin);
+		}
+
+		/* Aim for about one sprite per cell. */
+		this->shift = 0;
+		auto cells = [&]() {
+			return ((static_cast<uint64_t>(static_cast<int64_t>(x1) - this->x0) >> this->shift) + 1) *
+					((static_cast<uint64_t>(static_cast<int64_t>(y1) - this->y0) >> this->shift) + 1);
+		};
+		while (cells() > n) this->shift++;
+		this->columns = this->Column(x1) + 1;
+		this->rows = this->Row(y1) + 1;
+
+		/* Counting sort of the sprites into their cells. */
+		this->cell_start.assign(this->columns * this->rows + 1, 0);
+		this->cell.resize(n);
+		for (uint32_t i = 0; i < n; i++) {
+			this->cell[i] = this->Row(psdv[i]->ymin) * this->columns + this->Column(psdv[i]->xmin);
+			this->cell_start[this->cell[i] + 1]++;
+		}
+		for (size_t c = 1; c < this->cell_start.size(); c++) this->cell_start[c] += this->cell_start[c - 1];
+
+		this->cell_count.assign(this->columns * this->rows, 0);
+		this->row_count.assign(this->rows, 0);
+		this->row_first.assign(this->rows, 0);
+		this->first_row = 0;
+
+		for (auto *v : {&this->xmin, &this->ymin, &this->zmin, &this->xmax, &this->ymax, &this->zmax, &this->sum}) v->resize(n);
+		this->index.resize(n);
+		this->precedes.resize(n);
+		this->slot.resize(n);
+
+		for (uint32_t i = 0; i < n; i++) {
+			const ParentSpriteToDraw *p = psdv[i];
+			uint32_t c = this->cell[i];
+			uint32_t s = this->cell_start[c] + this->cell_count[c]++;
+			this->row_count[c / this->columns]++;
+
+			this->xmin[s] = p->xmin;
+			this->ymin[s] = p->ymin;
+			this->zmin[s] = p->zmin;
+			this->xmax[s] = p->xmax;
+			this->ymax[s] = p->ymax;
+			this->zmax[s] = p->zmax;
+			this->sum[s] = p->xmin + p->xmax + p->ymin + p->ymax + p->zmin + p->zmax;
+			this->index[s] = i;
+			this->slot[i] = s;
+		}
+	}
+
+	/**
+	 * Remove a sprite from the grid.
+	 * @param i The index of the sprite in the vector that is being sorted.
+	 */
+	void Remove(uint32_t i)
+	{
+		uint32_t c = this->cell[i];
+		uint32_t s = this->slot[i];
+		uint32_t last = this->cell_start[c] + --this->cell_count[c];
+		this->row_count[c / this->columns]--;
+
+		/* Move the last sprite of the cell into the freed slot. */
+		if (s != last) {
+			this->xmin[s] = this->xmin[last];
+			this->ymin[s] = this->ymin[last];
+			this->zmin[s] = this->zmin[last];
+			this->xmax[s] = this->xmax[last];
+			this->ymax[s] = this->ymax[last];
+			this->zmax[s] = this->zmax[last];
+			this->sum[s] = this->sum[last];
+			this->index[s] = this->index[last];
+			this->slot[this->index[s]] = s;
+		}
+	}
+
+	/**
+	 * Determine for the sprites in a cell whether they have to be drawn before a sprite.
+	 * The result is stored in #precedes.
+	 * @param s The sprite to compare with.
+	 * @param first The first slot of the cell.
+	 * @param last One past the last used slot of the cell.
+	 */
+	void ComparePreceding(const ParentSpriteToDraw *s, uint32_t first, uint32_t last)
+	{
+		const int32_t s_xmin = s->xmin, s_ymin = s->ymin, s_zmin = s->zmin;
+		const int32_t s_xmax = s->xmax, s_ymax = s->ymax, s_zmax = s->zmax;
+		const int32_t s_sum = s->xmin + s->xmax + s->ymin + s->ymax + s->zmin + s->zmax;
+
+		const int32_t *p_xmin = this->xmin.data(), *p_ymin = this->ymin.data(), *p_zmin = this->zmin.data();
+		const int32_t *p_xmax = this->xmax.data(), *p_ymax = this->ymax.data(), *p_zmax = this->zmax.data();
+		const int32_t *p_sum = this->sum.data();
+		uint8_t *out = this->precedes.data();
+
+		for (uint32_t i = first; i < last; i++) {
+			/* Candidates have p->xmin <= s->xmax && p->ymin <= s->ymax && p->zmin <= s->zmax. */
+			uint8_t candidate = (p_xmin[i] <= s_xmax) & (p_ymin[i] <= s_ymax) & (p_zmin[i] <= s_zmax);
+			/* When the sprites overlap, use X+Y+Z of the centre of mass as the sorting order. */
+			uint8_t overlap = (s_xmin <= p_xmax[i]) & (s_ymin <= p_ymax[i]) & (s_zmin <= p_zmax[i]);
+			out[i] = candidate & ((overlap ^ 1) | (s_sum > p_sum[i]));
+		}
+	}
+
+	/**
+	 * Find all sprites left in the grid that have to be drawn before a sprite.
+	 * @param s The sprite to compare with.
+	 * @param[out] preceding The indices of the preceding sprites.
+	 */
+	void FindPreceding(const ParentSpriteToDraw *s, std::vector<uint32_t> &preceding)
+	{
+		if (s->xmax < this->x0 || s->ymax < this->y0) return;
+
+		uint32_t last_row = std::min(this->Row(s->ymax), this->rows - 1);
+		uint32_t last_column = std::min(this->Column(s->xmax), this->columns - 1);
+
+		while (this->first_row < this->rows && this->row_count[this->first_row] == 0) this->first_row++;
+
+		for (uint32_t row = this->first_row; row <= last_row; row++) {
+			if (this->row_count[row] == 0) continue;
+
+			uint32_t base = row * this->columns;
+			uint32_t &column = this->row_first[row];
+			while (this->cell_count[base + column] == 0) column++;
+
+			for (uint32_t c = base + column; c <= base + last_column; c++) {
+				if (this->cell_count[c] == 0) continue;
+
+				uint32_t first = this->cell_start[c];
+				uint32_t last = first + this->cell_count[c];
+				this->ComparePreceding(s, first, last);
+				for (uint32_t i = first; i < last; i++) {
+					if (this->precedes[i] != 0) preceding.push_back(this->index[i]);
+				}
+			}
+		}
+	}
+};
+
+/** State of the batched sprite sorter; kept between sorts so its allocations can be reused. */
+class BatchedSpriteSorter {
+	SpriteSortGrid grid; ///< The sprites that have not been sorted yet.
+	ParentSpriteToSortVector sprites; ///< The sprites in their original order.
+	std::vector<uint32_t> preceding; ///< Indices of the sprites that precede the current one.
+
+public:
+	void Sort(ParentSpriteToSortVector *psdv);
+};
+
+/**
+ * Sort parent sprites pointer array replicating the way original sorter did it.
+ * A sprite can only precede another one when its minimal X and Y coordinates
+ * are not beyond the maximal ones of the other, so instead of walking all
+ * sprites with a lower xmin + ymin like the other sorters, only the grid
+ * cells to the north of the sprite are compared. The result is the same.
+ * @param psdv The sprites to sort.
+ */
+void BatchedSpriteSorter::Sort(ParentSpriteToSortVector *psdv)
+{
+	if (psdv->size() < 2) return;
+
+	/* See ViewportSortParentSprites for the meaning of these. */
+	const uint32_t ORDER_COMPARED = UINT32_MAX;
+	const uint32_t ORDER_RETURNED = UINT32_MAX - 1;
+	std::stack<uint32_t> sprite_order; // Indices into the sprites to sort.
+	uint32_t next_order = 0;
+
+	this->sprites = *psdv;
+	this->grid.Fill(this->sprites);
+
+	for (uint32_t i = static_cast<uint32_t>(this->sprites.size()); i-- > 0;) {
+		sprite_order.push(i);
+		this->sprites[i]->order = next_order++;
+	}
+
+	auto out = psdv->begin(); // Iterator to output sorted sprites
+
+	while (!sprite_order.empty()) {
+		uint32_t si = sprite_order.top();
+		sprite_order.pop();
+		ParentSpriteToDraw *s = this->sprites[si];
+
+		/* Sprite is already sorted, ignore it. */
+		if (s->order == ORDER_RETURNED) continue;
+
+		/* Sprite was already compared, just need to output it. */
+		if (s->order == ORDER_COMPARED) {
+			*(out++) = s;
+			s->order = ORDER_RETURNED;
+			continue;
+		}
+
+		this->grid.Remove(si);
+
+		this->preceding.clear();
+		this->grid.FindPreceding(s, this->preceding);
+
+		if (this->preceding.empty()) {
+			/* No preceding sprites, add current one to the output */
+			*(out++) = s;
+			s->order = ORDER_RETURNED;
+			continue;
+		}
+
+		/* Optimization for the case when we only have 1 sprite to move. */
+		if (this->preceding.size() == 1) {
+			ParentSpriteToDraw *p = this->sprites[this->preceding[0]];
+			/* We can only output the preceding sprite if there can't be any other sprites preceding it. */
+			if (p->xmax <= s->xmax && p->ymax <= s->ymax && p->zmax <= s->zmax) {
+				p->order = ORDER_RETURNED;
+				s->order = ORDER_RETURNED;
+				this->grid.Remove(this->preceding[0]);
+				*(out++) = p;
+				*(out++) = s;
+				continue;
+			}
+		}
+
+		/* Sort all preceding sprites by order and assign new orders in reverse (as original sorter did). */
+		std::sort(this->preceding.begin(), this->preceding.end(), [this](uint32_t a, uint32_t b) {
+			return this->sprites[a]->order > this->sprites[b]->order;
+		});
+
+		s->order = ORDER_COMPARED;
+		sprite_order.push(si); // Still need to output so push it back for now
+
+		for (uint32_t pi : this->preceding) {
+			this->sprites[pi]->order = next_order++;
+			sprite_order.push(pi);
+		}
+	}
+}
+
+static BatchedSpriteSorter _batched_sprite_sorter; ///< The sorter used for the viewports.
+
+/**
+ * Sort parent sprites pointer array with the batched sorter.
+ * @param psdv The sprites to sort.
+ */
+void ViewportSortParentSpritesBatched(ParentSpriteToSortVector *psdv)
+{
+	_batched_sprite_sorter.Sort(psdv);
+}
@@ -42,6 +42,8 @@
 
 #include "table/strings.h"
 
+#include <unordered_map>
+
 #include "safeguards.h"
 
 /** Values for _settings_client.gui.auto_scrolling */
@@ -59,6 +61,49 @@ static Window *_last_scroll_window = nullptr; ///< Window of the last scroll eve
 /** List of windows opened at the screen sorted from the front to back. */
 WindowList _z_windows;
 
+/**
+ * Index of the open windows by their class and number, so they can be found without scanning all windows.
+ * The key holds the window class in the upper and the window number in the lower 32 bits.
+ */
+static std::unordered_multimap<uint64_t, Window *> _window_index;
+
+/**
+ * Get the key of a window in #_window_index.
+ * @param cls Window class.
+ * @param number Window number within the class.
+ * @return The key.
+ */
+static inline uint64_t GetWindowIndexKey(WindowClass cls, WindowNumber number)
+{
+	return static_cast<uint64_t>(cls) << 32 | static_cast<uint32_t>(static_cast<int32_t>(number));
+}
+
+/**
+ * Add a window to the window index under its current class and number.
+ * @param w The window to add.
+ */
+static void AddToWindowIndex(Window *w)
+{
+	_window_index.emplace(GetWindowIndexKey(w->window_class, w->window_number), w);
+}
+
+/**
+ * Remove a window from the window index, if it is in there.
+ * @param w The window to remove.
+ * @return Whether the window was in the index.
+ */
+static bool RemoveFromWindowIndex(Window *w)
+{
+	auto [first, last] = _window_index.equal_range(GetWindowIndexKey(w->window_class, w->window_number));
+	for (auto it = first; it != last; ++it) {
+		if (it->second == w) {
+			_window_index.erase(it);
+			return true;
+		}
+	}
+	return false;
+}
+
 /** List of closed windows to delete. */
 /* static */ std::vector<Window *> Window::closed_windows;
 
@@ -1120,6 +1165,7 @@ void Window::Close([[maybe_unused]] int data)
 	if (*this->z_position == nullptr) return;
 
 	*this->z_position = nullptr;
+	RemoveFromWindowIndex(this);
 
 	if (_thd.window_class == this->window_class &&
 			_thd.window_number == this->window_number) {
@@ -1165,11 +1211,16 @@ Window::~Window()
  */
 Window *FindWindowById(WindowClass cls, WindowNumber number)
 {
+	auto [first, last] = _window_index.equal_range(GetWindowIndexKey(cls, number));
+	if (first == last) return nullptr;
+	if (std::next(first) == last) return first->second;
+
+	/* Several windows share the class and number; keep returning the same one a full scan would. */
 	for (Window *w : Window::Iterate()) {
 		if (w->window_class == cls && w->window_number == number) return w;
 	}
 
-	return nullptr;
+	NOT_REACHED();
 }
 
 /**
@@ -1439,6 +1490,7 @@ void Window::InitializeData(WindowNumber window_number)
 	this->owner = INVALID_OWNER;
 	this->nested_focus = nullptr;
 	this->window_number = window_number;
+	AddToWindowIndex(this);
 
 	this->OnInit();
 	/* Initialize smallest size. */
@@ -1839,6 +1891,28 @@ void Window::InitNested(WindowNumber window_number)
 	this->FinishInitNested(window_number);
 }
 
+/**
+ * Change the class of an initialised window, keeping the window index up to date.
+ * @param window_class The new window class.
+ */
+void Window::ChangeWindowClass(WindowClass window_class)
+{
+	bool indexed = RemoveFromWindowIndex(this);
+	this->window_class = window_class;
+	if (indexed) AddToWindowIndex(this);
+}
+
+/**
+ * Change the number of an initialised window, keeping the window index up to date.
+ * @param window_number The new window number.
+ */
+void Window::ChangeWindowNumber(WindowNumber window_number)
+{
+	bool indexed = RemoveFromWindowIndex(this);
+	this->window_number = window_number;
+	if (indexed) AddToWindowIndex(this);
+}
+
 /**
  * Empty constructor, initialization has been moved to #InitNested() called from the constructor of the derived class.
  * @param desc The description of the window.
@@ -1900,6 +1974,7 @@ void UnInitWindowSystem()
 	Window::DeleteClosedWindows();
 
 	assert(_z_windows.empty());
+	assert(_window_index.empty());
 }
 
 /**
@@ -3199,12 +3274,8 @@ void UpdateWindows()
  */
 void SetWindowDirty(WindowClass cls, WindowNumber number)
 {
-	for (const Window *w : Window::Iterate()) {
-		if (w->window_class == cls && w->window_number == number) {
-			w->SetDirty();
-			return;
-		}
-	}
+	const Window *w = FindWindowById(cls, number);
+	if (w != nullptr) w->SetDirty();
 }
 
 /**
@@ -3215,12 +3286,8 @@ void SetWindowDirty(WindowClass cls, WindowNumber number)
  */
 void SetWindowWidgetDirty(WindowClass cls, WindowNumber number, WidgetID widget_index)
 {
-	for (const Window *w : Window::Iterate()) {
-		if (w->window_class == cls && w->window_number == number) {
-			w->SetWidgetDirty(widget_index);
-			return;
-		}
-	}
+	const Window *w = FindWindowById(cls, number);
+	if (w != nullptr) w->SetWidgetDirty(widget_index);
 }
 
 /**
@@ -3321,12 +3388,8 @@ void Window::ProcessHighlightedInvalidations()
  */
 void InvalidateWindowData(WindowClass cls, WindowNumber number, int data, bool gui_scope)
 {
-	for (Window *w : Window::Iterate()) {
-		if (w->window_class == cls && w->window_number == number) {
-			w->InvalidateData(data, gui_scope);
-			return;
-		}
-	}
+	Window *w = FindWindowById(cls, number);
+	if (w != nullptr) w->InvalidateData(data, gui_scope);
 }
 
 /**
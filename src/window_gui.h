@@ -254,6 +254,9 @@ struct ViewportData : Viewport {
 	int32_t scrollpos_y;        ///< Currently shown y coordinate (virtual screen coordinate of topleft corner of the viewport).
 	int32_t dest_scrollpos_x;   ///< Current destination x coordinate to display (virtual screen coordinate of topleft corner of the viewport).
 	int32_t dest_scrollpos_y;   ///< Current destination y coordinate to display (virtual screen coordinate of topleft corner of the viewport).
+	int32_t prefetch_left = 0;  ///< Virtual left coordinate of the viewport when its sprites were last prefetched.
+	int32_t prefetch_top = 0;   ///< Virtual top coordinate of the viewport when its sprites were last prefetched.
+	ZoomLevel prefetch_zoom = ZoomLevel::End; ///< Zoom level of the viewport when its sprites were last prefetched.
 
 	void CancelFollow(const Window &viewport_window);
 };
@@ -299,8 +302,8 @@ public:
 
 	WindowDesc &window_desc; ///< Window description
 	WindowFlags flags{}; ///< Window flags
-	WindowClass window_class{}; ///< Window class
-	WindowNumber window_number = 0; ///< Window number within the window class
+	WindowClass window_class{}; ///< Window class, only change it via #ChangeWindowClass once the window is initialised.
+	WindowNumber window_number = 0; ///< Window number within the window class, only change it via #ChangeWindowNumber once the window is initialised.
 
 	int scale = 0; ///< Scale of this window -- used to determine how to resize.
 
@@ -350,6 +353,9 @@ public:
 	void CreateNestedTree();
 	void FinishInitNested(WindowNumber window_number = 0);
 
+	void ChangeWindowClass(WindowClass window_class);
+	void ChangeWindowNumber(WindowNumber window_number);
+
 	/**
 	 * Set the timeout flag of the window and initiate the timer.
 	 */